@@ -1,26 +1,31 @@
 /********************************************************************************
-* AlarmWave - Module containing the initialization routine for PIT channel 1
-* 			  and an associated DMA channel to send sample outputs to DAC0
-* 			  on a PIT trigger.  Also contains a control task that turns on and
-* 			  off the PIT timer based on the state of L5mSysState.  This effectively
-* 			  turns on and off the alarm sound output from DAC0
+* AlarmWave - Module containing the initialization routine for a PIT channel
+* 			  and an associated DMA channel, both taken from ResAlloc, to send sample outputs to DAC0
+* 			  on a PIT trigger.  The alarm cadence, 1 s of tone then 1 s of
+* 			  1.65 V. idle, is a loop of two scatter-gather TCDs in RAM, so once
+* 			  AlarmWaveStart() is called the eDMA plays the whole pattern without
+* 			  the CPU.  AlarmWaveStop() ends it.  The tone tables are rendered at
+* 			  init from ALARM_TONE_T parameters, one per alarm type, and the alarm
+* 			  type passed to AlarmWaveStart() selects the table.
 *
 * Sam Condon, 11/11/2019 - basic function sends 64 samples stored in dac_buf[] through dac at 19200 sps
 * Sam Condon, 11/23/2019 - added DMA functionality
+* fixed 64 sample dac_buf[] replaced by tone tables rendered from parameters
 ***********************************************************************************/
 
 //INCLUDE DEPENDENCIES////////
 #include "MCUType.h"
 #include "MK65F18.h"
 #include "K65TWR_GPIO.h"
+#include "Lab5Main.h"
+#include "ResAlloc.h"
 #include "AlarmWave.h"
 #include "SysTickDelay.h"
 #include "BasicIO.h"
-#include "Lab5Main.h"
 //////////////////////////////
 
 //DEFINES AND MACROS////////////////////////////////////////////////////////////////////
-#define LD_VAL0 3119U;
+#define ALARM_PIT_PERIOD 3120u // bus clocks per sample, 19231 sps
 #define TMR_ENABLE 0x00000001
 #define TMR_DISABLE ~TMR_ENABLE
 
@@ -33,29 +38,89 @@
 #define DAC0_SHIFT6 31U
 #define DAC0_EN6 (1U<<(DAC0_SHIFT6))
 
-#define DMA_DAC0_CH 0u
+#define DMA_DAC0_CH (alarmDma.dmach)
+#define ALARM_PIT (alarmDma.pit)
 #define TCD_ATTR_SSIZE_SHIFT 24u
 #define SIZE_CODE_16BIT 001u
 #define DMA_BYTES_PER_SAMP 2u
-#define BYTES_PER_BLOCK 128u
-#define ALARM_SAMPS_PER_BLOCK 64u
+
+#define ALARM_TBL_SAMPS 1024u // samples per tone table, 53 ms at ALARM_SAMP_FREQ
+#define ALARM_TBL_BYTES (ALARM_TBL_SAMPS*DMA_BYTES_PER_SAMP) // table alignment for the source modulo
+#define ALARM_SMOD_TBL 11u // 2^11 bytes, source modulo wraps the tone over one table
+#define ALARM_TBL_SHIFT 22u // 32 - log2(ALARM_TBL_SAMPS), table index to q32 phase
+#define ALARM_TOUCH_TBL 0u
+#define ALARM_TEMP_TBL 1u
+#define ALARM_NUM_TBLS 2u
+#define ALARM_SAMP_FREQ 19231u // 60MHz/ALARM_PIT_PERIOD
+#define ALARM_DAC_MID 2048u // 1.65 V.
+#define ALARM_AMPL 2000u // peak deviation from ALARM_DAC_MID in DAC counts
+#define ALARM_Q15_ONE 32768 // 1.0 in q15
+#define ALARM_WARBLE_FULL 100u // warble depth is in percent of the base frequency
+#define ALARM_CADENCE_SAMPS 19231u // samples in 1 s at ALARM_SAMP_FREQ, tone and silence length
+#define ALARM_TCD_ALIGN 32u // scatter-gather TCDs must be 32 byte aligned
+#define ALARM_TONE_TCD 0u
+#define ALARM_SILENCE_TCD 1u
 ////////////////////////////////////////////////////////////////////////////////////////
 
+//PRIVATE TYPES////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * ALARM_TONE_T - tone table parameters.  basefreq is
+ * 				  rounded to a whole number of cycles per
+ * 				  table (ALARM_SAMP_FREQ/ALARM_TBL_SAMPS steps).
+ * 				  Harmonic h has amplitude 1/h.  The warble
+ * 				  sweeps the pitch by +/-warble percent once
+ * 				  per table.
+ *****************************************************/
+typedef struct{
+	INT16U basefreq;
+	INT8U harmonics;
+	INT8U warble;
+}ALARM_TONE_T;
+
+/*****************************************************
+ * ALARM_TCD_T - eDMA transfer control descriptor as laid
+ * 				 out in the TCD registers, loaded by the
+ * 				 engine itself on a scatter-gather.
+ *****************************************************/
+typedef struct{
+	INT32U saddr;
+	INT16S soff;
+	INT16U attr;
+	INT32U nbytes;
+	INT32S slast;
+	INT32U daddr;
+	INT16S doff;
+	INT16U citer;
+	INT32U dlastsga;
+	INT16U csr;
+	INT16U biter;
+}ALARM_TCD_T;
+///////////////////////////////////////////////////////////////////////////////////////
+
 //PRIVATE PROTOTYPES///////////////////////////////////////////////////////////////////
 static void EnableTimer(INT8U channel);
 static void DisableTimer(INT8U channel);
 static void DacIdle(void);
+static void AlarmTcdInit(ALARM_TCD_T *tcd, const INT16U *src, INT16S soff, INT8U smod, const ALARM_TCD_T *next);
+static void AlarmToneRender(INT16U *tbl, const ALARM_TONE_T *tone);
+static INT32S AlarmSine(INT32U phase);
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-//DAC WRITE VALUES////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-static const INT16U dac_buf[] = {2048u,2784u,3416u,3859u,4064u,4022u,3769u,3373u,2922u,2501u,2182u,2006u,
-								 1979u,2074u,2242u,2423u,2560u,2615u,2575u,2279u,2100u,1960u,1888u,1898u,
-								 1977u,2099u,2224u,2315u,2344u,2300u,2192u,2048u,1903u,1795u,1751u,1780u,
-								 1871u,1996u,2118u,2197u,2207u,2135u,1995u,1816u,1644u,1521u,1480u,1536u,1672u,
-								 1853u,2021u,2116u,2089u,1913u,1594u,1173u,722u,326u,73u,32u,236u,680u,1312u,2048u,
-								};
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//TONE PARAMETERS AND TABLES//////////////////////////////////////////////////////////
+static const ALARM_TONE_T alarmTones[ALARM_NUM_TBLS] = {
+	{1200u, 3u, 15u}, //TOUCH: bright, fast warble
+	{600u, 1u, 5u}, //TEMP: low pure tone, slight warble
+};
+static INT16U alarmToneTbl[ALARM_NUM_TBLS][ALARM_TBL_SAMPS] __attribute__((aligned(ALARM_TBL_BYTES)));
+static const INT16U alarmIdle = ALARM_DAC_MID;
+///////////////////////////////////////////////////////////////////////////////////////
+
+static RES_PERIODIC_T alarmDma; //PIT and DMA channel from ResAlloc
+static const INT8C alarmOwnerStrg[] = "AlarmWave";
+
+//ALARM CADENCE: tone -> silence -> tone ...//
+static ALARM_TCD_T alarmTcd[2] __attribute__((aligned(ALARM_TCD_ALIGN)));
 
 /*****************************************************************************
  * AlamWaveInit() - Initialize PIT timer, NVIC and DAC to send sin wave to speaker.
@@ -64,12 +129,12 @@ static const INT16U dac_buf[] = {2048u,2784u,3416u,3859u,4064u,4022u,3769u,3373u
  *
  ******************************************************************************/
 void AlarmWaveInit(void){
-	////INITIALIZE PIT TIMER////////////
-	SIM->SCGC6 |= SIM_SCGC6_PIT(1);
-	PIT->MCR = PIT->MCR & ~(0x2U);
-	PIT->CHANNEL[0].LDVAL = LD_VAL0;
-	PIT->CHANNEL[0].TCTRL |= 2U;
-	/////////////////////////////////////
+	////ALLOCATE PIT TIMER AND DMA CHANNEL, PIT LOADED BUT STOPPED////
+	if(ResPeriodicAlloc(ALARM_PIT_PERIOD, FALSE, alarmOwnerStrg, &alarmDma) == FALSE){
+		ResFail(alarmOwnerStrg);
+	}
+	else{}
+	//////////////////////////////////////////////////////////////////
 
 	////INITIALIZE DAC///////////////////
 	SIM->SCGC2 |= DAC_EN2(0);
@@ -79,78 +144,132 @@ void AlarmWaveInit(void){
 	//////////////////////////////////////
 
 	//INITIALIZE DMA////////////////////////////////////////////////////////////////////////////////////
-	SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
-	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
-	DMAMUX->CHCFG[DMA_DAC0_CH] |= (DMAMUX_CHCFG_ENBL(0) | DMAMUX_CHCFG_TRIG(0));
-
-	//configure dma source//
-	DMA0->TCD[DMA_DAC0_CH].SADDR = DMA_SADDR_SADDR(dac_buf);
-	DMA0->TCD[DMA_DAC0_CH].ATTR |= (1u) << TCD_ATTR_SSIZE_SHIFT;
-
-	DMA0->TCD[DMA_DAC0_CH].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT)
-								  | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT);
-	DMA0->TCD[DMA_DAC0_CH].SOFF = DMA_SOFF_SOFF(DMA_BYTES_PER_SAMP);
-	DMA0->TCD[DMA_DAC0_CH].SLAST = DMA_SLAST_SLAST(-(BYTES_PER_BLOCK));
-	/////////////////////////
-
-	//configure dma destination//
-	DMA0->TCD[DMA_DAC0_CH].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL);
-	DMA0->TCD[DMA_DAC0_CH].DOFF = DMA_DOFF_DOFF(0u);
-	/////////////////////////////
-
-	//enable DMAMUX and DMA//
-	DMAMUX->CHCFG[DMA_DAC0_CH] = DMAMUX_CHCFG_ENBL(1) | DMAMUX_CHCFG_TRIG(1) | DMAMUX_CHCFG_SOURCE(60);
-	DMA0->SERQ = DMA_SERQ_SERQ(DMA_DAC0_CH);
-	////////////////////////
+	AlarmToneRender(alarmToneTbl[ALARM_TOUCH_TBL], &alarmTones[ALARM_TOUCH_TBL]);
+	AlarmToneRender(alarmToneTbl[ALARM_TEMP_TBL], &alarmTones[ALARM_TEMP_TBL]);
 
-	//set minor loops//
-	DMA0->TCD[DMA_DAC0_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(DMA_BYTES_PER_SAMP);
-	DMA0->TCD[DMA_DAC0_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(ALARM_SAMPS_PER_BLOCK);
-	DMA0->TCD[DMA_DAC0_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(ALARM_SAMPS_PER_BLOCK);
-	///////////////////
+	//tone: a tone table repeated for 1 s, silence: 1.65 V. held for 1 s//
+	AlarmTcdInit(&alarmTcd[ALARM_TONE_TCD], alarmToneTbl[ALARM_TOUCH_TBL], DMA_BYTES_PER_SAMP, ALARM_SMOD_TBL, &alarmTcd[ALARM_SILENCE_TCD]);
+	AlarmTcdInit(&alarmTcd[ALARM_SILENCE_TCD], &alarmIdle, 0, 0u, &alarmTcd[ALARM_TONE_TCD]);
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+}
 
-	//set offset after major loop to 0
-	DMA0->TCD[DMA_DAC0_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+/*********************************************************************************
+ * AlarmWaveStart() - Point the tone TCD at the table for alarm, load it into the
+ * 					  DAC0 DMA channel and start the PIT.  From here the cadence
+ * 					  runs from the TCD loop alone.
+ *
+ ********************************************************************************/
+void AlarmWaveStart(ALARM_FLAGS_T alarm){
+	ALARM_TCD_T *tone = &alarmTcd[ALARM_TONE_TCD];
+
+	DisableTimer(ALARM_PIT);
+	tone->saddr = DMA_SADDR_SADDR(alarmToneTbl[(alarm == TEMP) ? ALARM_TEMP_TBL : ALARM_TOUCH_TBL]);
+	DMA0->CERQ = DMA_CERQ_CERQ(DMA_DAC0_CH);
+	DMA0->TCD[DMA_DAC0_CH].CSR = 0u; // clear ESG/DONE before reloading
+	DMA0->TCD[DMA_DAC0_CH].SADDR = tone->saddr;
+	DMA0->TCD[DMA_DAC0_CH].SOFF = tone->soff;
+	DMA0->TCD[DMA_DAC0_CH].ATTR = tone->attr;
+	DMA0->TCD[DMA_DAC0_CH].NBYTES_MLNO = tone->nbytes;
+	DMA0->TCD[DMA_DAC0_CH].SLAST = tone->slast;
+	DMA0->TCD[DMA_DAC0_CH].DADDR = tone->daddr;
+	DMA0->TCD[DMA_DAC0_CH].DOFF = tone->doff;
+	DMA0->TCD[DMA_DAC0_CH].CITER_ELINKNO = tone->citer;
+	DMA0->TCD[DMA_DAC0_CH].BITER_ELINKNO = tone->biter;
+	DMA0->TCD[DMA_DAC0_CH].DLAST_SGA = tone->dlastsga;
+	DMA0->TCD[DMA_DAC0_CH].CSR = tone->csr;
+	DMA0->SERQ = DMA_SERQ_SERQ(DMA_DAC0_CH);
+	EnableTimer(ALARM_PIT);
+}
 
-	//finish DMA TCD structure initialization//
-	DMA0->TCD[DMA_DAC0_CH].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) |
-								 DMA_CSR_BWC(3) | DMA_CSR_INTHALF(0) |
-							     DMA_CSR_INTMAJOR(0) | DMA_CSR_DREQ(0) |
-								 DMA_CSR_START(0);
+/*********************************************************************************
+ * AlarmWaveStop() - Stop the PIT and DMA and return DAC0 to 1.65 V.
+ *
+ ********************************************************************************/
+void AlarmWaveStop(void){
+	DMA0->CERQ = DMA_CERQ_CERQ(DMA_DAC0_CH);
+	DisableTimer(ALARM_PIT);
+}
 
-	//////////////////////////////////////////////////////////////////////////////////////////////////////
+/*********************************************************************************
+ * AlarmTcdInit() - Fill one 16 bit sample to DAC0 TCD of the cadence loop.
+ * 					Each TCD plays ALARM_CADENCE_SAMPS samples then
+ * 					scatter-gathers to next.
+ *
+ ********************************************************************************/
+static void AlarmTcdInit(ALARM_TCD_T *tcd, const INT16U *src, INT16S soff, INT8U smod, const ALARM_TCD_T *next){
+	tcd->saddr = DMA_SADDR_SADDR(src);
+	tcd->soff = soff;
+	tcd->attr = DMA_ATTR_SMOD(smod) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT)
+				| DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT);
+	tcd->nbytes = DMA_NBYTES_MLNO_NBYTES(DMA_BYTES_PER_SAMP);
+	tcd->slast = 0;
+	tcd->daddr = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL);
+	tcd->doff = 0;
+	tcd->citer = DMA_CITER_ELINKNO_CITER(ALARM_CADENCE_SAMPS);
+	tcd->biter = DMA_BITER_ELINKNO_BITER(ALARM_CADENCE_SAMPS);
+	tcd->dlastsga = DMA_DLAST_SGA_DLASTSGA(next);
+	tcd->csr = DMA_CSR_ESG(1) | DMA_CSR_BWC(3);
 }
 
 /*********************************************************************************
- * AlarmWaveControlTask() - Enable/disable PIT timer based on AlarmState value.
+ * AlarmToneRender() - Render one tone table from its parameters.  The pitch is
+ * 					   a whole number of cycles per table and the warble is a
+ * 					   whole sine period, so the table loops without a click.
  *
  ********************************************************************************/
-void AlarmWaveControlTask(void){
-
-	static INT32U tscount = 0; //time-slice counter
-
-	tscount++;
-
-	if(tscount >= 5U){
-		DB5_TURN_ON();
-		tscount = 0;
-		if(L5mPrevSysState != L5mSysState){
-			switch(L5mSysState)
-					{
-					case(ALARM):
-						EnableTimer(0u);
-					break;
-
-					default:
-						DisableTimer(0u);
-					break;
-					}
-			}
-		DB5_TURN_OFF();
+static void AlarmToneRender(INT16U *tbl, const ALARM_TONE_T *tone){
+	INT32U cycles; //base frequency cycles per table
+	INT32U stepbase; //q32 phase step at the base frequency
+	INT32U phase = 0u;
+	INT32S step;
+	INT32S norm = 0; //sum of the harmonic amplitudes, q15
+	INT32S acc;
+	INT16U n;
+	INT8U h;
+
+	cycles = (((INT32U)tone->basefreq*ALARM_TBL_SAMPS) + (ALARM_SAMP_FREQ/2u))/ALARM_SAMP_FREQ;
+	if(cycles == 0u){
+		cycles = 1u;
 	}
-
 	else{}
+	stepbase = cycles << ALARM_TBL_SHIFT;
+	for(h = 1u; h <= tone->harmonics; h++){
+		norm += ALARM_Q15_ONE/h;
+	}
+
+	for(n = 0u; n < ALARM_TBL_SAMPS; n++){
+		acc = 0;
+		for(h = 1u; h <= tone->harmonics; h++){
+			acc += AlarmSine(phase*h)/h;
+		}
+		tbl[n] = (INT16U)((INT32S)ALARM_DAC_MID + ((acc*(INT32S)ALARM_AMPL)/norm));
+
+		//warble: step = stepbase*(1 + warble*sin(2*pi*n/ALARM_TBL_SAMPS))//
+		step = (INT32S)(((INT64S)stepbase*tone->warble*AlarmSine((INT32U)n << ALARM_TBL_SHIFT))
+				/((INT64S)ALARM_WARBLE_FULL*ALARM_Q15_ONE));
+		phase += stepbase + (INT32U)step;
+	}
+}
 
+/*********************************************************************************
+ * AlarmSine() - Integer sine for table rendering, Bhaskara's approximation
+ * 				 16p(1-p)/(5-4p(1-p)) over each half period.  Phase is a q32
+ * 				 fraction of a period, the result is q15 within 0.2%.
+ *
+ ********************************************************************************/
+static INT32S AlarmSine(INT32U phase){
+	INT32S p; //q15 fraction of the half period
+	INT32S t; //p(1-p), q15
+	INT32S val;
+
+	p = (INT32S)((phase >> 16) & 0x7fffu);
+	t = (p*(ALARM_Q15_ONE - p)) >> 15;
+	val = (INT32S)(((INT64S)16*t*ALARM_Q15_ONE)/((5*ALARM_Q15_ONE) - (4*t)));
+	if(val >= ALARM_Q15_ONE){
+		val = ALARM_Q15_ONE - 1;
+	}
+	else{}
+	return (phase & 0x80000000u) ? -val : val;
 }
 
 /***************************************************
@@ -176,8 +295,8 @@ static void DisableTimer(INT8U channel){
  *
  *****************************************************/
 static void DacIdle(void){
-	DAC0->DAT[0].DATH = (dac_buf[0]>>8);
-	DAC0->DAT[0].DATL = (INT8U)(dac_buf[0]);
+	DAC0->DAT[0].DATH = (alarmIdle>>8);
+	DAC0->DAT[0].DATL = (INT8U)(alarmIdle);
 }
 
 
@@ -14,9 +14,15 @@
 void AlarmWaveInit(void);
 
 /**************************************
- * Run AlarmWave task
+ * Start the alarm cadence, runs on DMA.
+ * alarm (TOUCH or TEMP) selects the tone.
  ************************************/
-void AlarmWaveControlTask(void);
+void AlarmWaveStart(ALARM_FLAGS_T alarm);
+
+/**************************************
+ * Stop the alarm, DAC0 back to 1.65 V.
+ ************************************/
+void AlarmWaveStop(void);
 
 #endif
 
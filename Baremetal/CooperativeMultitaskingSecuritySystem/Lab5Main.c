@@ -1,17 +1,23 @@
 /********************************************************
  * Cooperative Multitasking Security System
  *
- * 		-This program runs a cooperative multitasking, time-slice scheduled,
+ * 		-This program runs a cooperative multitasking, event driven,
  * 		 security system equipped with touch intrusion detection and envionment
  * 		 monitoring.  In the case of a touch intrusion, or the environment
  * 		 reaches above 40 degrees C, or below 0 degrees C, an alarm will sound
  * 		 and LED's will flash corresponding to any touch intrusions.
  *
+ * 		-Alarms, key presses and due time slices are posted as events and the
+ * 		 handler of each runs to completion, highest priority first, from
+ * 		 EvtRun(), which sleeps when none is pending.  An alarm from an
+ * 		 interrupt reaches ControlDisplayTask() without waiting for its slice.
+ *
  *
  * Sam Condon 12/2/2019
  *********************************************************/
 
 #include "MCUType.h"
+#include "MK65F18.h"
 #include "Lab5Main.h"
 #include "CheckSum.h"
 #include "K65TWR_ClkCfg.h"
@@ -21,8 +27,14 @@
 #include "LCD.h"
 #include "AlarmWave.h"
 #include "SysTickDelay.h"
+#include "TSIFilter.h"
 #include "Sense.h"
 #include "Temp.h"
+#include "TempLog.h"
+#include "ResAlloc.h"
+#include "Sched.h"
+#include "SchedStat.h"
+#include "Evt.h"
 
 //DEFINE CHECKSUM MEMORY RANGE TO TEST//
 #define CS_LOW (INT8U*)0x00000000
@@ -34,8 +46,15 @@
 #define FAHRENHEIT 1u
 //////////////////////////////////////
 
+//TASK TABLE SIZE//////////////////////
+#define L5M_NUM_TASKS 8u
+#define L5M_LED_SLICES 5u //LEDTask period
+//////////////////////////////////////
+
 //PROTOTYPES/////////////////////////////
 static void ControlDisplayTask(void);
+static void L5mKeyTask(void);
+static void L5mSlicePost(void);
 static void LEDTask(void);
 static void AlarmDisplay(ALARM_FLAGS_T alarmflags);
 static void TempDisplay(void);
@@ -62,6 +81,30 @@ TSI SSenseState;
 TEMP_COM_T TTempCom;
 ///////////////////////////////////////
 
+static INT8C l5mKey = 0; //key taken by L5mKeyTask for ControlDisplayTask
+static INT32U l5mSysTickCtrl; //SysTick->CTRL as SysTickDlyInit() left it
+
+//TASK TABLE, PERIOD AND PHASE IN 10 mS. SLICES, BUDGET IN CYCLES///////////////////
+static const SCHED_TASK_T l5mTasks[L5M_NUM_TASKS] = {
+	{L5mKeyTask, 1u, 0u, SCHED_US(100u)}, //check for key press, posts L5M_EV_KEY
+	{ControlDisplayTask, 5u, 0u, SCHED_US(3000u)}, //LCD refresh, LCD writes are slow
+	{LEDTask, L5M_LED_SLICES, 2u, SCHED_US(100u)}, //update led's on a 250/500/100 mS. grid
+	{SensorTask, 1u, 0u, SCHED_US(200u)}, //previous electrode state, the TSI interrupt filters and alarms
+	{SenseRebaseTask, 64u, 63u, SCHED_US(100u)}, //baseline refresh pass every 640 mS.
+	{TempWinTask, 200u, 199u, SCHED_US(100u)}, //display window every 2 S., in a TempTask slice
+	{TempTask, 5u, 4u, SCHED_US(500u)}, //filter and convert the DMA'd adc samples
+	{TempLogTask, 1u, 0u, SCHED_US(200u)} //log a reading a minute, queue a query or dump line
+};
+/////////////////////////////////////////////////////////////////////////////////////
+
+//EVENT HANDLERS, INDEXED BY L5M_EVENTS_T/////////////////////////////////////////////
+static const EVT_HANDLER_T l5mHandlers[L5M_NUM_EVENTS] = {
+	ControlDisplayTask, //L5M_EV_ALARM, start the siren
+	ControlDisplayTask, //L5M_EV_KEY, act on the key
+	SchedRunSlice //L5M_EV_SLICE, the table tasks due this slice
+};
+//////////////////////////////////////////////////////////////////////////////////////
+
 void main(void){
 
 	//LOCAL MAIN VARIABLE DEFS/DECS//
@@ -76,11 +119,14 @@ void main(void){
 	GpioLED8Init();
 	GpioLED9Init();
 	(void)SysTickDlyInit();
+	l5mSysTickCtrl = SysTick->CTRL;
 	KeyInit();
 	LcdInit();
 	AlarmWaveInit();
 	TSIInit(&SSenseState);
 	TempInit();
+	TempLogInit();
+	ResReport(); //PIT/DMA assignments to the terminal
 	////////////////////////////
 
 	//DISPLAY CHECKSUM ON LCD////////////////
@@ -95,119 +141,152 @@ void main(void){
 	TTempCom.unit = CELCIUS;
 	////////////////////////////////////////////////
 
-	//TIME-SLICE SCHEDULER/////////////////////////////////////////////////////////////////
+	//EVENT DISPATCHER/////////////////////////////////////////////////////////////////////
+	(void)SchedInit(l5mTasks, L5M_NUM_TASKS); //periods and phases are all in l5mTasks
+	(void)EvtInit(l5mHandlers, L5M_NUM_EVENTS);
 	LED8_TURN_ON(); //set initial led state
-	while(1){
-		SysTickWaitEvent(10U);  //time slice set to 10 ms for now.  MAY CHANGE LATER
-		KeyTask(); //check for key press
-		ControlDisplayTask(); //update system state and write any neccesary values to the LCD
-		AlarmWaveControlTask(); //send alarm wave over DAC0 when in the ALARM state
-		LEDTask(); //update led's
-		SensorTask(); //update TSI structure
-		TempTask(); //sample temperature from adc and convert to fahrenheit or celcius
-	}
+	SysTick->CTRL = 0u; //run only inside the LCD and Key driver tasks, don't let it wake EvtRun() every mS.
+	SchedStart(L5mSlicePost); //10 mS. slices from LPTMR0, each posted as L5M_EV_SLICE
+	EvtRun(); //run handlers to completion, sleep when none is pending
 	//////////////////////////////////////////////////////////////////////////////////////
 }
 
 /*************************************************************************************************
  * ControlDisplayTask() - This task updates the system state variable L5mSysState and writes any
  * 						  necessary values to the LCD display.  Sets the stage for proper action
- * 						  to be taken after any key press.
+ * 						  to be taken after any key press.  Runs for L5M_EV_ALARM and
+ * 						  L5M_EV_KEY as they are posted as well as every 50 mS. to refresh
+ * 						  the temperature.
  *
  **************************************************************************************************/
 static void ControlDisplayTask(void){
 
-	static INT32U cdtcount = 0U; //time slice counter
 	static INT8U statechange = 1U; //indicates a change of L5mSysState
 
 	static ALARM_FLAGS_T alarmdisplay = NONE; //flags the type of alarm that was triggered
 
-	cdtcount++;
-
 //////SYSTEM STATE MACHINE///////////////////////////////////////////
 	static INT8C key;
 
-	if(cdtcount >= 5){ //run only every 50 ms.
-		DB2_TURN_ON();
-		L5mPrevSysState = L5mSysState;
-		cdtcount = 0;
-		key = KeyGet();
+	DB2_TURN_ON();
+	SysTick->CTRL = l5mSysTickCtrl; //the LCD driver may delay on SysTick
+	key = l5mKey;
+	l5mKey = 0;
 
-		if(key == DC2){ //if key == B
-			TTempCom.unit = !TTempCom.unit;
-		}
-		else{}
+	if(key == DC2){ //if key == B
+		TTempCom.unit = !TTempCom.unit;
+		TempDispUpdate(); //the last reading in the new unit
+	}
+	else if(key == DC3){ //if key == C, print the temperature log
+		TempLogDumpStart();
+	}
+	else if(key == '#'){ //print the task timing statistics
+		SchedStatDumpStart();
+	}
+	else if(((key >= '0') && (key <= '9')) || (key == '*')){ //temperature log query, <oldest>*<newest>*
+		TempLogKey(key);
+	}
+	else{}
 
-		switch(L5mSysState)
-		{
-			case(ARMED):
-				if(statechange == 1U){
-					LcdClrLine(1U);
-					LcdMoveCursor(1U,1U);
-					LcdDispStrg(ArmedStrg);
-					statechange = 0U;
-					L5mAlarmFlags = NONE;
-				}
-				else{}
+	switch(L5mSysState)
+	{
+		case(ARMED):
+			if(statechange == 1U){
+				LcdClrLine(1U);
+				LcdMoveCursor(1U,1U);
+				LcdDispStrg(ArmedStrg);
+				statechange = 0U;
+				L5mAlarmFlags = NONE;
+			}
+			else{}
 
-				if(L5mAlarmFlags != NONE){
-					alarmdisplay = L5mAlarmFlags;
-					statechange = 1U;
-					L5mSysState = ALARM;
-				}
-				else if(key == DC4){ //if key == D
-					statechange = 1U;
-					L5mSysState = DISARMED;
-				}
-				else{}
+			if(L5mAlarmFlags != NONE){
+				alarmdisplay = L5mAlarmFlags;
+				statechange = 1U;
+				L5mSysState = ALARM;
+				AlarmWaveStart(L5mAlarmFlags); //alarm cadence runs on DMA from here
+			}
+			else if(key == DC4){ //if key == D
+				statechange = 1U;
+				L5mSysState = DISARMED;
+			}
+			else{}
 
 
 
-			break;
+		break;
 
-			case(DISARMED):
-				if(statechange == 1U){
-					LcdClrLine(1U);
-					LcdMoveCursor(1U,1U);
-					LcdDispStrg(DisarmedStrg);
-					statechange = 0U;
-				}
-				else{}
+		case(DISARMED):
+			if(statechange == 1U){
+				LcdClrLine(1U);
+				LcdMoveCursor(1U,1U);
+				LcdDispStrg(DisarmedStrg);
+				statechange = 0U;
+			}
+			else{}
 
-				if(key == DC1){ //if key == A
-					statechange = 1U;
-					L5mSysState = ARMED;
-				}
-				else{}
+			if(key == DC1){ //if key == A
+				statechange = 1U;
+				L5mSysState = ARMED;
+			}
+			else{}
 
-			break;
+		break;
 
-			case(ALARM):
-				if(statechange == 1U){
-					AlarmDisplay(alarmdisplay);
-					statechange = 0U;
-				}
-				else{}
+		case(ALARM):
+			if(statechange == 1U){
+				AlarmDisplay(alarmdisplay);
+				statechange = 0U;
+			}
+			else{}
 
-				if(key == DC4){ //if key == D
-					statechange = 1U;
-					L5mSysState = DISARMED;
-				}
-				else{}
+			if(key == DC4){ //if key == D
+				statechange = 1U;
+				L5mSysState = DISARMED;
+				AlarmWaveStop();
+			}
+			else{}
 
-			break;
+		break;
 
-			default:
-			break;
-		}
+		default:
+		break;
+	}
+
+	TempDisplay();
 
-		TempDisplay();
+	SysTick->CTRL = 0u;
+	DB2_TURN_OFF();
+/////////////////////////////////////////////////////////////////////////
+
+}
 
-		DB2_TURN_OFF();
+/*************************************************************************************************
+ * L5mKeyTask() - Scan the keypad and post any key to ControlDisplayTask() as L5M_EV_KEY.
+ * 				  SysTick runs only while the Key and LCD drivers are called, here and in
+ * 				  ControlDisplayTask(), the only code outside the init that could delay on it.
+ *
+ **************************************************************************************************/
+static void L5mKeyTask(void){
+	INT8C key;
+
+	SysTick->CTRL = l5mSysTickCtrl; //the Key driver may delay on SysTick
+	KeyTask();
+	key = KeyGet();
+	SysTick->CTRL = 0u;
+	if(key != 0){
+		l5mKey = key;
+		EvtPost(L5M_EV_KEY);
 	}
 	else{}
-/////////////////////////////////////////////////////////////////////////
+}
 
+/*************************************************************************************************
+ * L5mSlicePost() - Called from the slice timer interrupt for each slice with a task due.
+ *
+ **************************************************************************************************/
+static void L5mSlicePost(void){
+	EvtPost(L5M_EV_SLICE);
 }
 
 /*************************************************************************************************
@@ -257,28 +336,31 @@ static void TempDisplay(void){
 	static INT8U prevunit = 255;
 	static INT8U prevtempdispval = 255;
 
-	if(prevunit != TTempCom.unit){ //if b key is pressed, changing units, rewrite unit on lcd
-		LcdMoveCursor(2u, 15u);
-		LcdDispChar(Degree);
-		LcdMoveCursor(2u, 16u);
-		if(TTempCom.unit==CELCIUS){
-			LcdDispChar(Celcius);
+	if(TTempCom.ready == TRUE){ //nothing to show before the first reading
+		if(prevunit != TTempCom.unit){ //if b key is pressed, changing units, rewrite unit on lcd
+			LcdMoveCursor(2u, 15u);
+			LcdDispChar(Degree);
+			LcdMoveCursor(2u, 16u);
+			if(TTempCom.unit==CELCIUS){
+				LcdDispChar(Celcius);
+			}
+			else{
+				LcdDispChar(Fahrenheit);
+			}
 		}
-		else{
-			LcdDispChar(Fahrenheit);
+		else{}
+
+		if((prevtempdispval != TTempCom.tempdispval) || (prevunit != TTempCom.unit)){ //if temperature display value or unit has changed, rewrite temperature on lcd
+			TempOut();
 		}
-	}
-	else{}
+		else{}
 
-	if(prevtempdispval != TTempCom.tempdispval){ //if temperature display value has changed, rewrite temperature on lcd
-		TempOut();
+		//update previous value placeholders
+		prevunit = TTempCom.unit;
+		prevtempdispval = TTempCom.tempdispval;
 	}
 	else{}
 
-	//update previous value placeholders
-	prevunit = TTempCom.unit;
-	prevtempdispval = TTempCom.tempdispval;
-
 }
 
 /***********************************************************************************
@@ -329,124 +411,117 @@ static void TempOut(void){
  ***********************************************************************************************/
 static void LEDTask(void){
 
-	static INT32U ledcount = 0U;
+	INT32U ledrun = SchedSliceGet()/L5M_LED_SLICES; //runs since SchedStart(), 50 mS. each
 	static INT8U ledstates[] = {0,1};
 
 	static INT8U alarmleddisp = 0U;
 
-	ledcount++;
-
 //LED TASK STATE TEST////////////////////////////////////////////////////////////////
-	if(ledcount >= 5U){
-		DB4_TURN_ON();
-		switch(L5mSysState)
-			{
-
-			case(ARMED):
-				if((ledcount >= 25U) || (L5mPrevSysState != L5mSysState)){ //if in armed state, toggle led's every 250 mS.
-					ledcount = 0;
-					if(ledstates[0] != ledstates[1]){
-						if(ledstates[0] == 0U){
-							ledstates[0] = 1U;
-						}
-						else{
-							ledstates[0] = 0U;
-						}
-						if(ledstates[1] == 0U){
-							ledstates[1] = 1U;
-						}
-						else{
-							ledstates[1] = 0U;
-						}
-					}
-					else{
-						ledstates[0] = 1;
-						ledstates[1] = 0;
-					}
-
-				}
-				else{}
-			break;
+	DB4_TURN_ON();
+	switch(L5mSysState)
+		{
 
-			case(DISARMED):
-				if((ledcount >= 50U) || (L5mPrevSysState != L5mSysState)){ //if in disarmed state, toggle led state every 500 mS.
-					ledcount = 0U;
-					if(SSenseState.electrodeState == 3U){
-						ledstates[0] = !ledstates[0];
-						ledstates[1] = ledstates[0];
+		case(ARMED):
+			if(((ledrun % 5U) == 0U) || (L5mPrevSysState != L5mSysState)){ //if in armed state, toggle led's every 250 mS.
+				if(ledstates[0] != ledstates[1]){
+					if(ledstates[0] == 0U){
+						ledstates[0] = 1U;
 					}
-					else if(SSenseState.electrodeState == 2U){
+					else{
 						ledstates[0] = 0U;
-						ledstates[1] = !ledstates[1];
 					}
-					else if(SSenseState.electrodeState == 1U){
-						ledstates[1] = 0U;
-						ledstates[0] = !ledstates[0];
+					if(ledstates[1] == 0U){
+						ledstates[1] = 1U;
 					}
 					else{
-						ledstates[0] = 0U;
 						ledstates[1] = 0U;
 					}
 				}
-				else{}
-			break;
+				else{
+					ledstates[0] = 1;
+					ledstates[1] = 0;
+				}
+
+			}
+			else{}
+		break;
 
-			case(ALARM):
-				if(L5mPrevSysState != ALARM){
-					alarmleddisp = SSenseState.electrodeState;
+		case(DISARMED):
+			if(((ledrun % 10U) == 0U) || (L5mPrevSysState != L5mSysState)){ //if in disarmed state, toggle led state every 500 mS.
+				if(SSenseState.electrodeState == 3U){
+					ledstates[0] = !ledstates[0];
+					ledstates[1] = ledstates[0];
 				}
-				else if(SSenseState.electrodeState != SSenseState.prevElectrodeState){
-					alarmleddisp += SSenseState.electrodeState;
+				else if(SSenseState.electrodeState == 2U){
+					ledstates[0] = 0U;
+					ledstates[1] = !ledstates[1];
 				}
-				else{}
-				if(ledcount >= 10U || (SSenseState.electrodeState != SSenseState.prevElectrodeState)){ //if in alarm state, toggle led state every 100 mS.
-					ledcount = 0;
-					switch(alarmleddisp)
-					{
-						case(0u):
-							ledstates[0] = 0u;
-							ledstates[1] = 0u;
-						break;
-
-						case(1U):
-							ledstates[0] = !ledstates[0];
-							ledstates[1] = 0U;
-						break;
-
-						case(2U):
-							ledstates[1] = !ledstates[1];
-							ledstates[0] = 0U;
-						break;
-
-						default:
-							ledstates[0] = !ledstates[0];
-							ledstates[1] = ledstates[0];
-						break;
-					}
+				else if(SSenseState.electrodeState == 1U){
+					ledstates[1] = 0U;
+					ledstates[0] = !ledstates[0];
+				}
+				else{
+					ledstates[0] = 0U;
+					ledstates[1] = 0U;
 				}
-			break;
+			}
+			else{}
+		break;
 
-			default:
-			break;
+		case(ALARM):
+			if(L5mPrevSysState != ALARM){
+				alarmleddisp = SSenseState.electrodeState;
+			}
+			else if(SSenseState.electrodeState != SSenseState.prevElectrodeState){
+				alarmleddisp += SSenseState.electrodeState;
+			}
+			else{}
+			if(((ledrun % 2U) == 0U) || (SSenseState.electrodeState != SSenseState.prevElectrodeState)){ //if in alarm state, toggle led state every 100 mS.
+				switch(alarmleddisp)
+				{
+					case(0u):
+						ledstates[0] = 0u;
+						ledstates[1] = 0u;
+					break;
+
+					case(1U):
+						ledstates[0] = !ledstates[0];
+						ledstates[1] = 0U;
+					break;
 
+					case(2U):
+						ledstates[1] = !ledstates[1];
+						ledstates[0] = 0U;
+					break;
+
+					default:
+						ledstates[0] = !ledstates[0];
+						ledstates[1] = ledstates[0];
+					break;
+				}
 			}
+		break;
+
+		default:
+		break;
 
-		//physically turn led's on or off based on change of state set above
-		if(ledstates[0] == 1U){
-			LED8_TURN_ON();
-		}
-		else{
-			LED8_TURN_OFF();
-		}
-		if(ledstates[1] == 1U){
-			LED9_TURN_ON();
-		}
-		else{
-			LED9_TURN_OFF();
 		}
-		DB4_TURN_OFF();
+
+	//physically turn led's on or off based on change of state set above
+	if(ledstates[0] == 1U){
+		LED8_TURN_ON();
 	}
-	else{}
+	else{
+		LED8_TURN_OFF();
+	}
+	if(ledstates[1] == 1U){
+		LED9_TURN_ON();
+	}
+	else{
+		LED9_TURN_OFF();
+	}
+	L5mPrevSysState = L5mSysState; //state changes made by events since the last run are seen once
+	DB4_TURN_OFF();
 /////////////////////////////////////////////////////////////////////////////////////
 }
 
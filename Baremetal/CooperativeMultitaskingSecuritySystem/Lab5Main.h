@@ -14,7 +14,8 @@
  *
  * 	-L5mAlarmFlags: alarm state indicator
  *  -L5mSysState: current system state
- *  -L5mPrevSysState: previous system state
+ *  -L5mPrevSysState: system state when LEDTask last ran
+ *  -L5M_EVENTS_T: dispatcher events, highest priority first
  *********************************************************/
 typedef enum{NONE, TOUCH, TEMP} ALARM_FLAGS_T;
 extern ALARM_FLAGS_T L5mAlarmFlags;
@@ -23,4 +24,6 @@ typedef enum{ARMED, DISARMED, ALARM} SYS_STATE_T;
 extern SYS_STATE_T L5mSysState;
 extern SYS_STATE_T L5mPrevSysState;
 
+typedef enum{L5M_EV_ALARM, L5M_EV_KEY, L5M_EV_SLICE, L5M_NUM_EVENTS} L5M_EVENTS_T;
+
 #endif /* LAB5MAIN_H_ */
@@ -3,102 +3,185 @@
  * 		   Module also contains task to control sampling and scanning of touch
  * 		   sensors.
  *
- * Sam Condon, 11/25/2019
+ * 		   The electrodes are listed in senseElectrodes, each with its channel, pin,
+ * 		   press and release offsets and scan weight.  TSIInit() builds senseScanSeq
+ * 		   from the weights, a smooth weighted round robin, and SensorTask scans
+ * 		   down it one electrode per completed scan, so adding a pad is one line in
+ * 		   the table and the work per scan does not grow with the number of pads.
+ * 		   Electrode n of the table is bit n of electrodeState.
+ *
+ * 		   With TSI_WAKE_EN set, scanning is done without the CPU: a PIT paced DMA
+* 		   channel plays senseScanSeq, writing each electrode's out-of-range
+* 		   threshold to TSHD and starting its scan.  The wake PIT never stops and
+* 		   its TCD is written once, so it is the shareable base Temp's conversion
+* 		   starts are divided down from.
+*
+* 		   Every count goes through a TSIFilter: an IIR baseline that tracks drift
+* 		   while released, press/release hysteresis and N of M debounce.  In wake
+* 		   mode the filtering and the touch alarm are done in TSI0_IRQHandler(), so
+* 		   ALARM is posted from the scan that confirms the touch, not a later
+* 		   slice.  While every filter is idle the TSI interrupts only on a count
+* 		   above its electrode's press level; scans that don't interrupt are known
+* 		   to be released decisions and only miss a baseline step.  A count that
+* 		   interrupts switches the TSI to interrupting at the end of every scan
+* 		   until all the filters are idle again, when the thresholds are written
+* 		   from the moved baselines.  SenseRebaseTask, every 640 mS. from its own
+* 		   task table entry, forces one pass of end of scan interrupts so idle
+* 		   baselines still get counts.
+*
+* Sam Condon, 11/25/2019
  ******************************************************************************************************/
 
 //INCLUDE DEPENDENCIES////////
 #include "MCUType.h"
 #include "K65TWR_GPIO.h"
 #include "Lab5Main.h"
+#include "TSIFilter.h"
 #include "Sense.h"
+#include "ResAlloc.h"
+#include "Evt.h"
 //////////////////////////////
 
 //DEFINES FOR ELECTRODE 1 AND 2 ARRAY INDEXING AND OFFSET//
-#define ELECTRODE1 0
-#define ELECTRODE2 1
+#define ELECTRODE2 0 //electrodeState bit 0
+#define ELECTRODE1 1 //electrodeState bit 1
 
+#define E1_CH 11U //TSI channel scanned as electrode 1, PTB18
+#define E2_CH 12U //TSI channel scanned as electrode 2, PTB19
 #define E1_TOUCH_OFFSET 0x008f
 #define E2_TOUCH_OFFSET 0x09ff
+#define E1_RELEASE_OFFSET 0x006b //counts above baseline to stay touched
+#define E2_RELEASE_OFFSET 0x077f
+
+#define SENSE_SEQ_MAX 8u //longest scan sequence, sum of the electrode weights
+#define SENSE_TSI_CHANNELS 16u
+#define SENSE_NO_ELECTRODE 0xffU //senseChIndex entry of an unused channel
+///////////////////////////////////////////////////////////
+
+//WAKE MODE/////////////////////////////////////////////////
+#define TSI_WAKE_EN 1u
+#define TSI_WAKE_PERIOD 600000u //bus clocks between scans, 10 mS. per electrode
+#define TSI_WAKE_ENTRIES 8u //{TSHD, DATA} pairs in the table, senseScanSeq repeated
+#define TSI_WAKE_TBL_BYTES 64u //TSI_WAKE_ENTRIES pairs, SMOD alignment
+#define TSI_WAKE_SMOD 6u //2^6 bytes, source modulo wraps the table
+#define TSI_WAKE_WORD 4u
 ///////////////////////////////////////////////////////////
 
 //TYPEDEFS///////////////////////////////////////////////////
-typedef enum{START, ELECTRODE_2, WRITE}SENSE_TASK_STATE_T;
+typedef enum{START, SCAN}SENSE_TASK_STATE_T;
+
+/*****************************************************
+ * SENSE_ELECTRODE_T - one entry of the electrode table
+ *
+ * 	-ch: TSI channel
+ * 	-port, pin: the channel's pin, set to the TSI function
+ * 	-pressoffset: counts above baseline to press
+ * 	-releaseoffset: counts above baseline to stay pressed
+ * 	-weight: scans per pass of senseScanSeq
+ *****************************************************/
+typedef struct{
+	INT8U ch;
+	PORT_Type *port;
+	INT8U pin;
+	INT16U pressoffset;
+	INT16U releaseoffset;
+	INT8U weight;
+}SENSE_ELECTRODE_T;
+/////////////////////////////////////////////////////////////
+
+//ELECTRODE TABLE AND SCAN SEQUENCE//////////////////////////
+static const SENSE_ELECTRODE_T senseElectrodes[SENSE_NUM_ELECTRODES] = {
+	{E2_CH, PORTB, 19U, E2_TOUCH_OFFSET, E2_RELEASE_OFFSET, 1U}, //ELECTRODE2
+	{E1_CH, PORTB, 18U, E1_TOUCH_OFFSET, E1_RELEASE_OFFSET, 1U}  //ELECTRODE1
+};
+static INT8U senseScanSeq[SENSE_SEQ_MAX]; //electrode indexes in scan order
+static INT8U senseSeqLen; //entries used in senseScanSeq
+
+static void SenseSeqBuild(void);
+/////////////////////////////////////////////////////////////
+
+#if TSI_WAKE_EN
+//WAKE MODE RESOURCES////////////////////////////////////////
+static RES_PERIODIC_T senseDma; //PIT and DMA channel from ResAlloc
+static INT32U senseWakeTbl[TSI_WAKE_TBL_BYTES/TSI_WAKE_WORD] __attribute__((aligned(TSI_WAKE_TBL_BYTES))); //TSHD, DATA pairs
+static INT8U senseChIndex[SENSE_TSI_CHANNELS]; //TSI channel to electrode index
+static volatile INT8U senseEosScans; //end of scan interrupts still owed to a rebase pass
+static const INT8C senseOwnerStrg[] = "Sense";
+
+static void SenseWakeInit(TSI* sensestate);
+static void SenseWakeTblUpdate(TSI* sensestate);
+void TSI0_IRQHandler(void);
 /////////////////////////////////////////////////////////////
+#endif
 
 /**********************************************************************
  * SensorTask() - Runs the SENSE_TASK state machine
  *
  *	States:
  *
- *		-START: Starting state starts a scan on electrode 1.  This is only run once on reset
- *		-ELECTRODE_2: Waits for the eosf from an electrode 1 scan, then starts a scan on electrode 2
- *		-WRITE: Waits for eosf from electrode 2 scan, updates public SenseState struct,
- *				then starts a scan on electrode 1
+ *		-START: Starting state starts a scan on the first electrode of senseScanSeq.
+ *				This is only run once on reset
+ *		-SCAN: Waits for the eosf, filters the electrode just scanned, then starts
+ *			   a scan on the next one.  Updates the public SenseState struct at the
+ *			   end of each pass of senseScanSeq
+ *
+ *	In wake mode TSI0_IRQHandler() does the filtering and the task only
+ *	keeps prevElectrodeState; SenseRebaseTask() starts the refresh passes.
  *
  * 11/25/2019
  **********************************************************************/
 void SensorTask(void){
-
+#if TSI_WAKE_EN
+	DB3_TURN_ON();
+	SSenseState.prevElectrodeState = SSenseState.electrodeState;
+	DB3_TURN_OFF();
+#else
 	static SENSE_TASK_STATE_T sensetaskstate = START;
 
-	static INT8U electrode1state;
-	static INT8U electrode2state;
+	static INT8U scanindex = 0u;
+	static INT8U scanstate = 0u;
+	INT8U ind;
 
 	DB3_TURN_ON();
 	switch(sensetaskstate)
 	{
 
 		case(START):
-			//UNCONDITIONALLY START A SCAN OF ELECTRODE 1///////////////
+			//UNCONDITIONALLY START A SCAN OF THE FIRST ELECTRODE///////
 			L5mAlarmFlags = 0U;
 
-			TSI0->DATA = TSI_DATA_TSICH(11U); //select electrode 1
+			TSI0->DATA = TSI_DATA_TSICH(senseElectrodes[senseScanSeq[0]].ch); //select electrode
 			TSI0->DATA |= TSI_DATA_SWTS(1); //set scan trigger
-			sensetaskstate = ELECTRODE_2;
+			sensetaskstate = SCAN;
 			////////////////////////////////////////////////////////////
 		break;
 
-		case(ELECTRODE_2):
+		case(SCAN):
 
-			//L5mAlarmFlags = 0U;
 			SSenseState.prevElectrodeState = SSenseState.electrodeState;
 
 			if((TSI0->GENCS & TSI_GENCS_EOSF_MASK) != 0U){
 				TSI0->GENCS |= TSI_GENCS_EOSF(1);
-				if((INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK) >= SSenseState.tsiTouchLevels[ELECTRODE1]){
-					electrode1state = 1U;
+				ind = senseScanSeq[scanindex];
+				if(TSIFiltUpdate(&SSenseState.tsiFilt[ind], (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK)) != 0u){
+					scanstate |= (INT8U)(1U << ind);
 				}
 				else{
-					electrode1state = 0U;
+					scanstate &= (INT8U)~(1U << ind);
 				}
 
-				sensetaskstate = WRITE;
-				TSI0->DATA = TSI_DATA_TSICH(12U);
-				TSI0->DATA |= TSI_DATA_SWTS(1);
-			}
-			else{}
-
-		break;
-
-		case(WRITE):
-
-			if((TSI0->GENCS & TSI_GENCS_EOSF_MASK) != 0U){
-				TSI0->GENCS |= TSI_GENCS_EOSF(1);
-				if((INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK) >= SSenseState.tsiTouchLevels[ELECTRODE2]){
-					electrode2state = 1U;
-				}
-				else{
-					electrode2state = 0U;
+				scanindex++;
+				if(scanindex >= senseSeqLen){
+					scanindex = 0u;
+					SSenseState.electrodeState = scanstate;
+					if(SSenseState.electrodeState > 0){
+						L5mAlarmFlags = TOUCH;
+						EvtPost(L5M_EV_ALARM);
+					}
 				}
+				else{}
 
-				SSenseState.electrodeState = (2*electrode1state + electrode2state);
-
-				if(SSenseState.electrodeState > 0){
-					L5mAlarmFlags = TOUCH;
-				}
-
-				sensetaskstate = ELECTRODE_2;
-				TSI0->DATA = TSI_DATA_TSICH(11U);
+				TSI0->DATA = TSI_DATA_TSICH(senseElectrodes[senseScanSeq[scanindex]].ch);
 				TSI0->DATA |= TSI_DATA_SWTS(1);
 			}
 			else{}
@@ -108,10 +191,22 @@ void SensorTask(void){
 	}
 
 	DB3_TURN_OFF();
-
+#endif
 }
 
-
+/**********************************************************************
+ * SenseRebaseTask() - Start one pass of end of scan interrupts so the
+ * 					   idle baselines get counts.  Nothing to do with
+ * 					   TSI_WAKE_EN clear, where every scan is filtered.
+ **********************************************************************/
+void SenseRebaseTask(void){
+#if TSI_WAKE_EN
+	NVIC_DisableIRQ(TSI0_IRQn);
+	senseEosScans = senseSeqLen;
+	TSI0->GENCS = (TSI0->GENCS & ~(TSI_GENCS_OUTRGF_MASK | TSI_GENCS_EOSF_MASK)) | TSI_GENCS_ESOR(1);
+	NVIC_EnableIRQ(TSI0_IRQn);
+#endif
+}
 
 /**********************************************************************
  * TSIInit() - Initialize touch sensors on K65TWR board
@@ -124,10 +219,13 @@ void SensorTask(void){
  *	11/25/2019
  **********************************************************************/
 void TSIInit(TSI* sensestate){
-	SIM->SCGC5 |= SIM_SCGC5_PORTB_MASK;
+	INT8U ind;
+
+	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK | SIM_SCGC5_PORTB_MASK | SIM_SCGC5_PORTC_MASK; //ports with TSI channels
 	SIM->SCGC5 |= SIM_SCGC5_TSI(1);
-	PORTB->PCR[18] &= (0xffffffff & PORT_PCR_MUX(0x0U));
-	PORTB->PCR[19] &= (0xffffffff & PORT_PCR_MUX(0x0U));
+	for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+		senseElectrodes[ind].port->PCR[senseElectrodes[ind].pin] = PORT_PCR_MUX(0x0U);
+	}
 
 
 	//CONFIGURE TSI/////////////////////////
@@ -140,32 +238,184 @@ void TSIInit(TSI* sensestate){
 
 	////////////////////////////////////////
 
-	//TSI0 ELECTRODE2 CALIBRATION//////////////////////////////////////////////////////////////////////
-	TSI0->DATA = TSI_DATA_TSICH(11);
-	TSI0->DATA |= TSI_DATA_SWTS(1);
+	//TSI0 ELECTRODE CALIBRATION//////////////////////////////////////////////////////////////////////
+	for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+		TSI0->DATA = TSI_DATA_TSICH(senseElectrodes[ind].ch);
+		TSI0->DATA |= TSI_DATA_SWTS(1);
+
+		while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
+			//wait for scan to complete
+		}
+		TSI0->GENCS |= TSI_GENCS_EOSF(1); //clear end of scan flag
 
-	while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
-		//wait for scan to complete
+		TSIFiltInit(&sensestate->tsiFilt[ind], (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK),
+					senseElectrodes[ind].pressoffset, senseElectrodes[ind].releaseoffset);
 	}
-	TSI0->GENCS |= TSI_GENCS_EOSF(1); //clear end of scan flag
 
-	sensestate->tsiBaselineLevels[ELECTRODE2] = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
-	sensestate->tsiTouchLevels[ELECTRODE2] = (INT16U)(sensestate->tsiBaselineLevels[ELECTRODE2] + E2_TOUCH_OFFSET);
-	/////////////////////////////////////////////////////////////////////////////////////////
+	L5mAlarmFlags = NONE;
+	////////////////////////////////////////////////////////////////
 
-	//TSI0 ELECTRODE1 CALIBRATION///////////////////////////////////////////////////////////////////////
-	TSI0->DATA = TSI_DATA_TSICH(12);
-	TSI0->DATA |= TSI_DATA_SWTS(1);
+	SenseSeqBuild();
+#if TSI_WAKE_EN
+	SenseWakeInit(sensestate);
+#endif
+}
 
-	while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
-		//wait for scan to complete
+/**********************************************************************
+ * SenseSeqBuild() - Fill senseScanSeq from the electrode weights with a
+ * 					 smooth weighted round robin: each slot every electrode
+ * 					 gains its weight in credit, the one with the most credit
+ * 					 is scanned and pays back the total weight.
+ *
+ *	Parametes: none
+ *	Returns: none
+ **********************************************************************/
+static void SenseSeqBuild(void){
+	INT16S credit[SENSE_NUM_ELECTRODES];
+	INT16S total = 0;
+	INT8U ind;
+	INT8U best;
+	INT8U slot;
+
+	for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+		credit[ind] = 0;
+		total += (INT16S)senseElectrodes[ind].weight;
 	}
-	TSI0->GENCS |= TSI_GENCS_EOSF(1);
+	if(total > (INT16S)SENSE_SEQ_MAX){
+		total = (INT16S)SENSE_SEQ_MAX;
+	}
+	else{}
+
+	for(slot = 0u; slot < (INT8U)total; slot++){
+		best = 0u;
+		for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+			credit[ind] += (INT16S)senseElectrodes[ind].weight;
+			if(credit[ind] > credit[best]){
+				best = ind;
+			}
+			else{}
+		}
+		credit[best] -= total;
+		senseScanSeq[slot] = best;
+	}
+	senseSeqLen = (INT8U)total;
+}
 
-	sensestate->tsiBaselineLevels[ELECTRODE1] = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
-	sensestate->tsiTouchLevels[ELECTRODE1] = (INT16U)(sensestate->tsiBaselineLevels[ELECTRODE1] + E1_TOUCH_OFFSET);
+#if TSI_WAKE_EN
+/**********************************************************************
+ * SenseWakeInit() - Build the {TSHD, DATA} table, senseScanSeq repeated,
+ * 					 from the filter levels and start the PIT paced DMA
+ * 					 channel that plays it.  DADDR starts at TSHD and steps
+ * 					 back to DATA, so each threshold is in place before
+ * 					 SWTS starts its scan.
+ *
+ *	Parametes:
+ *		sensestate - pointer to the calibrated TSI structure
+ *	Returns: none
+ **********************************************************************/
+static void SenseWakeInit(TSI* sensestate){
+	INT8U ind;
 
-	L5mAlarmFlags = NONE;
-	////////////////////////////////////////////////////////////////
+	for(ind = 0u; ind < SENSE_TSI_CHANNELS; ind++){
+		senseChIndex[ind] = SENSE_NO_ELECTRODE;
+	}
+	for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+		senseChIndex[senseElectrodes[ind].ch] = ind;
+	}
+	for(ind = 0u; ind < TSI_WAKE_ENTRIES; ind++){
+		senseWakeTbl[(2u*ind)+1u] = TSI_DATA_TSICH(senseElectrodes[senseScanSeq[ind % senseSeqLen]].ch) | TSI_DATA_SWTS(1);
+	}
+	SenseWakeTblUpdate(sensestate);
+
+	if(ResPeriodicAlloc(TSI_WAKE_PERIOD, TRUE, senseOwnerStrg, &senseDma) == FALSE){ //TempTask's ADC starts link off it
+		ResFail(senseOwnerStrg);
+	}
+	else{}
+
+	DMA0->TCD[senseDma.dmach].SADDR = DMA_SADDR_SADDR(senseWakeTbl);
+	DMA0->TCD[senseDma.dmach].SOFF = DMA_SOFF_SOFF(TSI_WAKE_WORD);
+	DMA0->TCD[senseDma.dmach].ATTR = DMA_ATTR_SMOD(TSI_WAKE_SMOD) | DMA_ATTR_SSIZE(2) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(2);
+	DMA0->TCD[senseDma.dmach].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(2u*TSI_WAKE_WORD);
+	DMA0->TCD[senseDma.dmach].SLAST = DMA_SLAST_SLAST(0);
+	DMA0->TCD[senseDma.dmach].DADDR = DMA_DADDR_DADDR(&TSI0->TSHD);
+	DMA0->TCD[senseDma.dmach].DOFF = DMA_DOFF_DOFF(-(INT16S)TSI_WAKE_WORD); //TSHD, then DATA
+	DMA0->TCD[senseDma.dmach].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+	DMA0->TCD[senseDma.dmach].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+	DMA0->TCD[senseDma.dmach].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(2u*TSI_WAKE_WORD); //back to TSHD
+	DMA0->TCD[senseDma.dmach].CSR = 0u;
+
+	TSI0->GENCS = (TSI0->GENCS & ~TSI_GENCS_ESOR_MASK) | TSI_GENCS_OUTRGF(1) | TSI_GENCS_EOSF(1) | TSI_GENCS_TSIIEN(1); //out of range interrupt only
+	NVIC_ClearPendingIRQ(TSI0_IRQn);
+	NVIC_EnableIRQ(TSI0_IRQn);
+	DMA0->SERQ = DMA_SERQ_SERQ(senseDma.dmach);
+	PIT->CHANNEL[senseDma.pit].TCTRL = PIT_TCTRL_TEN(1);
 }
 
+/**********************************************************************
+ * SenseWakeTblUpdate() - Write the filters' press levels into the wake
+ * 						  table.  Only used with every filter idle, so
+ * 						  TSIFiltLevel() is the press level.
+ *
+ *	Parametes:
+ *		sensestate - pointer to the TSI structure holding the filters
+ *	Returns: none
+ **********************************************************************/
+static void SenseWakeTblUpdate(TSI* sensestate){
+	INT8U ind;
+	INT32U tshd[SENSE_NUM_ELECTRODES];
+
+	for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+		tshd[ind] = TSI_TSHD_THRESH(TSIFiltLevel(&sensestate->tsiFilt[ind])) | TSI_TSHD_THRESL(0U);
+	}
+	for(ind = 0u; ind < TSI_WAKE_ENTRIES; ind++){
+		senseWakeTbl[2u*ind] = tshd[senseScanSeq[ind % senseSeqLen]];
+	}
+}
+
+/**********************************************************************
+ * TSI0_IRQHandler() - A scan to filter: out of range, above its press
+ * 					   level, or any scan while the TSI interrupts at the
+ * 					   end of each.  Runs the count through the electrode's
+ * 					   filter, posts L5M_EV_ALARM when a touch is confirmed
+ * 					   and picks the interrupt for the next scan.
+ **********************************************************************/
+void TSI0_IRQHandler(void){
+	INT8U ind;
+	INT8U state = 0u;
+	INT8U idle = TRUE;
+	INT32U data;
+
+	TSI0->GENCS |= TSI_GENCS_OUTRGF(1) | TSI_GENCS_EOSF(1); //write 1 to clear
+	data = TSI0->DATA;
+	ind = senseChIndex[(data & TSI_DATA_TSICH_MASK) >> TSI_DATA_TSICH_SHIFT];
+	if(ind != SENSE_NO_ELECTRODE){
+		(void)TSIFiltUpdate(&SSenseState.tsiFilt[ind], (INT16U)(data & TSI_DATA_TSICNT_MASK));
+		for(ind = 0u; ind < SENSE_NUM_ELECTRODES; ind++){
+			state |= (INT8U)(SSenseState.tsiFilt[ind].state << ind);
+			if(TSIFiltIdle(&SSenseState.tsiFilt[ind]) == FALSE){
+				idle = FALSE;
+			}
+			else{}
+		}
+		SSenseState.electrodeState = state;
+		if((state != 0u) && (L5mAlarmFlags != TOUCH)){
+			L5mAlarmFlags = TOUCH;
+			EvtPost(L5M_EV_ALARM);
+		}
+		else{}
+
+		if(senseEosScans != 0u){
+			senseEosScans--;
+		}
+		else{}
+		if((idle == TRUE) && (senseEosScans == 0u)){
+			SenseWakeTblUpdate(&SSenseState);
+			TSI0->GENCS &= ~(TSI_GENCS_ESOR_MASK | TSI_GENCS_OUTRGF_MASK | TSI_GENCS_EOSF_MASK); //out of range only
+		}
+		else{
+			TSI0->GENCS = (TSI0->GENCS & ~(TSI_GENCS_OUTRGF_MASK | TSI_GENCS_EOSF_MASK)) | TSI_GENCS_ESOR(1); //every scan
+		}
+	}
+	else{}
+}
+#endif
@@ -8,14 +8,15 @@
 #ifndef SENSE_H_
 #define SENSE_H_
 
+#define SENSE_NUM_ELECTRODES 2u //entries in the Sense.c electrode table, at most 8
+
 //STRUCT TO HOLD STATES OF ALL SENSOR INPUT//////////////////////////////////////////
 
 typedef struct{
-	INT8U electrodeState;
+	INT8U electrodeState; //bit n set while electrode n of the table is touched
 	INT8U prevElectrodeState;
 	INT8U scanDoneState;
-	INT16U tsiBaselineLevels[2]; //index 0 for ELECTRODE1, index 1 for ELECTRODE2
-	INT16U tsiTouchLevels[2];	 //same indexing as above
+	TSI_FILT_T tsiFilt[SENSE_NUM_ELECTRODES]; //baseline, thresholds and debounce, indexed like the electrode table
 }TSI;
 
 extern TSI SSenseState;
@@ -23,6 +24,7 @@ extern TSI SSenseState;
 
 //PROTOTYPES///////////////////////
 void SensorTask(void);
+void SenseRebaseTask(void); //baseline refresh pass, every 640 mS.
 void TSIInit(TSI* sensestate);
 //////////////////////////////////
 
@@ -1,7 +1,30 @@
 /*************************************************************************************************
- * Temp - Module containing initialization routine for ADC and PIT channel 1 to sample temp sensor data.
+ * Temp - Module containing initialization routine for ADC and a PIT channel to sample temp sensor data.
  * 		  Module also contains task to control sampling of the ADC and fixed point math conversion to celcius
- * 		  or fahrenheit.  Task to be run in a time slice scheduler every 50 slices.
+ * 		  or fahrenheit.  Task to be run in a time slice scheduler every 50 mS.
+ *
+ * 		  A DMA channel started every TEMP_PERIOD writes tempSc1 to ADC0 SC1A, a software trigger, so a
+ * 		  conversion starts at 50 Hz. without the CPU.  The start is divided down from the TSI wake PIT
+ * 		  through ResAlloc, so Temp needs no PIT of its own while the wake scan runs, and gets an owned PIT
+ * 		  n / DMA n pair when it doesn't.  The ADC conversion complete DMA request copies every
+ * 		  result into tempBuf, a two block ring wrapped by the destination modulo, with no CPU involved.
+ * 		  TempTask only compares the DMA destination address with the block it expects next; when the DMA
+ * 		  has moved on, the finished block of TEMP_BLOCK_SAMPS results is reduced to one reading by a trimmed
+ * 		  mean (the highest and lowest results dropped) and converted, a new reading every 320 mS.
+ *
+ * 		  The conversion is a piecewise linear table indexed by the top TEMP_TBL_BITS of the result and
+ * 		  interpolated on the rest in 32 bit Q16, giving signed celcius in tenths.  Fahrenheit is worked
+ * 		  out from the same Q16 value, before rounding, only when it is displayed; the last Q16 reading
+ * 		  is kept in TTempCom so a unit change converts it at once.  Both are within half a tenth of
+ * 		  the sensor line, see tests/TempTest.c in SecuritySim.
+ *
+ * 		  The alarm limits are converted once to ADC codes and loaded into the ADC compare range, so
+ * 		  in range conversions never complete and only out of range ones reach the DMA and ADC0_IRQHandler,
+ * 		  which sets the alarm.  Every 2 S. TempWinTask, from its own task table entry, opens a display
+ * 		  window, turning the compare off until a fresh block has been filtered, so the display keeps
+ * 		  updating at that low rate.  The block in progress when a window opens holds results from
+ * 		  before it and is filtered but not published.  The system starts with a window open, a block
+ * 		  from the first conversions, so the first reading is shown within half a second.
  *
  * Sam Condon, 11/30/2019
  **************************************************************************************************/
@@ -12,29 +35,88 @@
 #include "MK65F18.h"
 #include "BasicIO.h"
 #include "K65TWR_GPIO.h"
+#include "ResAlloc.h"
+#include "Evt.h"
 
 #define CELCIUS 0u
 #define FAHRENHEIT 1u
-#define TWO_HERTZ_LDVAL 29999999u
+#define TEMP_PERIOD 1200000u //bus clocks between conversion starts, 20 mS., two TSI wake periods
+#define TEMP_SC1_BYTES 4u
+#define DMA_SRC_ADC0 40u //DMAMUX source, ADC0 conversion complete
+#define TEMP_BLOCK_SAMPS 16u //results per reading
+#define TEMP_BUF_SAMPS 32u //two blocks
+#define TEMP_BUF_BYTES 64u //TEMP_BUF_SAMPS 16 bit results, DMOD alignment
+#define TEMP_BUF_DMOD 6u //2^6 bytes, destination modulo wraps the ring
+#define TEMP_SAMP_BYTES 2u
+#define TEMP_ADCH 3u //temp sensor input
+#define TEMP_WIN_BLOCKS 2u //the block in progress when the window opens is dropped, the next published
+#define TEMP_MAX_CODE 0xffffu
 
 /****************************************
- * FIXED POINT MATH CONSTANTS (ALL WITH SCALE FACTOR OF 2^16
- * 	(fixed point math op constants for ADC conversion processing)
- * 		-MULT_VAL_1: 3.3v(VrefH)*2^16
- * 		-MULT_VAL_2: (1/0.0195)*2^16
- * 		-SUB_VAL: 0.4*2^16
- * 	(fixed point math op constants for celcius to fahrenheit conversion)
- * 		-MULT_VAL_3: (9/5)*2^16
- * 		-ADD_VAL: 32*2^16
+ * CONVERSION TABLE CONSTANTS
+ * 		-TEMP_TBL_BITS: result bits indexing the table, 2^4 segments
+ * 		-TEMP_TBL_FRAC_BITS: result bits interpolated within a segment
+ * 		-TEMP_TBL_PRESHIFT: segment span is shifted down by this, rounded, before
+ * 		 the multiply by the fraction so the product fits 32 bits
+ * 	(fixed point math op constants for celcius to fahrenheit conversion, scale factor of 2^16)
+ * 		-TEMP_F_MUL/TEMP_F_DIV: 9/5, applied to the Q16 celcius
+ * 		-ADD_VAL: 320(32 in tenths)*2^16
  ****************************************/
-#define MULT_VAL_1 216269u
-#define MULT_VAL_2 3360821u
-#define SUB_VAL 26214u
+#define TEMP_TBL_BITS 4u
+#define TEMP_TBL_FRAC_BITS (16u - TEMP_TBL_BITS)
+#define TEMP_TBL_PRESHIFT 4u
+#define TEMP_Q16_HALF 0x8000
+
+#define TEMP_F_MUL 9
+#define TEMP_F_DIV 5
+#define ADD_VAL 20971520
 
-#define MULT_VAL_3 117965u
-#define ADD_VAL 2097152u
+#define TEMP_ALARM_HIGH 410 //41.0 C, above 40 whole degrees
+#define TEMP_ALARM_LOW 0 //below 0.0 C
 ///////////////////
 
+/****************************************
+ * tempTbl[] - celcius in tenths, Q16, at the start of each segment
+ * 	and one past the last.  Entry i is code i*2^12 through the sensor,
+ * 	(code*3.3v/2^16 - 0.4v)/0.0195v per degree, VrefH 3.3v.  A different
+ * 	sensor only needs a new table.
+ ****************************************/
+static const INT32S tempTbl[(1u << TEMP_TBL_BITS) + 1u] = {
+	-13443282,  //0
+	-6511590,   //4096
+	420103,     //8192
+	7351795,    //12288
+	14283487,   //16384
+	21215179,   //20480
+	28146872,   //24576
+	35078564,   //28672
+	42010256,   //32768
+	48941949,   //36864
+	55873641,   //40960
+	62805333,   //45056
+	69737026,   //49152
+	76668718,   //53248
+	83600410,   //57344
+	90532103,   //61440
+	97463795    //65536
+};
+
+static RES_PERIODIC_T tempStart; //PIT and DMA channel from ResAlloc starting the conversions
+static INT32U tempSc1; //SC1A written by the start channel, AIEN follows the compare
+static INT8U tempDmaCh; //DMA channel from ResAlloc copying ADC0 results
+static INT16U tempBuf[TEMP_BUF_SAMPS] __attribute__((aligned(TEMP_BUF_BYTES))); //ADC0 results ring
+static INT8U tempWinBlocks; //blocks left in the display window, 0 compare on
+static const INT8C tempOwnerStrg[] = "Temp";
+
+void ADC0_IRQHandler(void);
+
+static INT16U TempBlockFilter(const INT16U *block);
+static INT32S TempCodeToQ16(INT16U code);
+static INT16S TempCodeToDeciC(INT16U code);
+static INT16S TempQ16ToDeciF(INT32S tq16);
+static INT16U TempDeciCToCode(INT16S decic);
+static void TempCmpSet(INT8U on);
+
 /*******************************************************
  * TempInit() - Initialization routine for the ADC
  *
@@ -50,30 +132,71 @@ void TempInit(void){
 
 	ADC0->CFG1 = ADC_CFG1_ADIV(3) | ADC_CFG1_MODE(3) | ADC_CFG1_ADLSMP_MASK | ADC_CFG1_ADICLK(1); //set clock source/divide, sample size, and conversion speed
 	ADC0->SC3 = ADC_SC3_AVGE(1) | ADC_SC3_AVGS(3); //set conversion to be an average over 32 cts samples each conversion
-	ADC0->SC1[0] = ADC_SC1_ADCH(3);
+	ADC0->SC2 |= ADC_SC2_DMAEN_MASK; //software trigger, each SC1A write starts a conversion, and a DMA request per result on ADC0
+	//////////////////////////////////////////////////////////////////////////
 
-	SIM->SOPT7 = SIM_SOPT7_ADC0TRGSEL(5u); //set PIT1 to trigger ADC0
-	SIM->SOPT7 |= SIM_SOPT7_ADC0ALTTRGEN(1);
-	ADC0->SC2 |= ADC_SC2_ADTRG_MASK; //enable hardware triggering on ADC0
+	//LOAD ALARM LIMITS INTO THE ADC COMPARE//////////////////////////////////
+	//outside range, not inclusive: result < CV1 or result > CV2
+	ADC0->CV1 = ADC_CV1_CV(TempDeciCToCode(TEMP_ALARM_LOW));
+	ADC0->CV2 = ADC_CV2_CV(TempDeciCToCode(TEMP_ALARM_HIGH) - 1u);
+	ADC0->SC2 |= ADC_SC2_ACREN_MASK;
+	TempCmpSet(FALSE); //start with a window open, the first block is all fresh
+	tempWinBlocks = 1u;
+	TTempCom.ready = FALSE;
 	//////////////////////////////////////////////////////////////////////////
 
-	//INITIALIZE PIT1 FOR ADC TRIGGERING AT 2 Hz.///
-	SIM->SCGC6 |= SIM_SCGC6_PIT(1u);
-	PIT->MCR &= PIT_MCR_MDIS(0u);
-	PIT->CHANNEL[1].LDVAL = TWO_HERTZ_LDVAL;
-	PIT->CHANNEL[1].TFLG |= PIT_TFLG_TIF_MASK;
-	PIT->CHANNEL[1].TCTRL |= PIT_TCTRL_TIE_MASK;
-	////////////////////////////////////////////////
+	//INITIALIZE DMA FROM ADC0 RESULT TO tempBuf RING//////////////////////////
+	SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+	tempDmaCh = ResDmaAlloc(tempOwnerStrg);
+	if((tempDmaCh == RES_NONE) || (ResMuxClaim(DMA_SRC_ADC0, tempOwnerStrg) == FALSE)){
+		ResFail(tempOwnerStrg);
+	}
+	else{}
 
-	//ENABLE ADC AND PIT INTERRUPTS IN NVIC/////////////////
+	DMA0->TCD[tempDmaCh].SADDR = DMA_SADDR_SADDR(&ADC0->R[0]); //low half of R[0], the 16 bit result
+	DMA0->TCD[tempDmaCh].SOFF = DMA_SOFF_SOFF(0);
+	DMA0->TCD[tempDmaCh].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(1) | DMA_ATTR_DMOD(TEMP_BUF_DMOD) | DMA_ATTR_DSIZE(1);
+	DMA0->TCD[tempDmaCh].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(TEMP_SAMP_BYTES);
+	DMA0->TCD[tempDmaCh].SLAST = DMA_SLAST_SLAST(0);
+	DMA0->TCD[tempDmaCh].DADDR = DMA_DADDR_DADDR(tempBuf);
+	DMA0->TCD[tempDmaCh].DOFF = DMA_DOFF_DOFF(TEMP_SAMP_BYTES);
+	DMA0->TCD[tempDmaCh].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(TEMP_BUF_SAMPS);
+	DMA0->TCD[tempDmaCh].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(TEMP_BUF_SAMPS);
+	DMA0->TCD[tempDmaCh].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0); //DMOD already wrapped DADDR
+	DMA0->TCD[tempDmaCh].CSR = 0u; //request stays enabled, runs forever
+	DMAMUX->CHCFG[tempDmaCh] = DMAMUX_CHCFG_ENBL(1) | DMAMUX_CHCFG_SOURCE(DMA_SRC_ADC0);
+	DMA0->SERQ = DMA_SERQ_SERQ(tempDmaCh);
+	//////////////////////////////////////////////////////////////////////////
 
+	//INITIALIZE DMA FROM tempSc1 TO ADC0 SC1A EVERY TEMP_PERIOD/////////////
+	if(ResPeriodicAlloc(TEMP_PERIOD, FALSE, tempOwnerStrg, &tempStart) == FALSE){
+		ResFail(tempOwnerStrg);
+	}
+	else{}
+	DMA0->TCD[tempStart.dmach].SADDR = DMA_SADDR_SADDR(&tempSc1);
+	DMA0->TCD[tempStart.dmach].SOFF = DMA_SOFF_SOFF(0);
+	DMA0->TCD[tempStart.dmach].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(2) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(2);
+	DMA0->TCD[tempStart.dmach].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(TEMP_SC1_BYTES);
+	DMA0->TCD[tempStart.dmach].SLAST = DMA_SLAST_SLAST(0);
+	DMA0->TCD[tempStart.dmach].DADDR = DMA_DADDR_DADDR(&ADC0->SC1[0]);
+	DMA0->TCD[tempStart.dmach].DOFF = DMA_DOFF_DOFF(0);
+	DMA0->TCD[tempStart.dmach].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+	DMA0->TCD[tempStart.dmach].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+	DMA0->TCD[tempStart.dmach].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+	DMA0->TCD[tempStart.dmach].CSR = 0u;
+	//////////////////////////////////////////////////////////////////////////
+
+	//ENABLE ADC INTERRUPT IN NVIC//////////////////////////
+	NVIC_ClearPendingIRQ(ADC0_IRQn);
+	NVIC_EnableIRQ(ADC0_IRQn);
 	////////////////////////////////////////////////////////
 
 }
 
 /***************************************************************
- * TempTask() - start or sample a conversion from the ADC, convert
- * 				any sample from ADC to celcius or fahrenheit
+ * TempTask() - start the conversions, then filter each block the
+ * 				DMA finishes and convert it to celcius or fahrenheit
  *
  * 	Parameters: none
  * 	Returns: none
@@ -83,72 +206,55 @@ void TempInit(void){
 void TempTask(void){
 
 	static INT8U convinitflag = 0u; //flag for an initial conversion
-	static INT8S adctaskcnt = 0u; //time slice counter
-	static INT64U adcreadval; //to hold data read from adc data result register
-
-	//FIXED POINT MATH PROCESSING INTERMEDIATE VARIABLES//////////
-	INT64U postproc1;
-	INT64U adcvin;
-	INT64U tscaled;
-	INT8S tcelcius;
-	INT16S tfahrenheit;
-
-	INT64S postproc2;
-	///////////////////////////////////////////////////////////////
-	adctaskcnt++;
+	static INT8U blocknext = 0u; //tempBuf block to filter next
+	INT8U dmablock;
+	INT32S tq16; //celcius in tenths, Q16
+	INT16S decic; //celcius in tenths
 
 	switch(convinitflag)
 	{
 
 		case(0u): //perform initial conversion
-			adctaskcnt = -2; //set to -2 after initial conversion to offset TempTask from other tasks
 			convinitflag = 1u;
-			PIT->CHANNEL[1].TCTRL |= PIT_TCTRL_TEN_MASK; //enable PIT channel 1 to start hardware triggering of ADC
+			if(tempStart.divch != RES_NONE){ //link off the running TSI wake channel, its BITER was checked at the allocation
+				if(ResPeriodicLink(&tempStart) == FALSE){ //the wake channel's TCD changed, no conversions would start
+					ResFail(tempOwnerStrg);
+				}
+				else{}
+			}
+			else{ //owned PIT n / DMA n pair
+				DMA0->SERQ = DMA_SERQ_SERQ(tempStart.dmach);
+				PIT->CHANNEL[tempStart.pit].TCTRL |= PIT_TCTRL_TEN_MASK;
+			}
 		break;
 
 		case(1u):
-			if((adctaskcnt >= 50) && ((ADC0->SC1[0] & ADC_SC1_COCO_MASK) != 0u)){ //if 500 mS. has elapsed, and conversion complete flag is set, sample adc data result and convert to fahrenheit or celcius
+			dmablock = (INT8U)(((DMA0->TCD[tempDmaCh].DADDR - DMA_DADDR_DADDR(tempBuf))/TEMP_SAMP_BYTES)/TEMP_BLOCK_SAMPS); //block the DMA is filling
+			if(dmablock != blocknext){ //if the DMA has finished blocknext, filter it and convert to fahrenheit or celcius
 				DB6_TURN_ON();
-				adctaskcnt = 0u;
-				adcreadval = ADC0->R[0]; //read data
-				postproc1 = adcreadval*MULT_VAL_1;
-				adcvin = postproc1 >> 16; //now we have the voltage in, scaled by 2^16
-				if(adcvin < SUB_VAL){ //if voltage signifies a negative temperature
-					TTempCom.negflag = 1u;
-					tscaled = ((SUB_VAL - adcvin)*MULT_VAL_2)>>16;
-				}
-				else{
-					TTempCom.negflag = 0u;
-					tscaled = ((adcvin - SUB_VAL)*MULT_VAL_2)>>16;
-				}
-
-				tcelcius = (INT8U)(tscaled >> 16u); //temperature result in degrees celcius
-				if((tcelcius > 40) || (TTempCom.negflag == 1u)){ //set alarm flag if temperatuer is measured outside of allowed range
-					L5mAlarmFlags = TEMP;
+				tq16 = TempCodeToQ16(TempBlockFilter(&tempBuf[blocknext*TEMP_BLOCK_SAMPS]));
+				decic = (INT16S)((tq16 + TEMP_Q16_HALF) >> 16);
+				blocknext ^= 1u;
+				if(tempWinBlocks != TEMP_WIN_BLOCKS){ //not the block in progress when the window opened, stale
+					TTempCom.tempq16 = tq16;
+					TTempCom.tempdeci = decic;
+					TTempCom.ready = TRUE;
+					if((decic >= TEMP_ALARM_HIGH) || (decic < TEMP_ALARM_LOW)){ //set alarm flag if temperatuer is measured outside of allowed range, covers the display window
+						L5mAlarmFlags = TEMP;
+						EvtPost(L5M_EV_ALARM);
+					}
+					else{}
+					TempDispUpdate();
 				}
 				else{}
-
-				if(TTempCom.unit == CELCIUS){
-					TTempCom.tempdispval = tcelcius;
+				if(tempWinBlocks == 1u){ //window block filtered, back to the compare
+					TempCmpSet(TRUE);
 				}
-				else{ //convert celcius to fahrenheit
-					if(TTempCom.negflag==1u){
-						tcelcius = tcelcius*-1;
-					}
-					else{}
-					postproc2 =  tcelcius*MULT_VAL_3;
-					tfahrenheit = (postproc2 + ADD_VAL)>>16;
-					if(tfahrenheit >= 0){
-						TTempCom.tempdispval = tfahrenheit;
-						TTempCom.negflag = 0u;
-					}
-					else{
-						tfahrenheit = tfahrenheit*-1;
-						TTempCom.negflag = 1u;
-						TTempCom.tempdispval = tfahrenheit;
-					}
-
+				else{}
+				if(tempWinBlocks != 0u){
+					tempWinBlocks--;
 				}
+				else{}
 				DB6_TURN_OFF();
 			}
 			else{}
@@ -161,3 +267,184 @@ void TempTask(void){
 	}
 
 }
+
+/***************************************************************
+ * TempDispUpdate() - Set tempdispval and negflag from the last
+ * 					  reading in TTempCom.unit.  Called by TempTask
+ * 					  for each reading and by whoever changes the
+ * 					  unit, so the display follows a unit change
+ * 					  without waiting for the next reading.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ***************************************************************/
+void TempDispUpdate(void){
+	INT16S disp; //display unit in tenths
+
+	if(TTempCom.unit == CELCIUS){
+		disp = TTempCom.tempdeci;
+	}
+	else{
+		disp = TempQ16ToDeciF(TTempCom.tempq16);
+	}
+	if(disp < 0){
+		TTempCom.negflag = 1u;
+		disp = -disp;
+	}
+	else{
+		TTempCom.negflag = 0u;
+	}
+	TTempCom.tempdispval = (INT8U)(disp/10); //whole degrees for the LCD
+}
+
+/***************************************************************
+ * TempWinTask() - Open a display window unless one is still open.
+ * 				   Runs in a TempTask slice, before it.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ***************************************************************/
+void TempWinTask(void){
+	if(tempWinBlocks == 0u){
+		TempCmpSet(FALSE);
+		tempWinBlocks = TEMP_WIN_BLOCKS;
+	}
+	else{}
+}
+
+/***************************************************************
+ * TempBlockFilter() - Trimmed mean of one block: the highest and
+ * 					   lowest results are dropped so a single
+ * 					   spike can't move the reading.
+ *
+ * 	Parameters:
+ * 		block - first of TEMP_BLOCK_SAMPS results
+ * 	Returns: filtered result, same scale as ADC0->R[0]
+ ***************************************************************/
+static INT16U TempBlockFilter(const INT16U *block){
+	INT32U sum = 0u;
+	INT16U min = 0xffffu;
+	INT16U max = 0u;
+	INT8U i;
+
+	for(i = 0u; i < TEMP_BLOCK_SAMPS; i++){
+		sum += block[i];
+		if(block[i] < min){
+			min = block[i];
+		}
+		else{}
+		if(block[i] > max){
+			max = block[i];
+		}
+		else{}
+	}
+	return((INT16U)((sum - min - max)/(TEMP_BLOCK_SAMPS - 2u)));
+}
+
+/***************************************************************
+ * TempCodeToQ16() - ADC result to celcius in tenths, Q16.  Looks
+ * 					 up the segment from the top bits and
+ * 					 interpolates on the rest, 32 bit math only.
+ * 					 Both shifts round.
+ *
+ * 	Parameters:
+ * 		code - 16 bit ADC result
+ * 	Returns: celcius in tenths, Q16
+ ***************************************************************/
+static INT32S TempCodeToQ16(INT16U code){
+	INT32U seg = (INT32U)code >> TEMP_TBL_FRAC_BITS;
+	INT32S frac = (INT32S)(code & ((1u << TEMP_TBL_FRAC_BITS) - 1u));
+	INT32S span = (tempTbl[seg + 1u] - tempTbl[seg] + (1 << (TEMP_TBL_PRESHIFT - 1u))) >> TEMP_TBL_PRESHIFT;
+
+	return(tempTbl[seg] + (((span*frac) + (1 << (TEMP_TBL_FRAC_BITS - TEMP_TBL_PRESHIFT - 1u)))
+		>> (TEMP_TBL_FRAC_BITS - TEMP_TBL_PRESHIFT)));
+}
+
+/***************************************************************
+ * TempCodeToDeciC() - ADC result to celcius in tenths.
+ *
+ * 	Parameters:
+ * 		code - 16 bit ADC result
+ * 	Returns: celcius in tenths, rounded
+ ***************************************************************/
+static INT16S TempCodeToDeciC(INT16U code){
+	return((INT16S)((TempCodeToQ16(code) + TEMP_Q16_HALF) >> 16));
+}
+
+/***************************************************************
+ * TempQ16ToDeciF() - Celcius in tenths, Q16, to fahrenheit in
+ * 					  tenths.  Working from the unrounded value
+ * 					  keeps the celcius rounding from being scaled
+ * 					  by 9/5.  9 times the largest table entry
+ * 					  still fits 32 bits.
+ *
+ * 	Parameters:
+ * 		tq16 - celcius in tenths, Q16
+ * 	Returns: fahrenheit in tenths, rounded
+ ***************************************************************/
+static INT16S TempQ16ToDeciF(INT32S tq16){
+	return((INT16S)((((tq16*TEMP_F_MUL)/TEMP_F_DIV) + ADD_VAL + TEMP_Q16_HALF) >> 16));
+}
+
+/***************************************************************
+ * TempDeciCToCode() - Lowest ADC result that converts to decic or
+ * 					   above.  Binary search of TempCodeToDeciC(),
+ * 					   only run at init.
+ *
+ * 	Parameters:
+ * 		decic - celcius in tenths
+ * 	Returns: ADC result, TEMP_MAX_CODE if decic is out of reach
+ ***************************************************************/
+static INT16U TempDeciCToCode(INT16S decic){
+	INT32U lo = 0u;
+	INT32U hi = TEMP_MAX_CODE;
+	INT32U mid;
+
+	while(lo < hi){
+		mid = (lo + hi) >> 1;
+		if(TempCodeToDeciC((INT16U)mid) < decic){
+			lo = mid + 1u;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	return((INT16U)lo);
+}
+
+/***************************************************************
+ * TempCmpSet() - Turn the alarm compare and its interrupt on or
+ * 				  off.  Off, every conversion completes for the
+ * 				  display window.  tempSc1 is set first so a start
+ * 				  between the two writes already has the new AIEN;
+ * 				  the SC1A write restarts the conversion in progress
+ * 				  with it, so no in range result can interrupt.
+ *
+ * 	Parameters:
+ * 		on - TRUE for the compare
+ * 	Returns: none
+ ***************************************************************/
+static void TempCmpSet(INT8U on){
+	if(on == TRUE){
+		ADC0->SC2 |= ADC_SC2_ACFE_MASK;
+		tempSc1 = ADC_SC1_ADCH(TEMP_ADCH) | ADC_SC1_AIEN_MASK;
+	}
+	else{
+		ADC0->SC2 &= ~ADC_SC2_ACFE_MASK;
+		tempSc1 = ADC_SC1_ADCH(TEMP_ADCH);
+	}
+	ADC0->SC1[0] = tempSc1;
+}
+
+/***************************************************************
+ * ADC0_IRQHandler() - A conversion completed with the compare on,
+ * 					   so it was out of range.  The DMA takes the
+ * 					   result, this only raises the alarm and
+ * 					   posts it so the siren starts at once.
+ ***************************************************************/
+void ADC0_IRQHandler(void){
+	DB5_TURN_ON();
+	L5mAlarmFlags = TEMP;
+	EvtPost(L5M_EV_ALARM);
+	DB5_TURN_OFF();
+}
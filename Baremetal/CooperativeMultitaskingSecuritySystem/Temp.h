@@ -9,12 +9,17 @@
 
 void TempInit(void); //public initialization function
 void TempTask(void); //public task
+void TempWinTask(void); //opens a display window, every 2 S.
+void TempDispUpdate(void); //display value from the last reading, after a unit change
 
 //Structure to hold all intertask communication data for TempTask and other modules/tasks
 typedef struct{
 	INT8U unit; //0 for celcius, 1 for fahrenheit.  This will be set in an external module to tell TempTask which unit to measure a temperature in
 	INT8U tempdispval;
 	INT8U negflag;
+	INT16S tempdeci; //last reading, celcius in tenths
+	INT8U ready; //FALSE until the first reading
+	INT32S tempq16; //last reading, celcius in tenths, Q16, converted again when unit changes
 }TEMP_COM_T;
 extern TEMP_COM_T TTempCom;
 
@@ -0,0 +1,404 @@
+/*************************************************************************************************
+ * TempLog - Temperature history log.  Readings are stored a bucket at a time: the first sample of
+ * 			 a bucket is an absolute keyframe and the rest are INT8S steps from the sample before,
+ * 			 so the log decodes from any bucket on its own.  A step larger than a byte is clamped and
+ * 			 the next step makes up the difference.
+ *
+ * 			 Window queries never walk the buckets.  Each bucket keeps the running sum and count of
+ * 			 every reading logged before it, so the sum over a run of buckets is a difference of two
+ * 			 entries; they are unsigned and wrap, which the difference undoes.  Minimum and maximum
+ * 			 come from tempLogRange[], where level k of a bucket covers the 2^k buckets ending at it,
+ * 			 and any run is the union of the two levels that fit it from either end.  The head's
+ * 			 entries are rebuilt on each reading, one per level; the others never change once their
+ * 			 bucket is full.
+ *
+ **************************************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "Sched.h"
+#include "SchedOut.h"
+#include "Temp.h"
+#include "TempLog.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define TEMP_LOG_SLICES 6000u //one reading a minute at 10 mS. slices
+#define TEMP_LOG_STEP_MAX 127
+#define TEMP_LOG_LEVELS 7u //2^6 = TEMP_LOG_BUCKETS
+#define TEMP_LOG_KEY_MAX 255u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE TYPES/////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * TEMP_LOG_BUCKET_T - one bucket's keyframe and aggregates.
+ * 	-presum, precount: sum and count of every reading
+ * 	 logged before the bucket, modulo 2^32
+ * 	-sum: of the readings in the bucket
+ * 	-key: first reading
+ * 	-count: samples in the bucket
+ *****************************************************/
+typedef struct{
+	INT32U presum;
+	INT32U precount;
+	INT32S sum;
+	INT16S key;
+	INT8U count;
+}TEMP_LOG_BUCKET_T;
+
+/*****************************************************
+ * TEMP_LOG_RANGE_T - min and max over a run of buckets.
+ *****************************************************/
+typedef struct{
+	INT16S min;
+	INT16S max;
+}TEMP_LOG_RANGE_T;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static TEMP_LOG_BUCKET_T tempLogBkt[TEMP_LOG_BUCKETS];
+static INT8S tempLogStep[TEMP_LOG_BUCKETS][TEMP_LOG_BUCKET_SAMPS - 1u];
+static TEMP_LOG_RANGE_T tempLogRange[TEMP_LOG_LEVELS][TEMP_LOG_BUCKETS]; //[k][b] buckets b-2^k+1..b
+static INT8U tempLogLevel[TEMP_LOG_BUCKETS + 1u]; //largest k with 2^k <= n
+static INT8U tempLogHead; //bucket being filled
+static INT8U tempLogUsed; //buckets holding samples, head included
+static INT16S tempLogLast; //decoded value of the newest sample
+
+static INT8U tempLogDumpLeft; //buckets left to print, 0 idle
+static INT8U tempLogDumpBkt;
+static INT8U tempLogDumpSamp; //next sample to print, 0 the bucket line
+static INT16S tempLogDumpVal;
+
+static INT16U tempLogKeyNum; //number being keyed
+static INT8U tempLogKeyOldest;
+static INT8U tempLogKeyStar; //'*'s keyed, 0 or 1
+static INT8U tempLogQueryNew; //query to answer, tempLogQueryWait set
+static INT8U tempLogQueryOld;
+static INT8U tempLogQueryWait;
+
+static const INT8C tempLogLineStrg[] = "\r\n";
+static const INT8C tempLogBktStrg[] = "bucket ";
+static const INT8C tempLogWinStrg[] = "buckets ";
+static const INT8C tempLogToStrg[] = " to ";
+static const INT8C tempLogMinStrg[] = " min ";
+static const INT8C tempLogMaxStrg[] = " max ";
+static const INT8C tempLogAvgStrg[] = " avg ";
+static const INT8C tempLogCountStrg[] = " samples ";
+static const INT8C tempLogNoneStrg[] = " not logged";
+static const INT8C tempLogMinusStrg[] = "-";
+static const INT8C tempLogPointStrg[] = ".";
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void TempLogQueryOut(void);
+static void TempLogDumpOut(void);
+static void TempLogRangeSet(void);
+static INT16S TempLogDecode(INT8U bkt, INT8U samp, INT16S prev);
+static void TempLogOutDeci(INT16S decic);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * TempLogInit() - Empty the log.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void TempLogInit(void){
+	INT8U len;
+
+	tempLogLevel[0] = 0u;
+	tempLogLevel[1] = 0u;
+	for(len = 2u; len <= TEMP_LOG_BUCKETS; len++){
+		tempLogLevel[len] = (INT8U)(tempLogLevel[len/2u] + 1u);
+	}
+	tempLogHead = 0u;
+	tempLogUsed = 0u;
+	tempLogBkt[0].count = 0u;
+	tempLogBkt[0].presum = 0u;
+	tempLogBkt[0].precount = 0u;
+	tempLogDumpLeft = 0u;
+	tempLogKeyNum = 0u;
+	tempLogKeyStar = 0u;
+	tempLogQueryWait = FALSE;
+}
+
+/*****************************************************************************
+ * TempLogTask() - Log a reading in the last slice of each minute and queue
+ * 				   one line of output if SchedOut has room for it, a query
+ * 				   answer before the next dump line.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void TempLogTask(void){
+	if((SchedSliceGet() % TEMP_LOG_SLICES) == (TEMP_LOG_SLICES - 1u)){
+		TempLogAdd(TTempCom.tempdeci);
+	}
+	else{}
+
+	if(SchedOutFree() < SCHED_OUT_LINE_MAX){ //wait for the queue to drain
+	}
+	else if(tempLogQueryWait == TRUE){
+		TempLogQueryOut();
+		tempLogQueryWait = FALSE;
+	}
+	else if(tempLogDumpLeft != 0u){
+		TempLogDumpOut();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TempLogAdd() - Append a reading, starting a new bucket over the oldest
+ * 				  when the head is full.
+ *
+ * 	Parameters: decic - celcius in tenths
+ * 	Returns: none
+ ******************************************************************************/
+void TempLogAdd(INT16S decic){
+	TEMP_LOG_BUCKET_T *bkt = &tempLogBkt[tempLogHead];
+	TEMP_LOG_RANGE_T *range = &tempLogRange[0][tempLogHead];
+	INT32S step;
+
+	if(bkt->count >= TEMP_LOG_BUCKET_SAMPS){
+		tempLogHead = (INT8U)((tempLogHead + 1u) % TEMP_LOG_BUCKETS);
+		tempLogBkt[tempLogHead].presum = bkt->presum + (INT32U)bkt->sum;
+		tempLogBkt[tempLogHead].precount = bkt->precount + bkt->count;
+		bkt = &tempLogBkt[tempLogHead];
+		range = &tempLogRange[0][tempLogHead];
+		bkt->count = 0u;
+	}
+	else{}
+
+	if(bkt->count == 0u){ //keyframe
+		bkt->key = decic;
+		range->min = decic;
+		range->max = decic;
+		bkt->sum = 0;
+		tempLogLast = decic;
+		if(tempLogUsed < TEMP_LOG_BUCKETS){
+			tempLogUsed++;
+		}
+		else{}
+	}
+	else{
+		step = (INT32S)decic - tempLogLast;
+		if(step > TEMP_LOG_STEP_MAX){
+			step = TEMP_LOG_STEP_MAX;
+		}
+		else if(step < -TEMP_LOG_STEP_MAX){
+			step = -TEMP_LOG_STEP_MAX;
+		}
+		else{}
+		tempLogStep[tempLogHead][bkt->count - 1u] = (INT8S)step;
+		tempLogLast = (INT16S)(tempLogLast + step);
+		if(decic < range->min){
+			range->min = decic;
+		}
+		else{}
+		if(decic > range->max){
+			range->max = decic;
+		}
+		else{}
+	}
+	bkt->sum += decic;
+	bkt->count++;
+	TempLogRangeSet();
+}
+
+/*****************************************************************************
+ * TempLogStats() - Min/max/average of a window of buckets from the running
+ * 					sums and two lookups a level of tempLogRange[].
+ *
+ * 	Parameters: newest - age of the newest bucket, 0 the head
+ * 				oldest - age of the oldest bucket
+ * 				stats - filled in
+ * 	Returns: FALSE if the window isn't in the log, stats untouched
+ ******************************************************************************/
+INT8U TempLogStats(INT8U newest, INT8U oldest, TEMP_LOG_STATS_T *stats){
+	const TEMP_LOG_RANGE_T *first;
+	const TEMP_LOG_RANGE_T *last;
+	INT8U oldbkt;
+	INT8U newbkt;
+	INT8U level;
+	INT32U sum;
+	INT8U found = FALSE;
+
+	if((newest <= oldest) && (oldest < tempLogUsed)){
+		oldbkt = (INT8U)((tempLogHead + TEMP_LOG_BUCKETS - oldest) % TEMP_LOG_BUCKETS);
+		newbkt = (INT8U)((tempLogHead + TEMP_LOG_BUCKETS - newest) % TEMP_LOG_BUCKETS);
+		level = tempLogLevel[oldest - newest + 1u];
+		first = &tempLogRange[level][(oldbkt + (1u << level) - 1u) % TEMP_LOG_BUCKETS];
+		last = &tempLogRange[level][newbkt];
+		stats->min = (first->min < last->min) ? first->min : last->min;
+		stats->max = (first->max > last->max) ? first->max : last->max;
+		sum = (tempLogBkt[newbkt].presum + (INT32U)tempLogBkt[newbkt].sum) - tempLogBkt[oldbkt].presum;
+		stats->count = (INT16U)((tempLogBkt[newbkt].precount + tempLogBkt[newbkt].count) - tempLogBkt[oldbkt].precount);
+		stats->avg = (INT16S)((INT32S)sum/(INT32S)stats->count);
+		found = TRUE;
+	}
+	else{}
+	return(found);
+}
+
+/*****************************************************************************
+ * TempLogKey() - Collect a query keyed as <oldest>*<newest>*.  Numbers past
+ * 				  TEMP_LOG_KEY_MAX stay there and are answered as not logged.
+ *
+ * 	Parameters: key - '0'-'9' or '*', anything else ignored
+ * 	Returns: none
+ ******************************************************************************/
+void TempLogKey(INT8C key){
+	if((key >= '0') && (key <= '9')){
+		tempLogKeyNum = (INT16U)((tempLogKeyNum*10u) + (INT16U)(key - '0'));
+		if(tempLogKeyNum > TEMP_LOG_KEY_MAX){
+			tempLogKeyNum = TEMP_LOG_KEY_MAX;
+		}
+		else{}
+	}
+	else if(key == '*'){
+		if(tempLogKeyStar == 0u){
+			tempLogKeyOldest = (INT8U)tempLogKeyNum;
+			tempLogKeyStar = 1u;
+		}
+		else{
+			tempLogQueryOld = tempLogKeyOldest;
+			tempLogQueryNew = (INT8U)tempLogKeyNum;
+			tempLogQueryWait = TRUE;
+			tempLogKeyStar = 0u;
+		}
+		tempLogKeyNum = 0u;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TempLogDumpStart() - Start a dump from the oldest bucket.  Restarts a dump
+ * 						already running.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void TempLogDumpStart(void){
+	tempLogDumpBkt = (INT8U)((tempLogHead + TEMP_LOG_BUCKETS + 1u - tempLogUsed) % TEMP_LOG_BUCKETS);
+	tempLogDumpSamp = 0u;
+	tempLogDumpLeft = tempLogUsed;
+}
+
+/*****************************************************************************
+ * TempLogQueryOut() - Queue the answer to the keyed query.
+ ******************************************************************************/
+static void TempLogQueryOut(void){
+	TEMP_LOG_STATS_T stats;
+
+	SchedOutPutStrg(tempLogLineStrg);
+	SchedOutPutStrg(tempLogWinStrg);
+	SchedOutDecWord(tempLogQueryOld);
+	SchedOutPutStrg(tempLogToStrg);
+	SchedOutDecWord(tempLogQueryNew);
+	if(TempLogStats(tempLogQueryNew, tempLogQueryOld, &stats) == TRUE){
+		SchedOutPutStrg(tempLogMinStrg);
+		TempLogOutDeci(stats.min);
+		SchedOutPutStrg(tempLogMaxStrg);
+		TempLogOutDeci(stats.max);
+		SchedOutPutStrg(tempLogAvgStrg);
+		TempLogOutDeci(stats.avg);
+		SchedOutPutStrg(tempLogCountStrg);
+		SchedOutDecWord(stats.count);
+	}
+	else{
+		SchedOutPutStrg(tempLogNoneStrg);
+	}
+	SchedOutPutStrg(tempLogLineStrg);
+}
+
+/*****************************************************************************
+ * TempLogDumpOut() - Queue the next line of the dump, a bucket's line with its
+ * 					  age or one decoded sample.
+ ******************************************************************************/
+static void TempLogDumpOut(void){
+	const TEMP_LOG_BUCKET_T *bkt = &tempLogBkt[tempLogDumpBkt];
+	const TEMP_LOG_RANGE_T *range = &tempLogRange[0][tempLogDumpBkt];
+
+	if(tempLogDumpSamp == 0u){ //bucket line
+		SchedOutPutStrg(tempLogLineStrg);
+		SchedOutPutStrg(tempLogBktStrg);
+		SchedOutDecWord((tempLogHead + TEMP_LOG_BUCKETS - tempLogDumpBkt) % TEMP_LOG_BUCKETS);
+		SchedOutPutStrg(tempLogMinStrg);
+		TempLogOutDeci(range->min);
+		SchedOutPutStrg(tempLogMaxStrg);
+		TempLogOutDeci(range->max);
+		SchedOutPutStrg(tempLogAvgStrg);
+		TempLogOutDeci((INT16S)(bkt->sum/bkt->count));
+	}
+	else{
+		tempLogDumpVal = TempLogDecode(tempLogDumpBkt, (INT8U)(tempLogDumpSamp - 1u), tempLogDumpVal);
+		SchedOutPutStrg(tempLogLineStrg);
+		TempLogOutDeci(tempLogDumpVal);
+	}
+	tempLogDumpSamp++;
+	if(tempLogDumpSamp > bkt->count){ //bucket done
+		tempLogDumpSamp = 0u;
+		tempLogDumpBkt = (INT8U)((tempLogDumpBkt + 1u) % TEMP_LOG_BUCKETS);
+		tempLogDumpLeft--;
+		if(tempLogDumpLeft == 0u){
+			SchedOutPutStrg(tempLogLineStrg);
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TempLogRangeSet() - Rebuild the head's entry at each level above 0 from the
+ * 					   two halves one level down.
+ ******************************************************************************/
+static void TempLogRangeSet(void){
+	const TEMP_LOG_RANGE_T *upper;
+	const TEMP_LOG_RANGE_T *lower;
+	TEMP_LOG_RANGE_T *range;
+	INT8U level;
+
+	for(level = 1u; level < TEMP_LOG_LEVELS; level++){
+		upper = &tempLogRange[level - 1u][tempLogHead];
+		lower = &tempLogRange[level - 1u][(tempLogHead + TEMP_LOG_BUCKETS - (1u << (level - 1u))) % TEMP_LOG_BUCKETS];
+		range = &tempLogRange[level][tempLogHead];
+		range->min = (upper->min < lower->min) ? upper->min : lower->min;
+		range->max = (upper->max > lower->max) ? upper->max : lower->max;
+	}
+}
+/*****************************************************************************
+ * TempLogDecode() - Value of sample samp of a bucket.
+ *
+ * 	Parameters: bkt - bucket
+ * 				samp - sample, 0 the keyframe
+ * 				prev - value of sample samp-1, unused for the keyframe
+ * 	Returns: celcius in tenths
+ ******************************************************************************/
+static INT16S TempLogDecode(INT8U bkt, INT8U samp, INT16S prev){
+	INT16S val;
+
+	if(samp == 0u){
+		val = tempLogBkt[bkt].key;
+	}
+	else{
+		val = (INT16S)(prev + tempLogStep[bkt][samp - 1u]);
+	}
+	return(val);
+}
+
+/*****************************************************************************
+ * TempLogOutDeci() - Print celcius tenths as [-]d.d
+ ******************************************************************************/
+static void TempLogOutDeci(INT16S decic){
+	INT32S mag = decic;
+
+	if(mag < 0){
+		SchedOutPutStrg(tempLogMinusStrg);
+		mag = -mag;
+	}
+	else{}
+	SchedOutDecWord((INT32U)(mag/10));
+	SchedOutPutStrg(tempLogPointStrg);
+	SchedOutDecWord((INT32U)(mag%10));
+}
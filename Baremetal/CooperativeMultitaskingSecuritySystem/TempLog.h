@@ -0,0 +1,69 @@
+/************************************************************************
+ * TempLog.h - Header for the temperature history log.  One reading a
+ * 			   minute is kept in RAM as 8 bit steps from a 16 bit keyframe
+ * 			   per bucket of an hour or so, about 68 hours in 7 KB, with
+ * 			   running sums and a min/max table over the buckets so a
+ * 			   window of any length is summed up in constant time.
+ *
+ *************************************************************************/
+
+#ifndef TEMPLOG_H_
+#define TEMPLOG_H_
+
+#define TEMP_LOG_BUCKET_SAMPS 64u //samples per bucket, one keyframe and 63 steps
+#define TEMP_LOG_BUCKETS 64u
+
+/*****************************************************
+ * TEMP_LOG_STATS_T - aggregates over a window of buckets,
+ * 	all temperatures in celcius tenths.
+ * 	-min, max, avg
+ * 	-count: samples in the window
+ *****************************************************/
+typedef struct{
+	INT16S min;
+	INT16S max;
+	INT16S avg;
+	INT16U count;
+}TEMP_LOG_STATS_T;
+
+/*****************************************************
+ * Empty the log.
+ *****************************************************/
+void TempLogInit(void);
+
+/*****************************************************
+ * Time slice task, every slice.  Logs TTempCom.tempdeci
+ * each minute of SchedSliceGet(), so slices run late
+ * don't move the log's time base, and queues a line of a
+ * query answer or a dump on SchedOut when it has room.
+ *****************************************************/
+void TempLogTask(void);
+
+/*****************************************************
+ * Append one reading, celcius in tenths.
+ *****************************************************/
+void TempLogAdd(INT16S decic);
+
+/*****************************************************
+ * Min/max/average of the buckets from age oldest to age
+ * newest, 0 the one being filled.  Constant time for any
+ * window.  Returns FALSE if newest > oldest or oldest is
+ * past the log.
+ *****************************************************/
+INT8U TempLogStats(INT8U newest, INT8U oldest, TEMP_LOG_STATS_T *stats);
+
+/*****************************************************
+ * Key entry for a query: <oldest>*<newest>* in bucket
+ * ages.  The answer is printed by TempLogTask().  Takes
+ * '0'-'9' and '*'.
+ *****************************************************/
+void TempLogKey(INT8C key);
+
+/*****************************************************
+ * Start printing the log oldest first on SchedOut: a
+ * min/max/avg line per bucket followed by its decoded
+ * samples.
+ *****************************************************/
+void TempLogDumpStart(void);
+
+#endif /* TEMPLOG_H_ */
@@ -0,0 +1,419 @@
+/********************************************************************************
+* ResAlloc - Module that hands out PIT channels, DMA channels and DMAMUX request
+* 			 sources so modules combined in one project can not silently claim the
+* 			 same hardware.  Periodic DMA consumers whose periods are integer
+* 			 multiples share one PIT: the base channel minor/major links to a
+* 			 divider channel, and the divider's major loop of mult iterations
+* 			 links to the consumer.  The DMA vectors are shared by channels n and
+* 			 n+16, so they are defined here and call the handler each module set
+* 			 for its allocated channel.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "MK65F18.h"
+#include "BasicIO.h"
+#include "ResAlloc.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define RES_DMA_PIT_SOURCE 60u // always enabled source gated by the PIT trigger
+#define RES_LINK_CITER_MAX 511u // base major loop count limit once minor loop linking is on
+#define RES_CITER_MAX 32767u // divider major loop count limit, no minor loop linking
+#define RES_DIV_BYTES 4u
+#define RES_DEC_FIELD 0u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE TYPES/////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * RES_PIT_T - one PIT channel's allocation.
+ * 	-owner: NULL when free
+ * 	-period: bus clocks per trigger, 0 if not periodic DMA
+ * 	-shareable: consumers may link off its DMA channel
+ * 	-divch: divider channel of the linked consumer, RES_NONE if none
+ *****************************************************/
+typedef struct{
+	const INT8C *owner;
+	INT32U period;
+	INT8U shareable;
+	INT8U divch;
+}RES_PIT_T;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static RES_PIT_T resPit[RES_PIT_CHANNELS] = {
+	{0, 0u, 0u, RES_NONE}, {0, 0u, 0u, RES_NONE}, {0, 0u, 0u, RES_NONE}, {0, 0u, 0u, RES_NONE}
+};
+static const INT8C *resDma[RES_DMA_CHANNELS];
+static const INT8C *resMux[RES_MUX_SOURCES];
+static RES_DMA_ISR_T resDmaIsr[RES_DMA_CHANNELS];
+static INT32U resDivDummy; //source and destination of the divider channel moves
+
+static const INT8C resPitStrg[] = "PIT";
+static const INT8C resDmaStrg[] = "DMA";
+static const INT8C resMuxStrg[] = "MUX";
+static const INT8C resSepStrg[] = " : ";
+static const INT8C resDivStrg[] = "divider";
+static const INT8C resPeriodStrg[] = " period ";
+static const INT8C resLineStrg[] = "\r\n";
+static const INT8C resFailStrg[] = " : allocation failed, halted";
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT8U ResDmaTake(INT8U first, INT8U last, const INT8C *owner);
+static INT8U ResBaseFits(INT8U base);
+static void ResReportLine(const INT8C *kind, INT8U num, const INT8C *owner);
+static void ResDmaVector(INT8U vector);
+void DMA0_DMA16_IRQHandler(void);
+void DMA1_DMA17_IRQHandler(void);
+void DMA2_DMA18_IRQHandler(void);
+void DMA3_DMA19_IRQHandler(void);
+void DMA4_DMA20_IRQHandler(void);
+void DMA5_DMA21_IRQHandler(void);
+void DMA6_DMA22_IRQHandler(void);
+void DMA7_DMA23_IRQHandler(void);
+void DMA8_DMA24_IRQHandler(void);
+void DMA9_DMA25_IRQHandler(void);
+void DMA10_DMA26_IRQHandler(void);
+void DMA11_DMA27_IRQHandler(void);
+void DMA12_DMA28_IRQHandler(void);
+void DMA13_DMA29_IRQHandler(void);
+void DMA14_DMA30_IRQHandler(void);
+void DMA15_DMA31_IRQHandler(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * ResPitAlloc() - Take the highest free PIT channel.
+ *
+ * 	Parameters: owner - name shown in the report
+ * 	Returns: PIT channel or RES_NONE
+ ******************************************************************************/
+INT8U ResPitAlloc(const INT8C *owner){
+	INT8U ch = RES_PIT_CHANNELS;
+	INT8U pit = RES_NONE;
+
+	while((ch > 0u) && (pit == RES_NONE)){
+		ch--;
+		if(resPit[ch].owner == 0){
+			resPit[ch].owner = owner;
+			pit = ch;
+		}
+		else{}
+	}
+	if(pit != RES_NONE){
+		SIM->SCGC6 |= SIM_SCGC6_PIT(1);
+		PIT->MCR = PIT_MCR_MDIS(0);
+	}
+	else{}
+	return pit;
+}
+
+/*****************************************************************************
+ * ResDmaAlloc() - Take a free DMA channel, the PIT triggerable ones last.
+ *
+ * 	Parameters: owner - name shown in the report
+ * 	Returns: DMA channel or RES_NONE
+ ******************************************************************************/
+INT8U ResDmaAlloc(const INT8C *owner){
+	INT8U ch;
+	ch = ResDmaTake(RES_PIT_CHANNELS, RES_DMA_CHANNELS, owner);
+	if(ch == RES_NONE){
+		ch = ResDmaTake(0u, RES_PIT_CHANNELS, owner);
+	}
+	else{}
+	return ch;
+}
+
+/*****************************************************************************
+ * ResMuxClaim() - Claim a DMAMUX request source.
+ *
+ * 	Parameters: source - DMAMUX source number, owner - name shown in the report
+ * 	Returns: TRUE if claimed, FALSE if another module has it
+ ******************************************************************************/
+INT8U ResMuxClaim(INT8U source, const INT8C *owner){
+	INT8U claimed = FALSE;
+	if(source < RES_MUX_SOURCES){
+		if(source >= RES_MUX_ALWAYS_ON){
+			claimed = TRUE;
+		}
+		else if(resMux[source] == 0){
+			resMux[source] = owner;
+			claimed = TRUE;
+		}
+		else{}
+	}
+	else{}
+	return claimed;
+}
+
+/*****************************************************************************
+ * ResPeriodicAlloc() - Allocate a DMA channel started once per period, on a
+ * 						shared PIT when one divides the period.
+ *
+ * 	Parameters: period - bus clocks between starts
+ * 				shareable - TRUE to let later consumers link off this channel
+ * 				owner - name shown in the report
+ * 				periodic - filled with the assignment
+ * 	Returns: TRUE on success, FALSE if out of channels
+ ******************************************************************************/
+INT8U ResPeriodicAlloc(INT32U period, INT8U shareable, const INT8C *owner, RES_PERIODIC_T *periodic){
+	INT8U ch;
+	INT8U done = FALSE;
+
+	periodic->pit = RES_NONE;
+	periodic->dmach = RES_NONE;
+	periodic->divch = RES_NONE;
+	periodic->mult = 1u;
+
+	//share a running base whose period divides this one//
+	for(ch = 0u; (ch < RES_PIT_CHANNELS) && (done == FALSE); ch++){
+		if((resPit[ch].shareable == TRUE) && (resPit[ch].divch == RES_NONE) &&
+		   (resPit[ch].period != 0u) && ((period % resPit[ch].period) == 0u) &&
+		   ((period / resPit[ch].period) <= RES_CITER_MAX) && (ResBaseFits(ch) == TRUE)){
+			periodic->divch = ResDmaAlloc(resDivStrg);
+			if(periodic->divch != RES_NONE){
+				periodic->dmach = ResDmaAlloc(owner);
+				if(periodic->dmach != RES_NONE){
+					periodic->pit = ch;
+					periodic->mult = (INT16U)(period / resPit[ch].period);
+					resPit[ch].divch = periodic->divch;
+					done = TRUE;
+				}
+				else{ //give the divider back, try an owned pair
+					resDma[periodic->divch] = 0;
+					periodic->divch = RES_NONE;
+				}
+			}
+			else{}
+		}
+		else{}
+	}
+
+	//otherwise own a PIT n / DMA n pair//
+	for(ch = 0u; (ch < RES_PIT_CHANNELS) && (done == FALSE); ch++){
+		if((resPit[ch].owner == 0) && (resDma[ch] == 0)){
+			resPit[ch].owner = owner;
+			resPit[ch].period = period;
+			resPit[ch].shareable = shareable;
+			resDma[ch] = owner;
+			periodic->pit = ch;
+			periodic->dmach = ch;
+			periodic->divch = RES_NONE;
+
+			SIM->SCGC6 |= SIM_SCGC6_PIT(1) | SIM_SCGC6_DMAMUX_MASK;
+			SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+			PIT->MCR = PIT_MCR_MDIS(0);
+			PIT->CHANNEL[ch].TCTRL = 0u;
+			PIT->CHANNEL[ch].LDVAL = period - 1u;
+			DMAMUX->CHCFG[ch] = DMAMUX_CHCFG_ENBL(1) | DMAMUX_CHCFG_TRIG(1) | DMAMUX_CHCFG_SOURCE(RES_DMA_PIT_SOURCE);
+			done = TRUE;
+		}
+		else{}
+	}
+	return done;
+}
+
+/*****************************************************************************
+ * ResPeriodicLink() - Program the divider channel and add the links to the
+ * 					   base channel's TCD.
+ *
+ * 	Parameters: periodic - assignment from ResPeriodicAlloc()
+ * 	Returns: FALSE if the base's major loop count no longer fits the link
+ * 			 field, nothing is linked then.  TRUE otherwise.
+ ******************************************************************************/
+INT8U ResPeriodicLink(const RES_PERIODIC_T *periodic){
+	INT8U base;
+	INT16U citer;
+	INT8U linked = TRUE;
+
+	if((periodic->divch != RES_NONE) && (ResBaseFits(periodic->pit) == FALSE)){
+		linked = FALSE;
+	}
+	else if(periodic->divch != RES_NONE){
+		base = periodic->pit;
+
+		//divider: mult dummy moves, then start the consumer//
+		DMA0->TCD[periodic->divch].SADDR = DMA_SADDR_SADDR(&resDivDummy);
+		DMA0->TCD[periodic->divch].SOFF = DMA_SOFF_SOFF(0);
+		DMA0->TCD[periodic->divch].ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+		DMA0->TCD[periodic->divch].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(RES_DIV_BYTES);
+		DMA0->TCD[periodic->divch].SLAST = DMA_SLAST_SLAST(0);
+		DMA0->TCD[periodic->divch].DADDR = DMA_DADDR_DADDR(&resDivDummy);
+		DMA0->TCD[periodic->divch].DOFF = DMA_DOFF_DOFF(0);
+		DMA0->TCD[periodic->divch].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(periodic->mult);
+		DMA0->TCD[periodic->divch].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(periodic->mult);
+		DMA0->TCD[periodic->divch].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+		DMA0->TCD[periodic->divch].CSR = DMA_CSR_MAJORELINK(1) | DMA_CSR_MAJORLINKCH(periodic->dmach);
+
+		//base: every minor loop and the major loop start the divider//
+		citer = DMA0->TCD[base].BITER_ELINKNO & DMA_BITER_ELINKYES_BITER_MASK;
+		DMA0->TCD[base].CITER_ELINKYES = DMA_CITER_ELINKYES_ELINK(1) | DMA_CITER_ELINKYES_LINKCH(periodic->divch) | DMA_CITER_ELINKYES_CITER(citer);
+		DMA0->TCD[base].BITER_ELINKYES = DMA_BITER_ELINKYES_ELINK(1) | DMA_BITER_ELINKYES_LINKCH(periodic->divch) | DMA_BITER_ELINKYES_BITER(citer);
+		DMA0->TCD[base].CSR = (DMA0->TCD[base].CSR & ~DMA_CSR_MAJORLINKCH_MASK) | DMA_CSR_MAJORELINK(1) | DMA_CSR_MAJORLINKCH(periodic->divch);
+	}
+	else{}
+	return linked;
+}
+
+/*****************************************************************************
+ * ResDmaIsrSet() - Set or remove a DMA channel's interrupt handler.
+ *
+ * 	Parameters: dmach - allocated DMA channel
+ * 				isr - handler, 0 to remove it
+ * 	Returns: none
+ ******************************************************************************/
+void ResDmaIsrSet(INT8U dmach, RES_DMA_ISR_T isr){
+	IRQn_Type irq = (IRQn_Type)((INT32U)DMA0_DMA16_IRQn + (dmach % RES_DMA_VECTORS));
+	INT8U pair = (INT8U)((dmach + RES_DMA_VECTORS) % RES_DMA_CHANNELS);
+
+	if(dmach < RES_DMA_CHANNELS){
+		resDmaIsr[dmach] = isr;
+		if(isr != 0){
+			NVIC_EnableIRQ(irq);
+		}
+		else if(resDmaIsr[pair] == 0){
+			NVIC_DisableIRQ(irq);
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * ResReport() - Print every PIT, DMA channel and DMAMUX source in use.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void ResReport(void){
+	INT8U ch;
+	for(ch = 0u; ch < RES_PIT_CHANNELS; ch++){
+		if(resPit[ch].owner != 0){
+			ResReportLine(resPitStrg, ch, resPit[ch].owner);
+			if(resPit[ch].period != 0u){
+				BIOPutStrg(resPeriodStrg);
+				BIOOutDecWord(resPit[ch].period, RES_DEC_FIELD);
+			}
+			else{}
+		}
+		else{}
+	}
+	for(ch = 0u; ch < RES_DMA_CHANNELS; ch++){
+		if(resDma[ch] != 0){
+			ResReportLine(resDmaStrg, ch, resDma[ch]);
+		}
+		else{}
+	}
+	for(ch = 0u; ch < RES_MUX_SOURCES; ch++){
+		if(resMux[ch] != 0){
+			ResReportLine(resMuxStrg, ch, resMux[ch]);
+		}
+		else{}
+	}
+	BIOPutStrg(resLineStrg);
+}
+
+/*****************************************************************************
+ * ResFail() - Print the owner that couldn't get its channels and the table as
+ * 			   it stands, then halt with interrupts off.  Nothing a module set
+ * 			   up with a channel it didn't get can be trusted to run.
+ *
+ * 	Parameters: owner - name of the module whose allocation failed
+ * 	Returns: never
+ ******************************************************************************/
+void ResFail(const INT8C *owner){
+	BIOPutStrg(resLineStrg);
+	BIOPutStrg(owner);
+	BIOPutStrg(resFailStrg);
+	ResReport();
+	__disable_irq();
+	while(1){ //error trap
+		__WFI();
+	}
+}
+
+/*****************************************************************************
+ * ResDmaTake() - Take the first free DMA channel in [first, last).
+ ******************************************************************************/
+static INT8U ResDmaTake(INT8U first, INT8U last, const INT8C *owner){
+	INT8U ch;
+	INT8U dmach = RES_NONE;
+	for(ch = first; (ch < last) && (dmach == RES_NONE); ch++){
+		if(resDma[ch] == 0){
+			resDma[ch] = owner;
+			dmach = ch;
+		}
+		else{}
+	}
+	if(dmach != RES_NONE){
+		SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+		SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+	}
+	else{}
+	return dmach;
+}
+
+/*****************************************************************************
+ * ResBaseFits() - TRUE if the base channel's major loop count fits the 9 bit
+ * 				   count left when minor loop linking is turned on.  The base
+ * 				   channel is the PIT's own DMA channel.
+ ******************************************************************************/
+static INT8U ResBaseFits(INT8U base){
+	INT8U fits = FALSE;
+	if((DMA0->TCD[base].BITER_ELINKNO & DMA_BITER_ELINKNO_BITER_MASK) <= RES_LINK_CITER_MAX){
+		fits = TRUE;
+	}
+	else{}
+	return fits;
+}
+
+/*****************************************************************************
+ * ResReportLine() - Print "<kind><num> : <owner>" on a new line.
+ ******************************************************************************/
+static void ResReportLine(const INT8C *kind, INT8U num, const INT8C *owner){
+	BIOPutStrg(resLineStrg);
+	BIOPutStrg(kind);
+	BIOOutDecWord(num, RES_DEC_FIELD);
+	BIOPutStrg(resSepStrg);
+	BIOPutStrg(owner);
+}
+
+/*****************************************************************************
+ * ResDmaVector() - Run the handlers of the two channels on a vector whose
+ * 					INT flags are set.
+ ******************************************************************************/
+static void ResDmaVector(INT8U vector){
+	INT8U ch;
+	INT32U flag;
+	for(ch = vector; ch < RES_DMA_CHANNELS; ch += RES_DMA_VECTORS){
+		flag = DMA0->INT & ((INT32U)1u << ch);
+		if((flag != 0u) && (resDmaIsr[ch] != 0)){
+			resDmaIsr[ch]();
+		}
+		else if(flag != 0u){ //no handler, don't let the flag hold the vector pending
+			DMA0->CINT = DMA_CINT_CINT(ch);
+		}
+		else{}
+	}
+}
+
+/************************************************************************
+ * DMAn_DMAn+16_IRQHandler() - The DMA vectors, each serves two channels.
+ ************************************************************************/
+void DMA0_DMA16_IRQHandler(void){ ResDmaVector(0u); }
+void DMA1_DMA17_IRQHandler(void){ ResDmaVector(1u); }
+void DMA2_DMA18_IRQHandler(void){ ResDmaVector(2u); }
+void DMA3_DMA19_IRQHandler(void){ ResDmaVector(3u); }
+void DMA4_DMA20_IRQHandler(void){ ResDmaVector(4u); }
+void DMA5_DMA21_IRQHandler(void){ ResDmaVector(5u); }
+void DMA6_DMA22_IRQHandler(void){ ResDmaVector(6u); }
+void DMA7_DMA23_IRQHandler(void){ ResDmaVector(7u); }
+void DMA8_DMA24_IRQHandler(void){ ResDmaVector(8u); }
+void DMA9_DMA25_IRQHandler(void){ ResDmaVector(9u); }
+void DMA10_DMA26_IRQHandler(void){ ResDmaVector(10u); }
+void DMA11_DMA27_IRQHandler(void){ ResDmaVector(11u); }
+void DMA12_DMA28_IRQHandler(void){ ResDmaVector(12u); }
+void DMA13_DMA29_IRQHandler(void){ ResDmaVector(13u); }
+void DMA14_DMA30_IRQHandler(void){ ResDmaVector(14u); }
+void DMA15_DMA31_IRQHandler(void){ ResDmaVector(15u); }
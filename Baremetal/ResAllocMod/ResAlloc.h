@@ -0,0 +1,107 @@
+/*******************************************************************************
+* ResAlloc.h - Header for the PIT/DMA resource allocator.  Modules ask for PIT
+* 			   channels, DMA channels and DMAMUX sources at init instead of
+* 			   hard-coding them, and ResReport() prints who got what.  The
+* 			   DMA interrupt vectors are owned here too, since an allocated
+* 			   channel's vector isn't known until run time.
+*
+*******************************************************************************/
+
+#ifndef RESALLOC_H_
+#define RESALLOC_H_
+
+#define RES_NONE 0xffu // returned when no channel is free
+#define RES_PIT_CHANNELS 4u
+#define RES_DMA_CHANNELS 32u
+#define RES_MUX_SOURCES 64u
+#define RES_MUX_ALWAYS_ON 58u // DMAMUX sources 58-63 are always enabled and may be shared
+#define RES_DMA_VECTORS 16u // DMAn_DMAn+16 share a vector
+
+/*****************************************************
+ * RES_PERIODIC_T - a DMA channel started once per period.
+ *
+ * 	-pit: PIT channel generating the base period
+ * 	-dmach: DMA channel to configure, started every period
+ * 	-divch: divider channel between the base and dmach when
+ * 			the PIT is shared, RES_NONE when it is owned
+ * 	-mult: period as a multiple of the base PIT period
+ *****************************************************/
+typedef struct{
+	INT8U pit;
+	INT8U dmach;
+	INT8U divch;
+	INT16U mult;
+}RES_PERIODIC_T;
+
+/*****************************************************
+ * RES_DMA_ISR_T - handler for one DMA channel's interrupt,
+ * 	called from the shared vector when its INT flag is set.
+ * 	It clears its own flag with DMA0->CINT.
+ *****************************************************/
+typedef void (*RES_DMA_ISR_T)(void);
+
+/*****************************************************
+ * Allocate a PIT channel, RES_NONE if none free.  PITs are
+ * handed out from the top so PIT0-3/DMA0-3 pairs stay free
+ * for periodic DMA.
+ *****************************************************/
+INT8U ResPitAlloc(const INT8C *owner);
+
+/*****************************************************
+ * Allocate a DMA channel, RES_NONE if none free.  Channels
+ * 4 and up are used first, 0-3 are the PIT triggered ones.
+ *****************************************************/
+INT8U ResDmaAlloc(const INT8C *owner);
+
+/*****************************************************
+ * Claim a DMAMUX request source.  Returns TRUE if it was
+ * free or is an always enabled source, FALSE otherwise.
+ *****************************************************/
+INT8U ResMuxClaim(INT8U source, const INT8C *owner);
+
+/*****************************************************
+ * Allocate a DMA channel started every period bus clocks.
+ * An existing shareable PIT whose period divides period
+ * is reused through a divider channel, otherwise a PIT n /
+ * DMA n pair is taken.  For an owned pair the PIT is loaded
+ * and the DMAMUX routed but the PIT is not started.
+ * shareable allows later consumers to link off this one;
+ * the owner must write its TCD before a consumer allocates,
+ * its major loop count must fit 9 bits and the TCD must not
+ * be rewritten after a consumer links.  A consumer's period
+ * may be up to 32767 base periods.
+ * Returns TRUE on success.
+ *****************************************************/
+INT8U ResPeriodicAlloc(INT32U period, INT8U shareable, const INT8C *owner, RES_PERIODIC_T *periodic);
+
+/*****************************************************
+ * Link a shared periodic consumer to its base channel,
+ * called after the owner and the consumer have written
+ * their TCDs; the consumer starts with the base's next
+ * period.  Does nothing for an owned PIT.  Returns FALSE,
+ * linking nothing, if the base's major loop count has
+ * grown past 9 bits since the allocation.
+ *****************************************************/
+INT8U ResPeriodicLink(const RES_PERIODIC_T *periodic);
+
+/*****************************************************
+ * Set the interrupt handler of an allocated DMA channel and
+ * enable its vector.  isr 0 removes the handler, and the
+ * vector is disabled when neither channel sharing it has
+ * one.  A flag set on a channel with no handler is cleared.
+ *****************************************************/
+void ResDmaIsrSet(INT8U dmach, RES_DMA_ISR_T isr);
+
+/*****************************************************
+ * Print the assignment table over BasicIO
+ *****************************************************/
+void ResReport(void);
+
+/*****************************************************
+ * For an init whose allocation returned RES_NONE or
+ * FALSE: print owner and the table over BasicIO, then
+ * halt with interrupts off.  Never returns.
+ *****************************************************/
+void ResFail(const INT8C *owner);
+
+#endif
@@ -0,0 +1,163 @@
+/********************************************************************************
+* Evt - Priority event dispatcher.  Pending events are bits of evtPending, bit n
+* 		event n, so finding the highest priority one is a scan for the lowest set
+* 		bit and posting is one OR under a short interrupt mask.  Each event is
+* 		stamped with SchedStatNow() when it goes pending so the post to dispatch
+* 		latency can be kept, and the time EvtRun() spends asleep goes to
+* 		SchedStatIdle() like the slice waits.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "MK65F18.h"
+#include "Sched.h"
+#include "SchedStat.h"
+#include "Evt.h"
+//////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static const EVT_HANDLER_T *evtHandlers;
+static INT8U evtNumEvents;
+static volatile INT32U evtPending; //bit n set when event n is pending
+static volatile INT32U evtStamp[EVT_MAX]; //SchedStatNow() when posted
+static INT32U evtLatencyMax[EVT_MAX];
+static INT32U evtLastLatency; //of the last event dispatched
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * EvtInit() - Set the handler table and clear every event.
+ *
+ * 	Parameters: handlers - handler of each event, highest priority first
+ * 				nevents - entries in handlers
+ * 	Returns: FALSE if there are too many events
+ ******************************************************************************/
+INT8U EvtInit(const EVT_HANDLER_T *handlers, INT8U nevents){
+	INT8U ok = FALSE;
+	INT8U evt;
+
+	if(nevents <= EVT_MAX){
+		evtHandlers = handlers;
+		evtNumEvents = nevents;
+		evtPending = 0u;
+		for(evt = 0u; evt < nevents; evt++){
+			evtLatencyMax[evt] = 0u;
+		}
+		ok = TRUE;
+	}
+	else{}
+	return(ok);
+}
+
+/*****************************************************************************
+ * EvtPost() - Make an event pending, stamping it if it wasn't already.
+ *
+ * 	Parameters: evt - event number
+ * 	Returns: none
+ ******************************************************************************/
+void EvtPost(INT8U evt){
+	INT32U bit;
+	INT32U primask;
+
+	if(evt < evtNumEvents){
+		bit = (INT32U)1u << evt;
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if((evtPending & bit) == 0u){
+			evtStamp[evt] = SchedStatNow();
+			evtPending |= bit;
+		}
+		else{}
+		__set_PRIMASK(primask);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * EvtDispatchOne() - Take the highest priority pending event off evtPending
+ * 					  and call its handler.
+ *
+ * 	Parameters: none
+ * 	Returns: FALSE if nothing was pending
+ ******************************************************************************/
+INT8U EvtDispatchOne(void){
+	INT8U evt = 0u;
+	INT32U pending;
+	INT8U found = FALSE;
+	INT32U primask;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	pending = evtPending;
+	if(pending != 0u){
+		while((pending & 1u) == 0u){
+			pending >>= 1;
+			evt++;
+		}
+		evtPending &= ~((INT32U)1u << evt);
+		found = TRUE;
+	}
+	else{}
+	__set_PRIMASK(primask);
+
+	if(found == TRUE){
+		evtLastLatency = SchedStatNow() - evtStamp[evt];
+		if(evtLastLatency > evtLatencyMax[evt]){
+			evtLatencyMax[evt] = evtLastLatency;
+		}
+		else{}
+		evtHandlers[evt]();
+	}
+	else{}
+	return(found);
+}
+
+/*****************************************************************************
+ * EvtRun() - Dispatch until nothing is pending, then WFI.  Interrupts are
+ * 			  masked around the check so a post between the check and WFI
+ * 			  still wakes it.
+ *
+ * 	Parameters: none
+ * 	Returns: never
+ ******************************************************************************/
+void EvtRun(void){
+	INT32U awakestart = SchedStatNow();
+	INT32U sleepstart;
+	INT32U woke;
+
+	while(1){
+		if(evtPending == 0u){
+			sleepstart = SchedStatNow();
+			__disable_irq();
+			while(evtPending == 0u){
+				__WFI();
+				__enable_irq(); //take the interrupt that woke us
+				__disable_irq();
+			}
+			__enable_irq();
+			woke = SchedStatNow();
+			(void)EvtDispatchOne();
+			SchedStatIdle(woke - sleepstart, sleepstart - awakestart, evtLastLatency);
+			awakestart = woke;
+		}
+		else{
+			(void)EvtDispatchOne();
+		}
+	}
+}
+
+/*****************************************************************************
+ * EvtLatencyMaxGet() - Longest post to dispatch time.
+ *
+ * 	Parameters: evt - event number
+ * 	Returns: cycles, 0 for an event past the table
+ ******************************************************************************/
+INT32U EvtLatencyMaxGet(INT8U evt){
+	INT32U latency = 0u;
+
+	if(evt < evtNumEvents){
+		latency = evtLatencyMax[evt];
+	}
+	else{}
+	return(latency);
+}
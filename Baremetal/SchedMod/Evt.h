@@ -0,0 +1,46 @@
+/*******************************************************************************
+* Evt.h - Header for the event dispatcher.  ISRs, timers and handlers post
+* 		  events; EvtRun() calls the handler of the highest priority pending
+* 		  event, lets it run to completion, and sleeps with WFI when nothing
+* 		  is pending.  Events are flags: posting one already pending does not
+* 		  queue a second call.
+*
+*******************************************************************************/
+
+#ifndef EVT_H_
+#define EVT_H_
+
+#define EVT_MAX 32u // events, one pending bit each
+
+typedef void (*EVT_HANDLER_T)(void);
+
+/*****************************************************
+ * Set the handler table, handlers[n] for event n.  Event
+ * 0 has the highest priority.  The table must stay in
+ * memory.  Returns FALSE for more than EVT_MAX events.
+ *****************************************************/
+INT8U EvtInit(const EVT_HANDLER_T *handlers, INT8U nevents);
+
+/*****************************************************
+ * Make an event pending.  Safe from ISRs and handlers.
+ *****************************************************/
+void EvtPost(INT8U evt);
+
+/*****************************************************
+ * Call the handler of the highest priority pending
+ * event.  Returns FALSE if nothing was pending.
+ *****************************************************/
+INT8U EvtDispatchOne(void);
+
+/*****************************************************
+ * Dispatch forever, sleeping when nothing is pending.
+ * Never returns.
+ *****************************************************/
+void EvtRun(void);
+
+/*****************************************************
+ * Longest post to dispatch time of an event, cycles.
+ *****************************************************/
+INT32U EvtLatencyMaxGet(INT8U evt);
+
+#endif /* EVT_H_ */
@@ -0,0 +1,328 @@
+/********************************************************************************
+* Sched - Table driven time slice scheduler.  SchedInit() works out the
+* 		  hyperperiod of the task table once and stores, for each of its slices,
+* 		  a bit per task due in that slice.  Each slice SchedRunSlice() then only
+* 		  reads one mask and calls the tasks in it; tasks keep no period counters
+* 		  of their own and tasks not due are never called.  Every call is timed
+* 		  with SchedStatNow(), counted against the task's budget and added to
+* 		  the SchedStat statistics, as is each slice's total, which includes
+* 		  the characters SchedOut sends for the slice.
+*
+* 		  A period that would take the hyperperiod past SCHED_HYPER_MAX, a
+* 		  minute or a baseline pass, is laid out at its largest divisor that
+* 		  doesn't, its base, and the scheduler keeps a countdown for the task
+* 		  so only every period/base-th of its slot bits calls it.  A task with
+* 		  a short period has a base of its period and a countdown that stays 0.
+*
+* 		  Slices are timed by LPTMR0 on OSCERCLK, the crystal, divided by 256
+* 		  rather than on the LPO, an untrimmed RC that can be off by half.  Its
+* 		  compare is set, each time it matches, to the gap to the next slice with
+* 		  a task due, taken from schedGaps[], so empty slices cost no interrupt
+* 		  at all.  A gap is at most SCHED_GAP_MAX slices, what the 16 bit compare
+* 		  holds; a longer one matches on an empty slice on the way.  In between
+* 		  SchedWaitSlice() sleeps with WFI; device interrupts still wake it and it
+* 		  goes back to sleep until the compare has matched.  SysTick would wake it
+* 		  every mS., so a project stops it once its start up delays are done.
+* 		  A project that sleeps elsewhere, in the Evt dispatcher, instead passes
+* 		  SchedStart() a function the match interrupt calls to post the slice.
+* 		  The interrupt counts the slots it makes due rather than setting a flag,
+* 		  so a slot whose predecessor is still running when it matches waits its
+* 		  turn and is run late instead of being lost.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "MK65F18.h"
+#include "Sched.h"
+#include "SchedStat.h"
+#include "SchedOut.h"
+//////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static const SCHED_TASK_T *schedTasks;
+static INT8U schedNumTasks;
+static INT16U schedHyper; //hyperperiod, slices
+static INT16U schedSlot; //slice of the hyperperiod being run
+static INT16U schedSlots[SCHED_HYPER_MAX]; //bit n set when task n is due
+static INT32U schedOverruns[SCHED_MAX_TASKS];
+static INT8U schedGaps[SCHED_HYPER_MAX]; //slices from a slot to the next slot with a task due
+static INT16U schedBase[SCHED_MAX_TASKS]; //slices between a task's slot bits, divides its period
+static INT16U schedSkips[SCHED_MAX_TASKS]; //slot bits per call, period/base
+static INT16U schedCount[SCHED_MAX_TASKS]; //slot bits left to pass before the next call
+
+static INT16U schedNextSlot; //slot the next compare match makes due
+static INT16U schedRunSlot; //oldest slot made due and not yet run
+static INT32U schedSliceNum; //slices from SchedStart() to the slot being run
+static INT32U schedRunSliceNum; //slices from SchedStart() to schedRunSlot
+static volatile INT16U schedPending; //slots made due and not yet run
+static volatile INT32U schedWakeStamp; //SchedStatNow() at the match
+static INT32U schedAwakeStart; //SchedStatNow() at the end of the last wait
+static void (*schedOnSlice)(void); //called from the match interrupt, 0 none
+////////////////////////////////////////////////////////////////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SCHED_OSCER_HZ 16000000u // K65TWR OSC0 crystal
+#define SCHED_LPTMR_PRESCALE 7u // divide by 2^(7+1), 62.5 kHz.
+#define SCHED_LPTMR_SLICE ((SCHED_OSCER_HZ/(2u << SCHED_LPTMR_PRESCALE))/(1000u/SCHED_SLICE_MS)) // counts per slice
+#define SCHED_GAP_MAX (0x10000u/SCHED_LPTMR_SLICE) // 104 slices, as many as the 16 bit CMR holds
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT32U SchedGcd(INT32U a, INT32U b);
+static void SchedAdvance(void);
+void LPTMR0_IRQHandler(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SchedInit() - Check the table, pick each task's base, find the hyperperiod
+ * 				 and fill schedSlots.  A task is due at the slots where its
+ * 				 phase falls modulo the base, and its countdown starts at the
+ * 				 number of those to pass before its phase.
+ *
+ * 	Parameters: tasks - task table
+ * 				ntasks - entries in tasks
+ * 	Returns: FALSE if the table can't be scheduled
+ ******************************************************************************/
+INT8U SchedInit(const SCHED_TASK_T *tasks, INT8U ntasks){
+	INT32U hyper = 1u;
+	INT32U base;
+	INT8U ok = TRUE;
+	INT8U ind;
+	INT16U slot;
+
+	schedHyper = 0u;
+	if(ntasks > SCHED_MAX_TASKS){
+		ok = FALSE;
+	}
+	else{}
+	for(ind = 0u; (ind < ntasks) && (ok == TRUE); ind++){
+		if((tasks[ind].period == 0u) || (tasks[ind].phase >= tasks[ind].period)){
+			ok = FALSE;
+		}
+		else{
+			base = (tasks[ind].period < SCHED_HYPER_MAX) ? tasks[ind].period : SCHED_HYPER_MAX;
+			while(((tasks[ind].period % base) != 0u) || (((hyper/SchedGcd(hyper, base))*base) > SCHED_HYPER_MAX)){
+				base--; //ends at 1 at the latest, hyper is never over SCHED_HYPER_MAX
+			}
+			hyper = (hyper/SchedGcd(hyper, base))*base;
+			schedBase[ind] = (INT16U)base;
+			schedSkips[ind] = (INT16U)(tasks[ind].period/base);
+			schedCount[ind] = (INT16U)(tasks[ind].phase/base);
+		}
+	}
+
+	if(ok == TRUE){
+		for(slot = 0u; slot < (INT16U)hyper; slot++){
+			schedSlots[slot] = 0u;
+			for(ind = 0u; ind < ntasks; ind++){
+				if((slot % schedBase[ind]) == (tasks[ind].phase % schedBase[ind])){
+					schedSlots[slot] |= (INT16U)(1u << ind);
+				}
+				else{}
+			}
+		}
+		for(slot = 0u; slot < (INT16U)hyper; slot++){
+			schedGaps[slot] = 1u;
+			while((schedGaps[slot] < hyper) && (schedGaps[slot] < SCHED_GAP_MAX)
+					&& (schedSlots[(slot + schedGaps[slot]) % hyper] == 0u)){
+				schedGaps[slot]++;
+			}
+		}
+		for(ind = 0u; ind < ntasks; ind++){
+			schedOverruns[ind] = 0u;
+		}
+		schedTasks = tasks;
+		schedNumTasks = ntasks;
+		schedSlot = 0u;
+		schedNextSlot = 0u;
+		schedRunSlot = 0u;
+		schedSliceNum = 0u;
+		schedRunSliceNum = 0u;
+		schedPending = 0u;
+		schedHyper = (INT16U)hyper;
+		SchedStatInit(ntasks);
+		SchedOutInit();
+	}
+	else{}
+	return(ok);
+}
+
+/*****************************************************************************
+ * SchedStart() - Start LPTMR0 for the first slice.
+ *
+ * 	Parameters: onslice - called from LPTMR0_IRQHandler() after each due slot
+ * 						  is set, 0 when SchedWaitSlice() is used
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStart(void (*onslice)(void)){
+	schedOnSlice = onslice;
+	SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+	OSC->CR |= OSC_CR_ERCLKEN_MASK; //OSC0 already runs the PLL, pass it to LPTMR0 too
+	LPTMR0->CSR = 0u;
+	LPTMR0->PSR = LPTMR_PSR_PCS(3) | LPTMR_PSR_PRESCALE(SCHED_LPTMR_PRESCALE); //OSCERCLK/256
+	LPTMR0->CMR = LPTMR_CMR_COMPARE(SCHED_LPTMR_SLICE - 1u);
+	LPTMR0->CSR = LPTMR_CSR_TIE_MASK | LPTMR_CSR_TCF_MASK; //counter resets on every match
+	NVIC_ClearPendingIRQ(LPTMR0_IRQn);
+	NVIC_EnableIRQ(LPTMR0_IRQn);
+	LPTMR0->CSR |= LPTMR_CSR_TEN_MASK;
+	schedAwakeStart = SchedStatNow();
+}
+
+/*****************************************************************************
+ * SchedWaitSlice() - WFI until LPTMR0_IRQHandler() has made a slot due, then
+ * 					  record the time asleep and the wake to dispatch latency.
+ * 					  Interrupts are masked around the check so a match between
+ * 					  the check and WFI still wakes it.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void SchedWaitSlice(void){
+	INT32U sleepstart = SchedStatNow();
+	INT32U now;
+
+	__disable_irq();
+	while(schedPending == 0u){
+		__WFI();
+		__enable_irq(); //take the interrupt that woke us
+		__disable_irq();
+	}
+	__enable_irq();
+	now = SchedStatNow();
+	SchedStatIdle(now - sleepstart, sleepstart - schedAwakeStart, now - schedWakeStamp);
+	schedAwakeStart = now;
+}
+
+/*****************************************************************************
+ * SchedRunSlice() - Call the tasks in the mask of the oldest slot made due and
+ * 					 not yet run, then queue a line of any statistics dump and
+ * 					 send the next few queued characters.  The dump and send
+ * 					 are timed into the slice total like the tasks.  Slots are run one a call, in
+ * 					 order, so none is skipped when the CPU falls behind; one
+ * 					 run after the match of the slot following it counts as
+ * 					 late, and if more are pending the slice is posted again
+ * 					 through onslice so higher priority events go between.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void SchedRunSlice(void){
+	INT16U due;
+	INT8U ind;
+	INT32U start;
+	INT32U cycles;
+	INT32U total = 0u;
+	INT16U pending;
+
+	if((schedHyper != 0u) && (schedPending != 0u)){
+		schedSlot = schedRunSlot;
+		schedSliceNum = schedRunSliceNum;
+		schedRunSliceNum += schedGaps[schedRunSlot];
+		schedRunSlot = (INT16U)((schedRunSlot + schedGaps[schedRunSlot]) % schedHyper);
+		due = schedSlots[schedSlot];
+		for(ind = 0u; due != 0u; ind++){
+			if(((due & 1u) != 0u) && (schedCount[ind] != 0u)){ //long period, not this time
+				schedCount[ind]--;
+			}
+			else if((due & 1u) != 0u){
+				schedCount[ind] = (INT16U)(schedSkips[ind] - 1u);
+				start = SchedStatNow();
+				schedTasks[ind].task();
+				cycles = SchedStatNow() - start;
+				total += cycles;
+				SchedStatTask(ind, cycles);
+				if((schedTasks[ind].budget != 0u) && (cycles > schedTasks[ind].budget)){
+					schedOverruns[ind]++;
+				}
+				else{}
+			}
+			else{}
+			due >>= 1;
+		}
+		start = SchedStatNow();
+		SchedStatDumpNext();
+		SchedOutSend();
+		total += SchedStatNow() - start;
+		__disable_irq();
+		pending = schedPending;
+		schedPending = (INT16U)(pending - 1u);
+		__enable_irq();
+		SchedStatSlice(total, (INT8U)(pending > 1u));
+		if((pending > 1u) && (schedOnSlice != 0)){
+			schedOnSlice();
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SchedHyperperiod() - Hyperperiod in slices.
+ ******************************************************************************/
+INT16U SchedHyperperiod(void){
+	return(schedHyper);
+}
+
+/*****************************************************************************
+ * SchedSliceGet() - Slices from SchedStart() to the slot being run.
+ ******************************************************************************/
+INT32U SchedSliceGet(void){
+	return(schedSliceNum);
+}
+
+/*****************************************************************************
+ * SchedOverrunsGet() - Over budget calls of a task.
+ *
+ * 	Parameters: task - task table index
+ * 	Returns: over budget calls, 0 for an index past the table
+ ******************************************************************************/
+INT32U SchedOverrunsGet(INT8U task){
+	INT32U overruns = 0u;
+
+	if(task < schedNumTasks){
+		overruns = schedOverruns[task];
+	}
+	else{}
+	return(overruns);
+}
+
+/*****************************************************************************
+ * SchedAdvance() - Make schedNextSlot due and move it on by its gap.
+ ******************************************************************************/
+static void SchedAdvance(void){
+	schedNextSlot = (INT16U)((schedNextSlot + schedGaps[schedNextSlot]) % schedHyper);
+	schedPending++;
+}
+
+/*****************************************************************************
+ * LPTMR0_IRQHandler() - A due slot's time has come.  Load the gap to the slot
+ * 						 after it while TCF still allows CMR to be written, then
+ * 						 clear TCF.
+ ******************************************************************************/
+void LPTMR0_IRQHandler(void){
+	INT16U due = schedNextSlot;
+
+	schedWakeStamp = SchedStatNow();
+	LPTMR0->CMR = LPTMR_CMR_COMPARE(((INT32U)schedGaps[due]*SCHED_LPTMR_SLICE) - 1u);
+	LPTMR0->CSR |= LPTMR_CSR_TCF_MASK;
+	SchedAdvance();
+	if(schedOnSlice != 0){
+		schedOnSlice();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SchedGcd() - Greatest common divisor, Euclid.
+ ******************************************************************************/
+static INT32U SchedGcd(INT32U a, INT32U b){
+	INT32U rem;
+
+	while(b != 0u){
+		rem = a % b;
+		a = b;
+		b = rem;
+	}
+	return(a);
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* Sched.h - Header for the table driven time slice scheduler.  The project
+* 			lists its tasks once, each with a period and phase in slices and
+* 			a run time budget, and SchedRunSlice() calls only the tasks due
+* 			in the current slice.  Between due slices SchedWaitSlice() sleeps
+* 			with WFI, the slices timed by LPTMR0 on the crystal rather than a
+* 			periodic tick.
+*
+*******************************************************************************/
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#define SCHED_MAX_TASKS 16u
+#define SCHED_HYPER_MAX 120u // longest hyperperiod, slices, longer periods are counted down
+#define SCHED_CYCLES_PER_US 180u // 180 MHz. core clock from K65TWR_BootClock()
+#define SCHED_US(us) ((us)*SCHED_CYCLES_PER_US) // budget in cycles
+#define SCHED_SLICE_MS 10u
+
+/*****************************************************
+ * SCHED_TASK_T - one task table entry.
+ *
+ * 	-task: called once per period, must return within
+ * 	 its slice
+ * 	-period: slices between calls, 1 every slice, up to
+ * 	 65535
+ * 	-phase: slice of the period it runs in, < period, so
+ * 	 tasks with the same period can be spread out
+ * 	-budget: CPU cycles a call may take, 0 unchecked
+ *****************************************************/
+typedef struct{
+	void (*task)(void);
+	INT16U period;
+	INT16U phase;
+	INT32U budget;
+}SCHED_TASK_T;
+
+/*****************************************************
+ * Build the schedule for a task table: the hyperperiod,
+ * the least common multiple of the periods, and which
+ * tasks are due in each of its slices.  A period that
+ * would take the hyperperiod over SCHED_HYPER_MAX is
+ * split into a divisor laid out in the hyperperiod and
+ * a count of those the scheduler passes between calls.
+ * The table must stay in memory.  Returns FALSE, with
+ * nothing scheduled, for more than SCHED_MAX_TASKS
+ * tasks, a zero period or a phase not below its period.
+ *****************************************************/
+INT8U SchedInit(const SCHED_TASK_T *tasks, INT8U ntasks);
+
+/*****************************************************
+ * Start the slice timer, the first slice of the
+ * hyperperiod due SCHED_SLICE_MS later.  onslice, if
+ * not 0, is called from the timer interrupt each time a
+ * slice falls due, for a project that sleeps in its own
+ * loop and calls SchedRunSlice() on an event instead of
+ * using SchedWaitSlice().
+ *****************************************************/
+void SchedStart(void (*onslice)(void));
+
+/*****************************************************
+ * Sleep until the next slice with a task due.  Slices
+ * with nothing due are skipped without waking the CPU
+ * for them.  Other interrupts still run while waiting.
+ *****************************************************/
+void SchedWaitSlice(void);
+
+/*****************************************************
+ * Call the tasks due in the oldest slice made due and
+ * not yet run, in table order, checking each against
+ * its budget.  Slices the CPU fell behind on are run
+ * late rather than skipped, one a call, and counted;
+ * onslice is called again while any are left.
+ *****************************************************/
+void SchedRunSlice(void);
+
+/*****************************************************
+ * Hyperperiod in slices, 0 before SchedInit().
+ *****************************************************/
+INT16U SchedHyperperiod(void);
+
+/*****************************************************
+ * Slice number of the slot being run, counted in
+ * SCHED_SLICE_MS from the first slice after SchedStart()
+ * whether or not a task was due in the slices between,
+ * so a task can keep time by it.  A slot run late still
+ * reads its own slice number.  Wraps after 497 days.
+ *****************************************************/
+INT32U SchedSliceGet(void);
+
+/*****************************************************
+ * Calls of table entry task that went over its budget.
+ *****************************************************/
+INT32U SchedOverrunsGet(INT8U task);
+
+#endif /* SCHED_H_ */
@@ -0,0 +1,114 @@
+/********************************************************************************
+* SchedOut - Serial output queue.  BIOWrite() waits for the UART, about 1 mS. a
+* 			 character at 9600 baud, so a task printing a line of 50 characters
+* 			 would hold the CPU for five slices.  Tasks queue their text here
+* 			 instead and SchedRunSlice() sends two characters a slice, as many as
+* 			 the UART's data and shift registers take without waiting, about a
+* 			 fifth of the line rate.  The queue is filled from tasks and emptied
+* 			 by SchedRunSlice() in the same thread, so it needs no locking.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "SchedOut.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SCHED_OUT_DEC_DIGITS 10u // 2^32-1
+#define SCHED_OUT_RADIX 10u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static INT8C schedOutBuf[SCHED_OUT_BYTES];
+static INT16U schedOutIn; //next byte to fill
+static INT16U schedOutOut; //next byte to send
+static INT16U schedOutLen; //bytes queued
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void SchedOutPut(INT8C c);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SchedOutInit() - Empty the queue.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void SchedOutInit(void){
+	schedOutIn = 0u;
+	schedOutOut = 0u;
+	schedOutLen = 0u;
+}
+
+/*****************************************************************************
+ * SchedOutFree() - Bytes free in the queue.
+ ******************************************************************************/
+INT16U SchedOutFree(void){
+	return((INT16U)(SCHED_OUT_BYTES - schedOutLen));
+}
+
+/*****************************************************************************
+ * SchedOutPutStrg() - Queue a string.
+ *
+ * 	Parameters: strg - zero terminated
+ * 	Returns: none
+ ******************************************************************************/
+void SchedOutPutStrg(const INT8C *strg){
+	while(*strg != '\0'){
+		SchedOutPut(*strg);
+		strg++;
+	}
+}
+
+/*****************************************************************************
+ * SchedOutDecWord() - Queue a number in decimal with no padding.
+ *
+ * 	Parameters: val - number
+ * 	Returns: none
+ ******************************************************************************/
+void SchedOutDecWord(INT32U val){
+	INT8C digits[SCHED_OUT_DEC_DIGITS];
+	INT8U ndigits = 0u;
+
+	do{
+		digits[ndigits] = (INT8C)('0' + (val % SCHED_OUT_RADIX));
+		val /= SCHED_OUT_RADIX;
+		ndigits++;
+	}while(val != 0u);
+	while(ndigits > 0u){
+		ndigits--;
+		SchedOutPut(digits[ndigits]);
+	}
+}
+
+/*****************************************************************************
+ * SchedOutSend() - Send the next SCHED_OUT_SLICE_CHARS queued characters.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void SchedOutSend(void){
+	INT8U sent = 0u;
+
+	while((schedOutLen != 0u) && (sent < SCHED_OUT_SLICE_CHARS)){
+		BIOWrite(schedOutBuf[schedOutOut]);
+		schedOutOut = (INT16U)((schedOutOut + 1u) % SCHED_OUT_BYTES);
+		schedOutLen--;
+		sent++;
+	}
+}
+
+/*****************************************************************************
+ * SchedOutPut() - Queue one character, dropped if the queue is full.
+ ******************************************************************************/
+static void SchedOutPut(INT8C c){
+	if(schedOutLen < SCHED_OUT_BYTES){
+		schedOutBuf[schedOutIn] = c;
+		schedOutIn = (INT16U)((schedOutIn + 1u) % SCHED_OUT_BYTES);
+		schedOutLen++;
+	}
+	else{}
+}
@@ -0,0 +1,39 @@
+/*******************************************************************************
+* SchedOut.h - Header for the scheduler's serial output queue.  Text from the
+* 			   tasks goes into a RAM ring and SchedRunSlice() sends
+* 			   SCHED_OUT_SLICE_CHARS of it a slice through BasicIO, so a long
+* 			   dump at 9600 baud never holds a slice up.
+*
+*******************************************************************************/
+
+#ifndef SCHEDOUT_H_
+#define SCHEDOUT_H_
+
+#define SCHED_OUT_BYTES 512u // ring size
+#define SCHED_OUT_LINE_MAX 320u // longest line a producer queues at once
+#define SCHED_OUT_SLICE_CHARS 2u // the UART data and shift registers, sent without waiting
+
+/*****************************************************
+ * Empty the queue.
+ *****************************************************/
+void SchedOutInit(void);
+
+/*****************************************************
+ * Bytes free.  A producer waits for SCHED_OUT_LINE_MAX
+ * before queueing a line; what doesn't fit is dropped.
+ *****************************************************/
+INT16U SchedOutFree(void);
+
+/*****************************************************
+ * Queue a string, or a number in decimal, no padding.
+ *****************************************************/
+void SchedOutPutStrg(const INT8C *strg);
+void SchedOutDecWord(INT32U val);
+
+/*****************************************************
+ * Send up to SCHED_OUT_SLICE_CHARS queued characters.
+ * Called by SchedRunSlice() inside the timed slice.
+ *****************************************************/
+void SchedOutSend(void);
+
+#endif /* SCHEDOUT_H_ */
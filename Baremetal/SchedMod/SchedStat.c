@@ -0,0 +1,358 @@
+/********************************************************************************
+* SchedStat - Execution time statistics for Sched.  Per task it keeps calls,
+* 			  min, max, a sum for the average and a log2 histogram; per slice it
+* 			  keeps the longest total and a ring of the slices that went over
+* 			  SCHED_SLICE_CYCLES; per wait it keeps the time asleep and the wake to
+* 			  dispatch latency.  Adding a sample is a few compares and adds and
+* 			  a short shift loop for the bin, so it can stay on in the field build.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include "MCUType.h"
+#include "MK65F18.h"
+#include "Sched.h"
+#include "SchedStat.h"
+#include "SchedOut.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SCHED_STAT_DUMP_IDLE 0xffu
+#define SCHED_STAT_PER_MILLE 1000u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static SCHED_STAT_T schedStats[SCHED_MAX_TASKS];
+static INT8U schedStatTasks;
+static INT32U schedStatSlices;
+static INT32U schedStatOverSlices;
+static INT32U schedStatMaxSlice;
+static INT32U schedStatLateSlices;
+static INT32U schedStatFlagSlice[SCHED_STAT_FLAGS]; //overrun slice numbers, a ring
+static INT32U schedStatFlagCycles[SCHED_STAT_FLAGS];
+static INT64U schedStatAsleep; //cycles in SchedWaitSlice() or EvtRun()
+static INT64U schedStatAwake;
+static SCHED_STAT_T schedStatLatency; //match to dispatch, calls counts the waits
+
+static INT8U schedStatDumpLine = SCHED_STAT_DUMP_IDLE; //next line of the dump
+static INT8U schedStatDumpFlag; //next flag ring line
+
+static const INT8C schedStatTaskStrg[] = "T,";
+static const INT8C schedStatSliceStrg[] = "S,";
+static const INT8C schedStatFlagStrg[] = "O,";
+static const INT8C schedStatIdleStrg[] = "I,";
+static const INT8C schedStatEndStrg[] = "E\r\n";
+static const INT8C schedStatSepStrg[] = ",";
+static const INT8C schedStatLineStrg[] = "\r\n";
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT8U SchedStatBin(INT32U cycles);
+static void SchedStatOut(INT32U val);
+static void SchedStatTaskLine(INT8U task);
+static void SchedStatAdd(SCHED_STAT_T *stat, INT32U cycles);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SchedStatInit() - Clear the statistics and start the cycle counter.
+ *
+ * 	Parameters: ntasks - entries in the task table
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStatInit(INT8U ntasks){
+	SCHED_STAT_T *stat;
+	INT8U ind;
+	INT8U bin;
+
+	for(ind = 0u; ind <= SCHED_MAX_TASKS; ind++){
+		if(ind < SCHED_MAX_TASKS){
+			stat = &schedStats[ind];
+		}
+		else{
+			stat = &schedStatLatency;
+		}
+		stat->calls = 0u;
+		stat->min = 0xffffffffu;
+		stat->max = 0u;
+		stat->sum = 0u;
+		for(bin = 0u; bin < SCHED_STAT_BINS; bin++){
+			stat->hist[bin] = 0u;
+		}
+	}
+	schedStatAsleep = 0u;
+	schedStatAwake = 0u;
+	schedStatTasks = ntasks;
+	schedStatSlices = 0u;
+	schedStatOverSlices = 0u;
+	schedStatMaxSlice = 0u;
+	schedStatLateSlices = 0u;
+	schedStatDumpLine = SCHED_STAT_DUMP_IDLE;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; //start the cycle counter
+	DWT->CYCCNT = 0u;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*****************************************************************************
+ * SchedStatNow() - DWT cycle count.
+ ******************************************************************************/
+INT32U SchedStatNow(void){
+	return(DWT->CYCCNT);
+}
+
+/*****************************************************************************
+ * SchedStatTask() - Add one task call.
+ *
+ * 	Parameters: task - task table index
+ * 				cycles - run time
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStatTask(INT8U task, INT32U cycles){
+	if(task < schedStatTasks){
+		SchedStatAdd(&schedStats[task], cycles);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SchedStatIdle() - Add one wait.
+ *
+ * 	Parameters: asleep - cycles in the wait
+ * 				awake - cycles since the wait before
+ * 				latency - cycles from the timer match to the end of the wait
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStatIdle(INT32U asleep, INT32U awake, INT32U latency){
+	schedStatAsleep += asleep;
+	schedStatAwake += awake;
+	SchedStatAdd(&schedStatLatency, latency);
+}
+
+/*****************************************************************************
+ * SchedStatAsleepGet() - Time asleep, per mille.
+ ******************************************************************************/
+INT32U SchedStatAsleepGet(void){
+	INT64U total = schedStatAsleep + schedStatAwake;
+	INT32U permille = 0u;
+
+	if(total != 0u){
+		permille = (INT32U)((schedStatAsleep*SCHED_STAT_PER_MILLE)/total);
+	}
+	else{}
+	return(permille);
+}
+
+/*****************************************************************************
+ * SchedStatSlice() - Add one slice, flag it if it overran.
+ *
+ * 	Parameters: cycles - total run time of the slice's tasks
+ * 				late - TRUE if the next slice was already due
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStatSlice(INT32U cycles, INT8U late){
+	INT8U flag;
+
+	if(late == TRUE){
+		schedStatLateSlices++;
+	}
+	else{}
+
+	if(cycles > schedStatMaxSlice){
+		schedStatMaxSlice = cycles;
+	}
+	else{}
+	if(cycles > SCHED_SLICE_CYCLES){
+		flag = (INT8U)(schedStatOverSlices % SCHED_STAT_FLAGS);
+		schedStatFlagSlice[flag] = schedStatSlices;
+		schedStatFlagCycles[flag] = cycles;
+		schedStatOverSlices++;
+	}
+	else{}
+	schedStatSlices++;
+}
+
+/*****************************************************************************
+ * SchedStatGet() - One task's statistics.
+ ******************************************************************************/
+const SCHED_STAT_T *SchedStatGet(INT8U task){
+	const SCHED_STAT_T *stat = 0;
+
+	if(task < schedStatTasks){
+		stat = &schedStats[task];
+	}
+	else{}
+	return(stat);
+}
+
+/*****************************************************************************
+ * SchedStatDumpStart() - Start a dump, restarting one already running.
+ ******************************************************************************/
+void SchedStatDumpStart(void){
+	schedStatDumpLine = 0u;
+	if(schedStatOverSlices > SCHED_STAT_FLAGS){
+		schedStatDumpFlag = (INT8U)(schedStatOverSlices % SCHED_STAT_FLAGS); //oldest in the ring
+	}
+	else{
+		schedStatDumpFlag = 0u;
+	}
+}
+
+/*****************************************************************************
+ * SchedStatDumpNext() - Queue the next line of a dump: the T lines, the S
+ * 						 and I lines, the O lines then E.  Waits for room
+ * 						 for a whole line in the SchedOut queue.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void SchedStatDumpNext(void){
+	INT32U flags = schedStatOverSlices;
+	INT8U line = schedStatDumpLine;
+
+	if(flags > SCHED_STAT_FLAGS){
+		flags = SCHED_STAT_FLAGS;
+	}
+	else{}
+
+	if((line == SCHED_STAT_DUMP_IDLE) || (SchedOutFree() < SCHED_OUT_LINE_MAX)){ //no dump running, or no room yet
+	}
+	else if(line < schedStatTasks){
+		SchedStatTaskLine(line);
+		schedStatDumpLine++;
+	}
+	else if(line == schedStatTasks){
+		SchedOutPutStrg(schedStatSliceStrg);
+		SchedStatOut(schedStatSlices);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatOverSlices);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatMaxSlice);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatLateSlices);
+		SchedOutPutStrg(schedStatLineStrg);
+		schedStatDumpLine++;
+	}
+	else if(line == (schedStatTasks + 1u)){
+		SchedOutPutStrg(schedStatIdleStrg);
+		SchedStatOut(SchedStatAsleepGet());
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatLatency.calls);
+		SchedOutPutStrg(schedStatSepStrg);
+		if(schedStatLatency.calls != 0u){
+			SchedStatOut(schedStatLatency.min);
+			SchedOutPutStrg(schedStatSepStrg);
+			SchedStatOut((INT32U)(schedStatLatency.sum/schedStatLatency.calls));
+		}
+		else{
+			SchedStatOut(0u);
+			SchedOutPutStrg(schedStatSepStrg);
+			SchedStatOut(0u);
+		}
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatLatency.max);
+		SchedOutPutStrg(schedStatLineStrg);
+		schedStatDumpLine++;
+	}
+	else if((INT32U)(line - schedStatTasks - 2u) < flags){
+		SchedOutPutStrg(schedStatFlagStrg);
+		SchedStatOut(schedStatFlagSlice[schedStatDumpFlag]);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(schedStatFlagCycles[schedStatDumpFlag]);
+		SchedOutPutStrg(schedStatLineStrg);
+		schedStatDumpFlag = (INT8U)((schedStatDumpFlag + 1u) % SCHED_STAT_FLAGS);
+		schedStatDumpLine++;
+	}
+	else{
+		SchedOutPutStrg(schedStatEndStrg);
+		schedStatDumpLine = SCHED_STAT_DUMP_IDLE;
+	}
+}
+
+/*****************************************************************************
+ * SchedStatAdd() - Add a time to calls, min, max, sum and histogram.
+ ******************************************************************************/
+static void SchedStatAdd(SCHED_STAT_T *stat, INT32U cycles){
+	stat->calls++;
+	stat->sum += cycles;
+	if(cycles < stat->min){
+		stat->min = cycles;
+	}
+	else{}
+	if(cycles > stat->max){
+		stat->max = cycles;
+	}
+	else{}
+	stat->hist[SchedStatBin(cycles)]++;
+}
+
+/*****************************************************************************
+ * SchedStatBin() - log2 histogram bin of a run time, floor(log2(cycles))
+ * 					limited to the last bin.
+ ******************************************************************************/
+static INT8U SchedStatBin(INT32U cycles){
+	INT8U bin = 0u;
+
+	while((cycles > 1u) && (bin < (SCHED_STAT_BINS - 1u))){
+		cycles >>= 1;
+		bin++;
+	}
+	return(bin);
+}
+
+/*****************************************************************************
+ * SchedStatOut() - Queue a number with no padding.
+ ******************************************************************************/
+static void SchedStatOut(INT32U val){
+	SchedOutDecWord(val);
+}
+
+/*****************************************************************************
+ * SchedStatTaskLine() - Print a T line.
+ ******************************************************************************/
+static void SchedStatTaskLine(INT8U task){
+	const SCHED_STAT_T *stat = &schedStats[task];
+	INT8U first = 0u;
+	INT8U last = 0u;
+	INT8U found = FALSE;
+	INT8U bin;
+
+	for(bin = 0u; bin < SCHED_STAT_BINS; bin++){
+		if(stat->hist[bin] != 0u){
+			if(found == FALSE){
+				first = bin;
+				found = TRUE;
+			}
+			else{}
+			last = bin;
+		}
+		else{}
+	}
+
+	SchedOutPutStrg(schedStatTaskStrg);
+	SchedStatOut(task);
+	SchedOutPutStrg(schedStatSepStrg);
+	SchedStatOut(stat->calls);
+	SchedOutPutStrg(schedStatSepStrg);
+	if(stat->calls != 0u){
+		SchedStatOut(stat->min);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut((INT32U)(stat->sum/stat->calls));
+	}
+	else{
+		SchedStatOut(0u);
+		SchedOutPutStrg(schedStatSepStrg);
+		SchedStatOut(0u);
+	}
+	SchedOutPutStrg(schedStatSepStrg);
+	SchedStatOut(stat->max);
+	SchedOutPutStrg(schedStatSepStrg);
+	SchedStatOut(first);
+	if(found == TRUE){
+		for(bin = first; bin <= last; bin++){
+			SchedOutPutStrg(schedStatSepStrg);
+			SchedStatOut(stat->hist[bin]);
+		}
+	}
+	else{}
+	SchedOutPutStrg(schedStatLineStrg);
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+* SchedStat.h - Header for the scheduler's execution time statistics.  Sched
+* 				times every task call and every slice with SchedStatNow(), the
+* 				DWT cycle counter.  SecuritySim runs it on its DWT model.
+*
+* 	Dump format, one record per line, fields separated by commas:
+* 		T,<task>,<calls>,<min>,<avg>,<max>,<bin>,<count>,...
+* 			times in cycles.  Histogram counts start at log2 bin <bin>, bin
+* 			b holding calls of 2^b to 2^(b+1)-1 cycles, and stop at the last
+* 			non-empty bin.  <bin> is 0 with no counts for a task never called.
+* 		S,<slices>,<overrun slices>,<longest slice>,<late slices>
+* 			late slices started after the timer had made the next one due
+* 		I,<asleep per mille>,<waits>,<min>,<avg>,<max>
+* 			time asleep in SchedWaitSlice() or EvtRun() and the match, or
+* 			event post, to dispatch latency in cycles
+* 		O,<slice>,<cycles>
+* 			one per overrun slice still in the flag ring, oldest first
+* 		E
+*
+*******************************************************************************/
+
+#ifndef SCHEDSTAT_H_
+#define SCHEDSTAT_H_
+
+#define SCHED_STAT_BINS 24u // log2 bins, the last also holds everything longer
+#define SCHED_STAT_FLAGS 8u // overrun slices remembered
+#define SCHED_SLICE_CYCLES (SCHED_SLICE_MS*1000u*SCHED_CYCLES_PER_US)
+
+/*****************************************************
+ * SCHED_STAT_T - one task's statistics, cycles.
+ *****************************************************/
+typedef struct{
+	INT32U calls;
+	INT32U min;
+	INT32U max;
+	INT64U sum;
+	INT32U hist[SCHED_STAT_BINS];
+}SCHED_STAT_T;
+
+/*****************************************************
+ * Clear the statistics for a table of ntasks tasks and
+ * start the cycle counter.
+ *****************************************************/
+void SchedStatInit(INT8U ntasks);
+
+/*****************************************************
+ * Current time in cycles, free running, wraps at 2^32.
+ *****************************************************/
+INT32U SchedStatNow(void);
+
+/*****************************************************
+ * Add one call of task taking cycles.
+ *****************************************************/
+void SchedStatTask(INT8U task, INT32U cycles);
+
+/*****************************************************
+ * Add one slice whose tasks took cycles in total,
+ * flagged if over SCHED_SLICE_CYCLES, and late if it
+ * ran after the next slice was already due.
+ *****************************************************/
+void SchedStatSlice(INT32U cycles, INT8U late);
+
+/*****************************************************
+ * Add one SchedWaitSlice(): cycles asleep, cycles awake
+ * since the wait before and the cycles from the timer
+ * match to the return.
+ *****************************************************/
+void SchedStatIdle(INT32U asleep, INT32U awake, INT32U latency);
+
+/*****************************************************
+ * Time asleep per mille of all time since init.
+ *****************************************************/
+INT32U SchedStatAsleepGet(void);
+
+/*****************************************************
+ * Statistics of a task, 0 for an index past the table.
+ *****************************************************/
+const SCHED_STAT_T *SchedStatGet(INT8U task);
+
+/*****************************************************
+ * Start a dump.  SchedStatDumpNext() queues one line of
+ * it on SchedOut per call, when the queue has room.
+ *****************************************************/
+void SchedStatDumpStart(void);
+void SchedStatDumpNext(void);
+
+#endif /* SCHEDSTAT_H_ */
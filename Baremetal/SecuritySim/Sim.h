@@ -0,0 +1,159 @@
+/*******************************************************************************
+* Sim.h - Internal interface of the security system simulator.  SimCore keeps
+* 		  simulated time and the NVIC, SimPeriph models the K65 peripherals,
+* 		  SimScript plays the scenario and models the sensors, and SimBoard
+* 		  stands in for the external board modules and writes the trace.
+*
+* 		  Time is counted in 180 MHz. core cycles.  It moves on only when the
+* 		  firmware touches a modelled register (SIM_ACCESS_CYCLES each), is
+* 		  charged for a slow board operation such as an LCD write, or sleeps in
+* 		  WFI, which jumps straight to the next hardware or scenario event.
+*
+*******************************************************************************/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+//TIME BASE/////////////////////////////////////////////////////////////////////////////
+typedef INT64U SIM_TIME_T; // core cycles since reset
+
+#define SIM_CORE_HZ 180000000u
+#define SIM_BUS_CYCLES 3u // core cycles per 60 MHz. bus clock
+#define SIM_LPO_CYCLES 180000u // core cycles per 1 kHz. LPO count
+#define SIM_OSCER_HZ 16000000u // OSC0 crystal, OSCERCLK
+#define SIM_US(us) ((SIM_TIME_T)(us)*(SIM_CORE_HZ/1000000u))
+#define SIM_ACCESS_CYCLES 4u // charged per modelled register access
+#define SIM_IRQ_ENTRY_CYCLES 12u // exception entry
+#define SIM_WFI_CYCLES 2u // a WFI that wakes at once
+#define SIM_NEVER 0xffffffffffffffffull
+
+extern SIM_TIME_T SimNow;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//DIRTY FLAGS, PERIPHERALS WITH WRITES STILL TO BE APPLIED//////////////////////////////
+#define SIM_DIRTY_PIT 0x01u
+#define SIM_DIRTY_LPTMR 0x02u
+#define SIM_DIRTY_TSI 0x04u
+#define SIM_DIRTY_DMA 0x08u
+#define SIM_DIRTY_ADC 0x10u
+#define SIM_DIRTY_DAC 0x20u
+#define SIM_DIRTY_SYSTICK 0x40u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//SIMCORE///////////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * One register access by the firmware to a peripheral
+ * with the dirty flag dirty: apply earlier writes,
+ * charge SIM_ACCESS_CYCLES, run what falls due.
+ *****************************************************/
+void SimAccess(INT32U dirty);
+
+/*****************************************************
+ * The firmware is busy for cycles.
+ *****************************************************/
+void SimCharge(SIM_TIME_T cycles);
+
+/*****************************************************
+ * Pend an interrupt, from a peripheral model.
+ *****************************************************/
+void SimIrqPend(IRQn_Type irq);
+
+/*****************************************************
+ * Recompute the next event after a model or the
+ * scenario changed its schedule.
+ *****************************************************/
+void SimReschedule(void);
+
+/*****************************************************
+ * Set the end of the run and start the wall clock.
+ *****************************************************/
+void SimStart(SIM_TIME_T end);
+
+/*****************************************************
+ * Stop: trace the last changes, END and the run
+ * summary, then exit.  SimFail() stops with an error.
+ *****************************************************/
+void SimFinish(void);
+void SimFail(const char *fmt, ...);
+
+/*****************************************************
+ * The firmware's main(), renamed by the build.
+ *****************************************************/
+void SimFirmwareMain(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+//SIMPERIPH/////////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * Apply the firmware writes to the peripherals in
+ * dirty.
+ *****************************************************/
+void SimPeriphSync(INT32U dirty);
+
+/*****************************************************
+ * Earliest pending peripheral event, SIM_NEVER if none.
+ *****************************************************/
+SIM_TIME_T SimPeriphNext(void);
+
+/*****************************************************
+ * Run every peripheral event due at SimNow.
+ *****************************************************/
+void SimPeriphEvent(void);
+
+/*****************************************************
+ * Frequency error of the LPTMR0 count clock against
+ * the core clock, parts per million, + runs fast.
+ *****************************************************/
+void SimLptmrClockErr(INT32S ppm);
+////////////////////////////////////////////////////////////////////////////////////////
+
+//SIMSCRIPT/////////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * Read a scenario file.  Returns the end of the run.
+ *****************************************************/
+SIM_TIME_T SimScriptLoad(const char *path);
+
+/*****************************************************
+ * Time of the next scenario step, SIM_NEVER if none,
+ * and apply every step due at SimNow.
+ *****************************************************/
+SIM_TIME_T SimScriptNext(void);
+void SimScriptEvent(void);
+
+/*****************************************************
+ * Sensor models: the ADC result of a channel and the
+ * TSI count of a channel at SimNow.
+ *****************************************************/
+INT16U SimScriptAdcCode(INT8U adch);
+INT16U SimScriptTsiCount(INT8U tsich);
+////////////////////////////////////////////////////////////////////////////////////////
+
+//SIMBOARD//////////////////////////////////////////////////////////////////////////////
+/*****************************************************
+ * Trace one line stamped with SimNow.
+ *****************************************************/
+void SimTrace(const char *fmt, ...);
+
+/*****************************************************
+ * Trace the LCD lines, LEDs and system state that
+ * changed since the last call.  Called at every WFI.
+ *****************************************************/
+void SimBoardTrace(void);
+
+/*****************************************************
+ * Name of the system state as traced: ARMED, DISARMED
+ * or ALARM.
+ *****************************************************/
+const INT8C *SimBoardState(void);
+
+/*****************************************************
+ * Trace options: LED changes, UART lines.
+ *****************************************************/
+void SimBoardOptions(INT8U leds, INT8U uart);
+
+/*****************************************************
+ * Queue a key press for KeyGet().
+ *****************************************************/
+void SimKeyPush(INT8C key);
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif /* SIM_H_ */
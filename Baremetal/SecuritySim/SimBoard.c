@@ -0,0 +1,368 @@
+/********************************************************************************
+* SimBoard - Stand-ins for the board modules the security system links with,
+* 			 and the trace.
+*
+* 	Trace lines are the simulated time in seconds and what happened:
+*
+* 		LCD1 |ARMED           |		an LCD line that changed
+* 		STATE ALARM					L5mSysState changed
+* 		LED8 on						an LED changed, with -l
+* 		UART text					a line sent on the serial port, unless -q
+* 		SIREN on					from SimPeriph
+* 		SCN touch 1 on				a scenario step, from SimScript
+*
+* 	LCD, state and LED changes are traced when the core goes to sleep, so a
+* 	line rewritten within one slice is traced once, as it would be seen.  The
+* 	LCD is charged its write times, 40 uS. a character and 1.5 mS. to clear a
+* 	line.  The serial port sends 10 bits at 9600 baud a character from a data
+* 	and a shift register, and a write waits only while both are full.  A
+* 	SysTick delay with SysTick stopped, which would never return, fails the run.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "MCUType.h"
+#include "Lab5Main.h"
+#include "BasicIO.h"
+#include "CheckSum.h"
+#include "K65TWR_ClkCfg.h"
+#include "K65TWR_GPIO.h"
+#include "Key.h"
+#include "LCD.h"
+#include "SysTickDelay.h"
+#include "Sim.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SIM_LCD_ROWS 2u
+#define SIM_LCD_COLS 16u
+#define SIM_LCD_CHAR_CYCLES SIM_US(40u)
+#define SIM_LCD_CLR_CYCLES SIM_US(1500u)
+#define SIM_LCD_DEGREE ((INT8C)0xDF)
+#define SIM_UART_LINE_LEN 128u
+#define SIM_UART_CHAR_BITS 10u
+#define SIM_KEY_QUEUE 16u
+#define SIM_LEDS 2u
+#define SIM_DEC_DIGITS 11u
+#define SIM_MS_CYCLES SIM_US(1000u)
+#define SIM_FAKE_CHECKSUM 0u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static INT8C simLcd[SIM_LCD_ROWS][SIM_LCD_COLS];
+static INT8C simLcdShown[SIM_LCD_ROWS][SIM_LCD_COLS]; //as last traced
+static INT8U simLcdRow;
+static INT8U simLcdCol;
+static INT8U simLed[SIM_LEDS];
+static INT8U simLedShown[SIM_LEDS];
+static SYS_STATE_T simStateShown;
+static INT8U simTraced; //first SimBoardTrace() done
+static volatile INT32U simSysTickMs; //SysTick_Handler() count
+static INT8U simTraceLeds;
+static INT8U simTraceUart = 1u;
+static INT8C simUartLine[SIM_UART_LINE_LEN];
+static INT32U simUartLen;
+static SIM_TIME_T simUartCharCycles;
+static SIM_TIME_T simUartTxEnd; //last character written is sent
+static INT8C simKeys[SIM_KEY_QUEUE];
+static INT8U simKeyIn;
+static INT8U simKeyOut;
+static const INT8C *const simStateNames[] = {"ARMED", "DISARMED", "ALARM"};
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void SimLcdTraceLine(INT8U row);
+static void SimDecStrg(INT32U binword, INT8C *strg);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SimTrace() - One trace line, stamped with the simulated time.
+ ******************************************************************************/
+void SimTrace(const char *fmt, ...){
+	va_list args;
+
+	printf("%10llu.%06llu ", SimNow/SIM_CORE_HZ, (SimNow%SIM_CORE_HZ)/(SIM_CORE_HZ/1000000u));
+	va_start(args, fmt);
+	(void)vprintf(fmt, args);
+	va_end(args);
+	(void)putchar('\n');
+}
+
+/*****************************************************************************
+ * SimBoardOptions() - What to trace besides the LCD, state and scenario.
+ *
+ * 	Parameters: leds - trace LED changes
+ * 				uart - trace serial lines
+ * 	Returns: none
+ ******************************************************************************/
+void SimBoardOptions(INT8U leds, INT8U uart){
+	simTraceLeds = leds;
+	simTraceUart = uart;
+}
+
+/*****************************************************************************
+ * SimBoardState() - Name of L5mSysState as traced.
+ ******************************************************************************/
+const INT8C *SimBoardState(void){
+	return(simStateNames[L5mSysState]);
+}
+
+/*****************************************************************************
+ * SimBoardTrace() - Trace the LCD lines, state and LEDs that changed.
+ ******************************************************************************/
+void SimBoardTrace(void){
+	INT8U row;
+	INT8U led;
+
+	for(row = 0u; row < SIM_LCD_ROWS; row++){
+		if(memcmp(simLcd[row], simLcdShown[row], SIM_LCD_COLS) != 0){
+			(void)memcpy(simLcdShown[row], simLcd[row], SIM_LCD_COLS);
+			SimLcdTraceLine(row);
+		}
+		else{}
+	}
+	if((simTraced == 0u) || (L5mSysState != simStateShown)){
+		simStateShown = L5mSysState;
+		SimTrace("STATE %s", simStateNames[simStateShown]);
+	}
+	else{}
+	for(led = 0u; led < SIM_LEDS; led++){
+		if(simLed[led] != simLedShown[led]){
+			simLedShown[led] = simLed[led];
+			if(simTraceLeds != 0u){
+				SimTrace("LED%u %s", led + 8u, (simLed[led] != 0u) ? "on" : "off");
+			}
+			else{}
+		}
+		else{}
+	}
+	simTraced = 1u;
+}
+
+/*****************************************************************************
+ * SimLcdTraceLine() - An LCD line, the degree symbol as it looks.
+ ******************************************************************************/
+static void SimLcdTraceLine(INT8U row){
+	INT8C line[(SIM_LCD_COLS*2u) + 1u];
+	INT8U col;
+	INT32U len = 0u;
+
+	for(col = 0u; col < SIM_LCD_COLS; col++){
+		if(simLcd[row][col] == SIM_LCD_DEGREE){
+			line[len] = (INT8C)0xC2; //UTF-8 degree sign
+			line[len + 1u] = (INT8C)0xB0;
+			len += 2u;
+		}
+		else if((simLcd[row][col] < ' ') || (simLcd[row][col] > '~')){
+			line[len] = '?';
+			len++;
+		}
+		else{
+			line[len] = simLcd[row][col];
+			len++;
+		}
+	}
+	line[len] = '\0';
+	SimTrace("LCD%u |%s|", row + 1u, line);
+}
+
+/*****************************************************************************
+ * LCD - a 2x16 buffer, rows and columns from 1.  Characters past the end of
+ * 		 a line are dropped, as the firmware never wraps.
+ ******************************************************************************/
+void LcdInit(void){
+	(void)memset(simLcd, ' ', sizeof(simLcd));
+	(void)memset(simLcdShown, ' ', sizeof(simLcdShown));
+	simLcdRow = 0u;
+	simLcdCol = 0u;
+	SimCharge(SIM_LCD_CLR_CYCLES);
+}
+
+void LcdClrLine(INT8U line){
+	if((line >= 1u) && (line <= SIM_LCD_ROWS)){
+		(void)memset(simLcd[line - 1u], ' ', SIM_LCD_COLS);
+		simLcdRow = line - 1u;
+		simLcdCol = 0u;
+	}
+	else{}
+	SimCharge(SIM_LCD_CLR_CYCLES);
+}
+
+void LcdMoveCursor(INT8U row, INT8U col){
+	if((row >= 1u) && (row <= SIM_LCD_ROWS) && (col >= 1u)){
+		simLcdRow = row - 1u;
+		simLcdCol = col - 1u;
+	}
+	else{}
+	SimCharge(SIM_LCD_CHAR_CYCLES);
+}
+
+void LcdDispChar(INT8C c){
+	if(simLcdCol < SIM_LCD_COLS){
+		simLcd[simLcdRow][simLcdCol] = c;
+		simLcdCol++;
+	}
+	else{}
+	SimCharge(SIM_LCD_CHAR_CYCLES);
+}
+
+void LcdDispStrg(const INT8C *strg){
+	while(*strg != '\0'){
+		LcdDispChar(*strg);
+		strg++;
+	}
+}
+
+void LcdDispByte(INT8U b){
+	static const INT8C hex[] = "0123456789ABCDEF";
+
+	LcdDispChar(hex[b >> 4]);
+	LcdDispChar(hex[b & 0x0fu]);
+}
+
+void LcdDispDecWord(INT32U binword, INT8U field){
+	INT8C strg[SIM_DEC_DIGITS];
+	INT32U len;
+
+	SimDecStrg(binword, strg);
+	for(len = strlen(strg); len < field; len++){
+		LcdDispChar(' ');
+	}
+	LcdDispStrg(strg);
+}
+
+/*****************************************************************************
+ * BasicIO - output only, a trace line per line sent.
+ ******************************************************************************/
+void BIOOpen(INT32U bitrate){
+	simUartCharCycles = ((SIM_TIME_T)SIM_CORE_HZ*SIM_UART_CHAR_BITS)/bitrate;
+	simUartLen = 0u;
+	simUartTxEnd = SimNow;
+}
+
+void BIOWrite(INT8C c){
+	if(c == '\n'){
+		simUartLine[simUartLen] = '\0';
+		if(simTraceUart != 0u){
+			SimTrace("UART %s", simUartLine);
+		}
+		else{}
+		simUartLen = 0u;
+	}
+	else if((c != '\r') && (simUartLen < (SIM_UART_LINE_LEN - 1u))){
+		simUartLine[simUartLen] = c;
+		simUartLen++;
+	}
+	else{}
+	if(simUartTxEnd > (SimNow + simUartCharCycles)){ //data register still full
+		SimCharge(simUartTxEnd - SimNow - simUartCharCycles);
+	}
+	else{}
+	simUartTxEnd = ((simUartTxEnd > SimNow) ? simUartTxEnd : SimNow) + simUartCharCycles;
+}
+
+void BIOPutStrg(const INT8C *strg){
+	while(*strg != '\0'){
+		BIOWrite(*strg);
+		strg++;
+	}
+}
+
+void BIOOutDecWord(INT32U binword, INT8U field){
+	INT8C strg[SIM_DEC_DIGITS];
+	INT32U len;
+
+	SimDecStrg(binword, strg);
+	for(len = strlen(strg); len < field; len++){
+		BIOWrite(' ');
+	}
+	BIOPutStrg(strg);
+}
+
+/*****************************************************************************
+ * Key - presses queued by the scenario.  A full queue drops the press, like
+ * 		 a keypad scanned too slowly.
+ ******************************************************************************/
+void SimKeyPush(INT8C key){
+	if((INT8U)(simKeyIn - simKeyOut) < SIM_KEY_QUEUE){
+		simKeys[simKeyIn % SIM_KEY_QUEUE] = key;
+		simKeyIn++;
+	}
+	else{}
+}
+
+void KeyInit(void){
+	simKeyIn = 0u;
+	simKeyOut = 0u;
+}
+
+void KeyTask(void){
+}
+
+INT8C KeyGet(void){
+	INT8C key = 0;
+
+	if(simKeyIn != simKeyOut){
+		key = simKeys[simKeyOut % SIM_KEY_QUEUE];
+		simKeyOut++;
+	}
+	else{}
+	return(key);
+}
+
+/*****************************************************************************
+ * LEDs, clocks, delays, checksum.
+ ******************************************************************************/
+void SimLedSet(INT8U led, INT8U on){
+	if((led >= 8u) && (led < (8u + SIM_LEDS))){
+		simLed[led - 8u] = on;
+	}
+	else{}
+}
+
+void GpioDBugBitsInit(void){
+}
+
+void GpioLED8Init(void){
+}
+
+void GpioLED9Init(void){
+}
+
+void K65TWR_BootClock(void){
+}
+
+INT32U SysTickDlyInit(void){
+	SysTick->LOAD = (INT32U)SIM_MS_CYCLES - 1u;
+	SysTick->VAL = 0u;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	return(0u);
+}
+
+void SysTick_Handler(void){
+	simSysTickMs++;
+}
+
+void SysTickDelay(INT32U ms){
+	if((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0u){ //the tick count never moves, it would hang
+		SimFail("SysTickDelay(%u) with SysTick stopped", ms);
+	}
+	else{}
+	SimCharge((SIM_TIME_T)ms*SIM_MS_CYCLES);
+}
+
+INT16U CSCalc(INT8U *startaddr, INT8U *endaddr){
+	(void)startaddr;
+	(void)endaddr;
+	return(SIM_FAKE_CHECKSUM);
+}
+
+/*****************************************************************************
+ * SimDecStrg() - Unsigned decimal, no padding.
+ ******************************************************************************/
+static void SimDecStrg(INT32U binword, INT8C *strg){
+	(void)snprintf(strg, SIM_DEC_DIGITS, "%u", binword);
+}
@@ -0,0 +1,410 @@
+/********************************************************************************
+* SimCore - Simulated time, NVIC and core of the security system simulator.
+* 			SimNow only moves forward.  A register access or a charge adds its
+* 			cycles and, if that crosses simNext, runs the peripheral and scenario
+* 			events in time order up to the new time.  Pending interrupts that are
+* 			enabled and not masked by PRIMASK are then taken one at a time, lowest
+* 			number first and never nested, as the firmware never sets priorities.
+* 			SysTick, exception -1, comes before the device interrupts and is
+* 			always enabled in the NVIC model; its TICKINT decides if it pends.
+* 			__WFI() jumps from event to event until an enabled interrupt is
+* 			pending, masked or not, the way the core wakes.  One that is
+* 			already pending is charged the instruction, so a loop of WFIs
+* 			with interrupts masked, an error trap, still moves time on.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include "MCUType.h"
+#include "Sim.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SIM_IRQ_SLOTS (SIM_NUM_IRQ + 1u) // SysTick, then the device interrupts
+#define SIM_IRQ_SLOT(irq) ((INT32U)((INT32S)(irq) + 1))
+#define SIM_IRQ_WORDS ((SIM_IRQ_SLOTS + 31u)/32u)
+#define SIM_IRQ_BIT(slot) ((INT32U)1u << ((INT32U)(slot) & 31u))
+////////////////////////////////////////////////////////////////////////////////////////
+
+//INTERRUPT HANDLERS, WEAK SO THE ONES THE FIRMWARE LEAVES OUT ARE 0////////////////////
+extern void DMA0_DMA16_IRQHandler(void) __attribute__((weak));
+extern void DMA1_DMA17_IRQHandler(void) __attribute__((weak));
+extern void DMA2_DMA18_IRQHandler(void) __attribute__((weak));
+extern void DMA3_DMA19_IRQHandler(void) __attribute__((weak));
+extern void DMA4_DMA20_IRQHandler(void) __attribute__((weak));
+extern void DMA5_DMA21_IRQHandler(void) __attribute__((weak));
+extern void DMA6_DMA22_IRQHandler(void) __attribute__((weak));
+extern void DMA7_DMA23_IRQHandler(void) __attribute__((weak));
+extern void DMA8_DMA24_IRQHandler(void) __attribute__((weak));
+extern void DMA9_DMA25_IRQHandler(void) __attribute__((weak));
+extern void DMA10_DMA26_IRQHandler(void) __attribute__((weak));
+extern void DMA11_DMA27_IRQHandler(void) __attribute__((weak));
+extern void DMA12_DMA28_IRQHandler(void) __attribute__((weak));
+extern void DMA13_DMA29_IRQHandler(void) __attribute__((weak));
+extern void DMA14_DMA30_IRQHandler(void) __attribute__((weak));
+extern void DMA15_DMA31_IRQHandler(void) __attribute__((weak));
+extern void ADC0_IRQHandler(void) __attribute__((weak));
+extern void PIT0_IRQHandler(void) __attribute__((weak));
+extern void PIT1_IRQHandler(void) __attribute__((weak));
+extern void PIT2_IRQHandler(void) __attribute__((weak));
+extern void PIT3_IRQHandler(void) __attribute__((weak));
+extern void DAC0_IRQHandler(void) __attribute__((weak));
+extern void LPTMR0_IRQHandler(void) __attribute__((weak));
+extern void TSI0_IRQHandler(void) __attribute__((weak));
+extern void SysTick_Handler(void) __attribute__((weak));
+
+static void (*const simVectors[SIM_IRQ_SLOTS])(void) = {
+	[SIM_IRQ_SLOT(SysTick_IRQn)] = SysTick_Handler,
+	[SIM_IRQ_SLOT(DMA0_DMA16_IRQn)] = DMA0_DMA16_IRQHandler, [SIM_IRQ_SLOT(DMA1_DMA17_IRQn)] = DMA1_DMA17_IRQHandler,
+	[SIM_IRQ_SLOT(DMA2_DMA18_IRQn)] = DMA2_DMA18_IRQHandler, [SIM_IRQ_SLOT(DMA3_DMA19_IRQn)] = DMA3_DMA19_IRQHandler,
+	[SIM_IRQ_SLOT(DMA4_DMA20_IRQn)] = DMA4_DMA20_IRQHandler, [SIM_IRQ_SLOT(DMA5_DMA21_IRQn)] = DMA5_DMA21_IRQHandler,
+	[SIM_IRQ_SLOT(DMA6_DMA22_IRQn)] = DMA6_DMA22_IRQHandler, [SIM_IRQ_SLOT(DMA7_DMA23_IRQn)] = DMA7_DMA23_IRQHandler,
+	[SIM_IRQ_SLOT(DMA8_DMA24_IRQn)] = DMA8_DMA24_IRQHandler, [SIM_IRQ_SLOT(DMA9_DMA25_IRQn)] = DMA9_DMA25_IRQHandler,
+	[SIM_IRQ_SLOT(DMA10_DMA26_IRQn)] = DMA10_DMA26_IRQHandler, [SIM_IRQ_SLOT(DMA11_DMA27_IRQn)] = DMA11_DMA27_IRQHandler,
+	[SIM_IRQ_SLOT(DMA12_DMA28_IRQn)] = DMA12_DMA28_IRQHandler, [SIM_IRQ_SLOT(DMA13_DMA29_IRQn)] = DMA13_DMA29_IRQHandler,
+	[SIM_IRQ_SLOT(DMA14_DMA30_IRQn)] = DMA14_DMA30_IRQHandler, [SIM_IRQ_SLOT(DMA15_DMA31_IRQn)] = DMA15_DMA31_IRQHandler,
+	[SIM_IRQ_SLOT(ADC0_IRQn)] = ADC0_IRQHandler,
+	[SIM_IRQ_SLOT(PIT0_IRQn)] = PIT0_IRQHandler, [SIM_IRQ_SLOT(PIT1_IRQn)] = PIT1_IRQHandler,
+	[SIM_IRQ_SLOT(PIT2_IRQn)] = PIT2_IRQHandler, [SIM_IRQ_SLOT(PIT3_IRQn)] = PIT3_IRQHandler,
+	[SIM_IRQ_SLOT(DAC0_IRQn)] = DAC0_IRQHandler,
+	[SIM_IRQ_SLOT(LPTMR0_IRQn)] = LPTMR0_IRQHandler,
+	[SIM_IRQ_SLOT(TSI0_IRQn)] = TSI0_IRQHandler
+};
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+SIM_TIME_T SimNow;
+static SIM_TIME_T simNext = SIM_NEVER; //earliest peripheral or scenario event
+static SIM_TIME_T simEnd = SIM_NEVER;
+static INT32U simDirty; //peripherals written since the last sync
+static INT32U simIrqEnabled[SIM_IRQ_WORDS] = {SIM_IRQ_BIT(SIM_IRQ_SLOT(SysTick_IRQn))}; //bit n of word w for slot 32w+n
+static INT32U simIrqPending[SIM_IRQ_WORDS];
+static INT8U simPrimask;
+static INT8U simInIsr;
+static INT8U simIrqWaiting; //an enabled interrupt is pending
+static INT8U simIrqReady; //and may be taken now
+static INT64U simIrqTaken;
+static SIM_TIME_T simAsleep; //cycles in WFI
+static INT64U simWakes; //WFI left for an interrupt
+static clock_t simWallStart;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void SimSync(void);
+static void SimRunTo(SIM_TIME_T t);
+static void SimIrqUpdate(void);
+static void SimIrqTake(void);
+static INT8U SimIrqValid(IRQn_Type irq);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SimStart() - Set the end of the run.
+ *
+ * 	Parameters: end - simulated time to stop at
+ * 	Returns: none
+ ******************************************************************************/
+void SimStart(SIM_TIME_T end){
+	simEnd = end;
+	simWallStart = clock();
+	SimReschedule();
+}
+
+/*****************************************************************************
+ * SimAccess() - One firmware register access.  The peripheral is marked dirty
+ * 				 after the events run, as the write, if any, comes after the
+ * 				 accessor returns.
+ *
+ * 	Parameters: dirty - the peripheral's dirty flag
+ * 	Returns: none
+ ******************************************************************************/
+void SimAccess(INT32U dirty){
+	SimSync();
+	SimCharge(SIM_ACCESS_CYCLES);
+	simDirty |= dirty;
+}
+
+/*****************************************************************************
+ * SimCharge() - Move time on by cycles of firmware work, running the events
+ * 				 it crosses, then take any interrupt that is ready.
+ *
+ * 	Parameters: cycles - core cycles
+ * 	Returns: none
+ ******************************************************************************/
+void SimCharge(SIM_TIME_T cycles){
+	SIM_TIME_T t = SimNow + cycles;
+
+	if((t >= simNext) || (t >= simEnd)){
+		SimRunTo(t);
+	}
+	else{
+		SimNow = t;
+	}
+	if(simIrqReady != 0u){
+		SimIrqTake();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimReschedule() - simNext from the peripherals and the scenario.
+ ******************************************************************************/
+void SimReschedule(void){
+	SIM_TIME_T periph = SimPeriphNext();
+	SIM_TIME_T script = SimScriptNext();
+
+	simNext = (periph < script) ? periph : script;
+}
+
+/*****************************************************************************
+ * SimIrqPend() - Pend an interrupt from a peripheral model.
+ ******************************************************************************/
+void SimIrqPend(IRQn_Type irq){
+	if(SimIrqValid(irq) == TRUE){
+		simIrqPending[SIM_IRQ_SLOT(irq)/32u] |= SIM_IRQ_BIT(SIM_IRQ_SLOT(irq));
+		SimIrqUpdate();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * NVIC and PRIMASK - the CMSIS calls the firmware makes.  Changes that can
+ * 					  make an interrupt ready take it at once, as the core would
+ * 					  right after the instruction.
+ ******************************************************************************/
+void NVIC_EnableIRQ(IRQn_Type irq){
+	SimSync();
+	if(SimIrqValid(irq) == TRUE){
+		simIrqEnabled[SIM_IRQ_SLOT(irq)/32u] |= SIM_IRQ_BIT(SIM_IRQ_SLOT(irq));
+		SimIrqUpdate();
+		if(simIrqReady != 0u){
+			SimIrqTake();
+		}
+		else{}
+	}
+	else{}
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq){
+	if(SimIrqValid(irq) == TRUE){
+		simIrqEnabled[SIM_IRQ_SLOT(irq)/32u] &= ~SIM_IRQ_BIT(SIM_IRQ_SLOT(irq));
+		SimIrqUpdate();
+	}
+	else{}
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq){
+	if(SimIrqValid(irq) == TRUE){
+		simIrqPending[SIM_IRQ_SLOT(irq)/32u] &= ~SIM_IRQ_BIT(SIM_IRQ_SLOT(irq));
+		SimIrqUpdate();
+	}
+	else{}
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq){
+	SimIrqPend(irq);
+	if(simIrqReady != 0u){
+		SimIrqTake();
+	}
+	else{}
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority){
+	(void)irq;
+	(void)priority;
+}
+
+void __enable_irq(void){
+	simPrimask = 0u;
+	SimSync();
+	SimIrqUpdate();
+	if(simIrqReady != 0u){
+		SimIrqTake();
+	}
+	else{}
+}
+
+void __disable_irq(void){
+	simPrimask = 1u;
+	simIrqReady = 0u; //masking can only hold interrupts off
+}
+
+uint32_t __get_PRIMASK(void){
+	return(simPrimask);
+}
+
+void __set_PRIMASK(uint32_t primask){
+	if(primask == 0u){
+		__enable_irq();
+	}
+	else{
+		__disable_irq();
+	}
+}
+
+/*****************************************************************************
+ * __WFI() - Trace what changed while awake, then sleep from event to event
+ * 			 until an enabled interrupt is pending.
+ *
+ * 	Parameters: none
+ * 	Returns: none
+ ******************************************************************************/
+void __WFI(void){
+	SIM_TIME_T start;
+
+	SimSync();
+	SimBoardTrace();
+	if(simIrqWaiting != 0u){ //wakes at once, masked or not, costing the instruction
+		SimCharge(SIM_WFI_CYCLES);
+	}
+	else{}
+	start = SimNow;
+	while(simIrqWaiting == 0u){
+		if((simNext == SIM_NEVER) && (simEnd == SIM_NEVER)){
+			SimFail("WFI with nothing left to wake the core");
+		}
+		else{}
+		SimRunTo((simNext < simEnd) ? simNext : simEnd);
+	}
+	simAsleep += SimNow - start;
+	simWakes++;
+	if(simIrqReady != 0u){
+		SimIrqTake();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimFinish() - Trace the last changes and END, print the run summary to
+ * 				 stderr so the trace stays the same from run to run, exit.
+ ******************************************************************************/
+void SimFinish(void){
+	double wall = (double)(clock() - simWallStart)/CLOCKS_PER_SEC;
+	double simsec = (double)SimNow/SIM_CORE_HZ;
+
+	SimBoardTrace();
+	SimTrace("END");
+	fflush(stdout);
+	fprintf(stderr, "simulated %.1f s in %.2f s (%.0fx real time), %llu interrupts, core asleep %.4f%%, %.1f wakes/s\n",
+			simsec, wall, (wall > 0.0) ? (simsec/wall) : 0.0, simIrqTaken,
+			(SimNow != 0u) ? ((100.0*(double)simAsleep)/(double)SimNow) : 0.0,
+			(simsec > 0.0) ? ((double)simWakes/simsec) : 0.0);
+	exit(0);
+}
+
+/*****************************************************************************
+ * SimFail() - Stop on something the models can't go on from.
+ ******************************************************************************/
+void SimFail(const char *fmt, ...){
+	va_list args;
+
+	fflush(stdout);
+	fprintf(stderr, "secsim: %.6f s: ", (double)SimNow/SIM_CORE_HZ);
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+	exit(2);
+}
+
+/*****************************************************************************
+ * SimSync() - Apply the writes to the dirty peripherals.
+ ******************************************************************************/
+static void SimSync(void){
+	INT32U dirty = simDirty;
+
+	if(dirty != 0u){
+		simDirty = 0u;
+		SimPeriphSync(dirty);
+		SimReschedule();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimRunTo() - Run the events up to t in time order and leave SimNow at t,
+ * 				or finish at the end of the run.
+ ******************************************************************************/
+static void SimRunTo(SIM_TIME_T t){
+	SimSync();
+	while((simNext <= t) || (simEnd <= t)){
+		if(simEnd <= simNext){
+			SimNow = simEnd;
+			SimFinish();
+		}
+		else{}
+		if(simNext > SimNow){
+			SimNow = simNext;
+		}
+		else{}
+		SimPeriphEvent();
+		SimScriptEvent();
+		if(simDirty != 0u){
+			SimSync();
+		}
+		else{
+			SimReschedule();
+		}
+	}
+	if(t > SimNow){
+		SimNow = t;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimIrqUpdate() - Recompute simIrqWaiting and simIrqReady.
+ ******************************************************************************/
+static void SimIrqUpdate(void){
+	INT32U word;
+
+	simIrqWaiting = 0u;
+	for(word = 0u; word < SIM_IRQ_WORDS; word++){
+		if((simIrqPending[word] & simIrqEnabled[word]) != 0u){
+			simIrqWaiting = 1u;
+		}
+		else{}
+	}
+	simIrqReady = (INT8U)((simIrqWaiting != 0u) && (simPrimask == 0u) && (simInIsr == 0u));
+}
+
+/*****************************************************************************
+ * SimIrqTake() - Run the handlers of the ready interrupts, lowest number
+ * 				  first, one at a time.
+ ******************************************************************************/
+static void SimIrqTake(void){
+	INT32U slot;
+	INT32U word;
+
+	while(simIrqReady != 0u){
+		word = 0u;
+		while((simIrqPending[word] & simIrqEnabled[word]) == 0u){
+			word++;
+		}
+		slot = (32u*word) + (INT32U)__builtin_ctz(simIrqPending[word] & simIrqEnabled[word]);
+		if(simVectors[slot] == 0){
+			SimFail("interrupt %d enabled with no handler", (INT32S)slot - 1);
+		}
+		else{}
+		simIrqPending[word] &= ~SIM_IRQ_BIT(slot);
+		simInIsr = 1u;
+		SimIrqUpdate();
+		simIrqTaken++;
+		SimCharge(SIM_IRQ_ENTRY_CYCLES);
+		simVectors[slot]();
+		SimSync();
+		simInIsr = 0u;
+		SimIrqUpdate();
+	}
+}
+
+/*****************************************************************************
+ * SimIrqValid() - TRUE for SysTick or a device interrupt number the NVIC
+ * 				   model holds.
+ ******************************************************************************/
+static INT8U SimIrqValid(IRQn_Type irq){
+	return((INT8U)(((INT32S)irq >= (INT32S)SysTick_IRQn) && ((INT32S)irq < (INT32S)SIM_NUM_IRQ)));
+}
@@ -0,0 +1,51 @@
+/********************************************************************************
+* SimMain - Command line of the security system simulator.
+*
+* 		secsim [-l] [-q] scenario
+*
+* 	-l traces LED changes, -q leaves out the serial port lines.  The trace goes
+* 	to stdout and the run summary to stderr.  Exits 0 at the end of the
+* 	scenario, 1 for a bad command line and 2 when the run can't go on.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "Sim.h"
+//////////////////////////////
+
+int main(int argc, char **argv){
+	INT8U leds = 0u;
+	INT8U uart = 1u;
+	const char *path = NULL;
+	int arg;
+	int status = 0;
+
+	for(arg = 1; arg < argc; arg++){
+		if(strcmp(argv[arg], "-l") == 0){
+			leds = 1u;
+		}
+		else if(strcmp(argv[arg], "-q") == 0){
+			uart = 0u;
+		}
+		else if((argv[arg][0] != '-') && (path == NULL)){
+			path = argv[arg];
+		}
+		else{
+			status = 1;
+		}
+	}
+	if((path == NULL) || (status != 0)){
+		fprintf(stderr, "usage: secsim [-l] [-q] scenario\n");
+		status = 1;
+	}
+	else{
+		SimBoardOptions(leds, uart);
+		SimStart(SimScriptLoad(path));
+		SimFirmwareMain();
+		SimFinish(); //the firmware never returns, the end of the run exits
+	}
+	return(status);
+}
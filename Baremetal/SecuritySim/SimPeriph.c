@@ -0,0 +1,832 @@
+/********************************************************************************
+* SimPeriph - Models of the K65 peripherals the security system uses.
+*
+* 	The registers are plain memory the firmware reads and writes through the
+* 	MK65F18.h accessors.  SimPeriphSync() applies what was written since the
+* 	last access: enables, starts and the write-only DMA command registers, which
+* 	read back as NOP once applied.  Write-1-to-clear flags can't be told apart
+* 	from flags left set, so TSI EOSF and OUTRGF are cleared when the next scan
+* 	starts and the timer flags are only ever set; interrupts are pended on the
+* 	event, not held by the flag.
+*
+* 	-PIT: four down counters on the bus clock.  Each expiry sets TIF, can
+* 	 interrupt, triggers ADC0 through SIM_SOPT7 and starts DMA channel n through
+* 	 a DMAMUX trigger slot.
+* 	-LPTMR0: the 1 kHz. LPO, or OSCERCLK through the prescaler when OSC0 CR
+* 	 ERCLKEN passes it on, counted with the counter reset on compare (TFC 0).
+* 	 The next match is taken from CMR as it stands, so a CMR written while TCF is
+* 	 set sets the following period.  The count clock can be given a frequency
+* 	 error against the core, as the LPO and crystal have; each period is then
+* 	 rounded to a core cycle.
+* 	-SysTick: the core clock count, reloading from LOAD and pending the SysTick
+* 	 exception when TICKINT is set.
+* 	-ADC0: hardware or software triggered single conversions, the result from
+* 	 SimScript, the compare function with all ACFGT/ACREN cases, COCO, AIEN and
+* 	 DMAEN.  A DMA read of R clears COCO.  With ADTRG clear a DMA write to SC1A,
+* 	 or a firmware write that changes it, restarts the conversion; the firmware
+* 	 writing the value SC1A already holds is not seen.
+* 	-TSI0: software or DMA started scans of one channel, the count from
+* 	 SimScript, EOSF, out of range against TSHD and the TSIIEN/ESOR interrupt.
+* 	-DMA0/DMAMUX: minor loops with SMOD/DMOD, major loop completion with
+* 	 SLAST/DLAST or scatter-gather, minor and major channel links, DREQ and
+* 	 INTMAJOR.  Transfers take no time.
+* 	-DAC0: DMA writes are watched for the trace: SIREN on at the first, off
+* 	 when the DMA channel feeding it or its PIT stops.
+* 	-DWT: CYCCNT is SimNow, offset by whatever the firmware writes to it.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <string.h>
+#include "MCUType.h"
+#include "Sim.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SIM_PIT_CHANNELS 4u
+#define SIM_DMA_CHANNELS 32u
+#define SIM_DMA_NOP 0x80u // DMA command register value once applied
+#define SIM_DMA_LINK_MAX 64u // links followed from one request
+#define SIM_DMA_TCD_BYTES 32u
+#define SIM_ADC0_TRGSEL_PIT0 4u
+#define SIM_DMAMUX_ADC0 40u
+#define SIM_TSI_SCAN_CYCLES SIM_US(500u)
+#define SIM_ADC_CONV_CYCLES SIM_US(100u)
+#define SIM_CITER_ELINK_MASK 0x8000u
+#define SIM_CITER_LINK_COUNT_MASK 0x1ffu
+#define SIM_CITER_COUNT_MASK 0x7fffu
+#define SIM_CITER_LINKCH_SHIFT 9u
+#define SIM_CHANNEL_MASK 0x1fu
+#define SIM_ADCH_MASK 0x1fu
+#define SIM_NO_CHANNEL 0xffu
+#define SIM_PPM 1000000u
+////////////////////////////////////////////////////////////////////////////////////////
+
+//REGISTERS//////////////////////////////////////////////////////////////////////////////
+SIM_Type SimRegSim;
+DMAMUX_Type SimRegDmamux;
+PORT_Type SimRegPort[5];
+CoreDebug_Type SimRegCoreDebug;
+OSC_Type SimRegOsc;
+static ADC_Type simAdc0;
+static DAC_Type simDac0;
+static DMA_Type simDma0 = {.CEEI = SIM_DMA_NOP, .SEEI = SIM_DMA_NOP, .CERQ = SIM_DMA_NOP,
+		.SERQ = SIM_DMA_NOP, .CDNE = SIM_DMA_NOP, .SSRT = SIM_DMA_NOP, .CERR = SIM_DMA_NOP,
+		.CINT = SIM_DMA_NOP};
+static PIT_Type simPit = {.MCR = PIT_MCR_MDIS_MASK};
+static LPTMR_Type simLptmr0;
+static TSI_Type simTsi0;
+static DWT_Type simDwt;
+static SysTick_Type simSysTick;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//MODEL STATE////////////////////////////////////////////////////////////////////////////
+static SIM_TIME_T simPitNext[SIM_PIT_CHANNELS] = {SIM_NEVER, SIM_NEVER, SIM_NEVER, SIM_NEVER};
+static INT8U simLptmrRun;
+static SIM_TIME_T simLptmrStart; //last match or enable, the counter is 0 there
+static SIM_TIME_T simLptmrCycles; //core cycles per count
+static INT32S simLptmrPpm; //count clock error, + runs fast
+static SIM_TIME_T simSysTickNext = SIM_NEVER; //next wrap to 0
+static SIM_TIME_T simTsiEnd = SIM_NEVER; //end of the scan in progress
+static INT8U simTsiCh;
+static SIM_TIME_T simAdcEnd = SIM_NEVER; //end of the conversion in progress
+static INT32U simAdcSc1; //SC1A as last applied, without COCO
+static INT32U simDwtShadow; //CYCCNT as last handed out
+static INT32U simDwtOffset;
+static SIM_TIME_T simDwtAt; //last access, when a CYCCNT write was made
+static INT8U simSiren; //DMA is feeding DAC0
+static INT8U simSirenCh = SIM_NO_CHANNEL; //channel doing it
+static INT8U simDmaCh = SIM_NO_CHANNEL; //channel whose minor loop is running
+static INT32U simDmaDirty; //SIM_DIRTY_ flags of the registers DMA wrote
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void SimPitSync(void);
+static void SimLptmrSync(void);
+static void SimTsiSync(void);
+static void SimAdcSync(void);
+static void SimDmaSync(void);
+static void SimDwtSync(void);
+static void SimSysTickSync(void);
+static SIM_TIME_T SimLptmrNext(void);
+static void SimPitExpire(INT8U ch);
+static void SimTsiDone(void);
+static void SimAdcSoftStart(void);
+static void SimAdcDone(void);
+static INT8U SimAdcCompare(INT32U result);
+static void SimDmaSource(INT8U source);
+static void SimDmaRequest(INT8U ch);
+static void SimDmaService(INT8U ch);
+static INT8U SimDmaMinor(INT8U ch);
+static INT32U SimDmaStep(INT32U addr, INT32S off, INT32U mod);
+static INT8U SimDmaSize(INT32U code);
+static INT32U SimMemRead(INT32U addr, INT8U size);
+static void SimMemWrite(INT32U addr, INT8U size, INT32U val);
+static void *SimMemPtr(INT32U addr);
+static INT8U SimInside(INT32U addr, const volatile void *block, INT32U bytes);
+static void SimSirenOff(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * Accessors - one firmware access each.
+ ******************************************************************************/
+ADC_Type *SimAdc0(void){
+	SimAccess(SIM_DIRTY_ADC);
+	return(&simAdc0);
+}
+
+DAC_Type *SimDac0(void){
+	SimAccess(SIM_DIRTY_DAC);
+	return(&simDac0);
+}
+
+DMA_Type *SimDma0(void){
+	SimAccess(SIM_DIRTY_DMA);
+	return(&simDma0);
+}
+
+PIT_Type *SimPit(void){
+	SimAccess(SIM_DIRTY_PIT);
+	return(&simPit);
+}
+
+LPTMR_Type *SimLptmr0(void){
+	SimAccess(SIM_DIRTY_LPTMR);
+	return(&simLptmr0);
+}
+
+TSI_Type *SimTsi0(void){
+	SimAccess(SIM_DIRTY_TSI);
+	return(&simTsi0);
+}
+
+DWT_Type *SimDwt(void){
+	SimDwtSync(); //a CYCCNT write since the last read, no other access needs it
+	SimCharge(SIM_ACCESS_CYCLES);
+	if(((SimRegCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0u) && ((simDwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0u)){
+		simDwt.CYCCNT = (INT32U)SimNow + simDwtOffset;
+	}
+	else{}
+	simDwtShadow = simDwt.CYCCNT;
+	simDwtAt = SimNow;
+	return(&simDwt);
+}
+
+SysTick_Type *SimSysTick(void){
+	SimAccess(SIM_DIRTY_SYSTICK);
+	return(&simSysTick);
+}
+
+/*****************************************************************************
+ * SimPeriphSync() - Apply the firmware writes to the dirty peripherals.
+ *
+ * 	Parameters: dirty - SIM_DIRTY_ flags
+ * 	Returns: none
+ ******************************************************************************/
+void SimPeriphSync(INT32U dirty){
+	if((dirty & SIM_DIRTY_PIT) != 0u){
+		SimPitSync();
+	}
+	else{}
+	if((dirty & SIM_DIRTY_LPTMR) != 0u){
+		SimLptmrSync();
+	}
+	else{}
+	if((dirty & SIM_DIRTY_TSI) != 0u){
+		SimTsiSync();
+	}
+	else{}
+	if((dirty & SIM_DIRTY_ADC) != 0u){
+		SimAdcSync();
+	}
+	else{}
+	if((dirty & SIM_DIRTY_DMA) != 0u){
+		SimDmaSync();
+	}
+	else{}
+	if((dirty & SIM_DIRTY_SYSTICK) != 0u){
+		SimSysTickSync();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimPeriphNext() - Earliest scheduled peripheral event.
+ ******************************************************************************/
+SIM_TIME_T SimPeriphNext(void){
+	SIM_TIME_T next = SimLptmrNext();
+	INT8U ch;
+
+	for(ch = 0u; ch < SIM_PIT_CHANNELS; ch++){
+		if(simPitNext[ch] < next){
+			next = simPitNext[ch];
+		}
+		else{}
+	}
+	if(simTsiEnd < next){
+		next = simTsiEnd;
+	}
+	else{}
+	if(simAdcEnd < next){
+		next = simAdcEnd;
+	}
+	else{}
+	if(simSysTickNext < next){
+		next = simSysTickNext;
+	}
+	else{}
+	return(next);
+}
+
+/*****************************************************************************
+ * SimPeriphEvent() - Run the events due at SimNow.
+ ******************************************************************************/
+void SimPeriphEvent(void){
+	INT8U ch;
+
+	for(ch = 0u; ch < SIM_PIT_CHANNELS; ch++){
+		while(simPitNext[ch] <= SimNow){
+			SimPitExpire(ch);
+		}
+	}
+	if(SimLptmrNext() <= SimNow){
+		simLptmrStart = SimLptmrNext();
+		simLptmr0.CSR |= LPTMR_CSR_TCF_MASK;
+		if((simLptmr0.CSR & LPTMR_CSR_TIE_MASK) != 0u){
+			SimIrqPend(LPTMR0_IRQn);
+		}
+		else{}
+	}
+	else{}
+	if(simTsiEnd <= SimNow){
+		SimTsiDone();
+	}
+	else{}
+	if(simAdcEnd <= SimNow){
+		SimAdcDone();
+	}
+	else{}
+	if(simSysTickNext <= SimNow){
+		simSysTickNext += (SIM_TIME_T)(simSysTick.LOAD & SysTick_LOAD_RELOAD_Msk) + 1u;
+		simSysTick.CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+		if((simSysTick.CTRL & SysTick_CTRL_TICKINT_Msk) != 0u){
+			SimIrqPend(SysTick_IRQn);
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimPitSync() - Start or stop the channels whose TEN changed.
+ ******************************************************************************/
+static void SimPitSync(void){
+	INT8U ch;
+	INT8U run;
+
+	for(ch = 0u; ch < SIM_PIT_CHANNELS; ch++){
+		run = (INT8U)(((simPit.MCR & PIT_MCR_MDIS_MASK) == 0u) && ((simPit.CHANNEL[ch].TCTRL & PIT_TCTRL_TEN_MASK) != 0u));
+		if((run != 0u) && (simPitNext[ch] == SIM_NEVER)){
+			simPitNext[ch] = SimNow + (((SIM_TIME_T)simPit.CHANNEL[ch].LDVAL + 1u)*SIM_BUS_CYCLES);
+		}
+		else if((run == 0u) && (simPitNext[ch] != SIM_NEVER)){
+			simPitNext[ch] = SIM_NEVER;
+			if((simSiren != 0u) && (simSirenCh == ch)){
+				SimSirenOff();
+			}
+			else{}
+		}
+		else{}
+	}
+}
+
+/*****************************************************************************
+ * SimPitExpire() - A channel reached 0: flag, interrupt, triggers, reload.
+ ******************************************************************************/
+static void SimPitExpire(INT8U ch){
+	INT32U sopt7 = SimRegSim.SOPT7;
+
+	simPitNext[ch] += ((SIM_TIME_T)simPit.CHANNEL[ch].LDVAL + 1u)*SIM_BUS_CYCLES;
+	simPit.CHANNEL[ch].TFLG |= PIT_TFLG_TIF_MASK;
+	if((simPit.CHANNEL[ch].TCTRL & PIT_TCTRL_TIE_MASK) != 0u){
+		SimIrqPend((IRQn_Type)(PIT0_IRQn + ch));
+	}
+	else{}
+	if(((sopt7 & SIM_SOPT7_ADC0ALTTRGEN_MASK) != 0u)
+			&& (((sopt7 & SIM_SOPT7_ADC0TRGSEL_MASK) >> SIM_SOPT7_ADC0TRGSEL_SHIFT) == (SIM_ADC0_TRGSEL_PIT0 + ch))
+			&& ((simAdc0.SC2 & ADC_SC2_ADTRG_MASK) != 0u) && (simAdcEnd == SIM_NEVER)){
+		simAdcEnd = SimNow + SIM_ADC_CONV_CYCLES;
+	}
+	else{}
+	if(((SimRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_ENBL_MASK) != 0u) && ((SimRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_TRIG_MASK) != 0u)){
+		SimDmaRequest(ch);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimLptmrSync() - Start or stop on TEN, taking the count period from PSR.
+ * 					OSCERCLK prescaled to a whole number of core cycles is
+ * 					the only other clock modelled.
+ ******************************************************************************/
+static void SimLptmrSync(void){
+	INT8U run = (INT8U)((simLptmr0.CSR & LPTMR_CSR_TEN_MASK) != 0u);
+	INT32U psr = simLptmr0.PSR;
+	SIM_TIME_T scaled;
+
+	if((run != 0u) && (simLptmrRun == 0u)){
+		simLptmrStart = SimNow;
+		if((psr & (LPTMR_PSR_PCS_MASK | LPTMR_PSR_PBYP_MASK)) == (LPTMR_PSR_PCS(1) | LPTMR_PSR_PBYP_MASK)){
+			simLptmrCycles = SIM_LPO_CYCLES;
+		}
+		else if(((psr & (LPTMR_PSR_PCS_MASK | LPTMR_PSR_PBYP_MASK)) == LPTMR_PSR_PCS(3))
+				&& ((SimRegOsc.CR & OSC_CR_ERCLKEN_MASK) != 0u)){
+			scaled = (SIM_TIME_T)SIM_CORE_HZ << (((psr & LPTMR_PSR_PRESCALE_MASK) >> LPTMR_PSR_PRESCALE_SHIFT) + 1u);
+			if((scaled % SIM_OSCER_HZ) != 0u){
+				SimFail("LPTMR0 OSCERCLK prescaler not a whole number of core cycles");
+			}
+			else{}
+			simLptmrCycles = scaled/SIM_OSCER_HZ;
+		}
+		else{
+			SimFail("LPTMR0 modelled on the LPO without prescaler or prescaled OSCERCLK only");
+		}
+	}
+	else{}
+	simLptmrRun = run;
+}
+
+/*****************************************************************************
+ * SimLptmrClockErr() - Set the count clock error, taking effect from the
+ * 						period in progress.
+ ******************************************************************************/
+void SimLptmrClockErr(INT32S ppm){
+	simLptmrPpm = ppm;
+}
+
+/*****************************************************************************
+ * SimLptmrNext() - Next compare match, CMR+1 counts after the last one.
+ ******************************************************************************/
+static SIM_TIME_T SimLptmrNext(void){
+	SIM_TIME_T next = SIM_NEVER;
+	SIM_TIME_T period;
+	SIM_TIME_T hz;
+
+	if(simLptmrRun != 0u){
+		period = ((SIM_TIME_T)(simLptmr0.CMR & LPTMR_CMR_COMPARE_MASK) + 1u)*simLptmrCycles;
+		if(simLptmrPpm != 0){
+			hz = (SIM_TIME_T)((INT64S)SIM_PPM + simLptmrPpm);
+			period = ((period*SIM_PPM) + (hz/2u))/hz;
+		}
+		else{}
+		next = simLptmrStart + period;
+	}
+	else{}
+	return(next);
+}
+
+/*****************************************************************************
+ * SimTsiSync() - SWTS starts a scan of TSICH.
+ ******************************************************************************/
+static void SimTsiSync(void){
+	if(((simTsi0.DATA & TSI_DATA_SWTS_MASK) != 0u) && ((simTsi0.GENCS & TSI_GENCS_TSIEN_MASK) != 0u)){
+		simTsi0.DATA &= ~TSI_DATA_SWTS_MASK;
+		simTsi0.GENCS = (simTsi0.GENCS & ~(TSI_GENCS_EOSF_MASK | TSI_GENCS_OUTRGF_MASK)) | TSI_GENCS_SCNIP_MASK;
+		simTsiCh = (INT8U)((simTsi0.DATA & TSI_DATA_TSICH_MASK) >> TSI_DATA_TSICH_SHIFT);
+		simTsiEnd = SimNow + SIM_TSI_SCAN_CYCLES;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimTsiDone() - End of scan: count, flags, interrupt.
+ ******************************************************************************/
+static void SimTsiDone(void){
+	INT32U count = SimScriptTsiCount(simTsiCh);
+	INT32U thresh = (simTsi0.TSHD & TSI_TSHD_THRESH_MASK) >> TSI_TSHD_THRESH_SHIFT;
+	INT32U thresl = (simTsi0.TSHD & TSI_TSHD_THRESL_MASK) >> TSI_TSHD_THRESL_SHIFT;
+	INT8U outrange = (INT8U)((count > thresh) || (count < thresl));
+
+	simTsiEnd = SIM_NEVER;
+	simTsi0.DATA = (simTsi0.DATA & ~TSI_DATA_TSICNT_MASK) | TSI_DATA_TSICNT(count);
+	simTsi0.GENCS = (simTsi0.GENCS & ~TSI_GENCS_SCNIP_MASK) | TSI_GENCS_EOSF_MASK;
+	if(outrange != 0u){
+		simTsi0.GENCS |= TSI_GENCS_OUTRGF_MASK;
+	}
+	else{}
+	if((simTsi0.GENCS & TSI_GENCS_TSIIEN_MASK) != 0u){
+		if(((simTsi0.GENCS & TSI_GENCS_ESOR_MASK) != 0u) || (outrange != 0u)){
+			SimIrqPend(TSI0_IRQn);
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimAdcSync() - A changed SC1A was written.
+ ******************************************************************************/
+static void SimAdcSync(void){
+	INT32U sc1 = simAdc0.SC1[0] & ~ADC_SC1_COCO_MASK;
+
+	if(sc1 != simAdcSc1){
+		simAdcSc1 = sc1;
+		SimAdcSoftStart();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimAdcSoftStart() - An SC1A write: in software trigger mode it aborts the
+ * 					   conversion in progress and starts a new one.
+ ******************************************************************************/
+static void SimAdcSoftStart(void){
+	if((simAdc0.SC2 & ADC_SC2_ADTRG_MASK) == 0u){
+		simAdc0.SC1[0] &= ~ADC_SC1_COCO_MASK;
+		simAdcEnd = SimNow + SIM_ADC_CONV_CYCLES;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimAdcDone() - End of conversion: compare, result, interrupt, DMA request.
+ ******************************************************************************/
+static void SimAdcDone(void){
+	INT32U result = SimScriptAdcCode((INT8U)(simAdc0.SC1[0] & SIM_ADCH_MASK));
+
+	simAdcEnd = SIM_NEVER;
+	if(((simAdc0.SC2 & ADC_SC2_ACFE_MASK) == 0u) || (SimAdcCompare(result) == TRUE)){
+		*(volatile INT32U *)&simAdc0.R[0] = result;
+		simAdc0.SC1[0] |= ADC_SC1_COCO_MASK;
+		if((simAdc0.SC1[0] & ADC_SC1_AIEN_MASK) != 0u){
+			SimIrqPend(ADC0_IRQn);
+		}
+		else{}
+		if((simAdc0.SC2 & ADC_SC2_DMAEN_MASK) != 0u){
+			SimDmaSource(SIM_DMAMUX_ADC0);
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimAdcCompare() - The compare function, K65 reference manual table.
+ ******************************************************************************/
+static INT8U SimAdcCompare(INT32U result){
+	INT32U cv1 = simAdc0.CV1 & ADC_CV1_CV_MASK;
+	INT32U cv2 = simAdc0.CV2 & ADC_CV2_CV_MASK;
+	INT8U gt = (INT8U)((simAdc0.SC2 & ADC_SC2_ACFGT_MASK) != 0u);
+	INT8U range = (INT8U)((simAdc0.SC2 & ADC_SC2_ACREN_MASK) != 0u);
+	INT8U pass;
+
+	if(range == 0u){
+		pass = (INT8U)((gt != 0u) ? (result >= cv1) : (result < cv1));
+	}
+	else if(gt == 0u){
+		pass = (INT8U)((cv1 <= cv2) ? ((result < cv1) || (result > cv2)) : ((result < cv1) && (result > cv2)));
+	}
+	else{
+		pass = (INT8U)((cv1 <= cv2) ? ((result >= cv1) && (result <= cv2)) : ((result >= cv1) || (result <= cv2)));
+	}
+	return(pass);
+}
+
+/*****************************************************************************
+ * SimDmaSync() - Apply the command registers and software starts.
+ ******************************************************************************/
+static void SimDmaSync(void){
+	INT8U ch;
+	INT8U cmd;
+
+	cmd = simDma0.SERQ;
+	if(cmd != SIM_DMA_NOP){
+		simDma0.ERQ |= ((cmd & DMA_SERQ_SAER_MASK) != 0u) ? 0xffffffffu : (1u << (cmd & SIM_CHANNEL_MASK));
+		simDma0.SERQ = SIM_DMA_NOP;
+	}
+	else{}
+	cmd = simDma0.CERQ;
+	if(cmd != SIM_DMA_NOP){
+		simDma0.ERQ &= ((cmd & DMA_CERQ_CAER_MASK) != 0u) ? 0u : ~(1u << (cmd & SIM_CHANNEL_MASK));
+		simDma0.CERQ = SIM_DMA_NOP;
+	}
+	else{}
+	cmd = simDma0.CINT;
+	if(cmd != SIM_DMA_NOP){
+		simDma0.INT &= ((cmd & DMA_CINT_CAIR_MASK) != 0u) ? 0u : ~(1u << (cmd & SIM_CHANNEL_MASK));
+		simDma0.CINT = SIM_DMA_NOP;
+	}
+	else{}
+	cmd = simDma0.CDNE;
+	if(cmd != SIM_DMA_NOP){
+		for(ch = 0u; ch < SIM_DMA_CHANNELS; ch++){
+			if(((cmd & DMA_CDNE_CADN_MASK) != 0u) || (ch == (cmd & SIM_CHANNEL_MASK))){
+				simDma0.TCD[ch].CSR &= (INT16U)~DMA_CSR_DONE_MASK;
+			}
+			else{}
+		}
+		simDma0.CDNE = SIM_DMA_NOP;
+	}
+	else{}
+	cmd = simDma0.SSRT;
+	if(cmd != SIM_DMA_NOP){
+		for(ch = 0u; ch < SIM_DMA_CHANNELS; ch++){
+			if(((cmd & DMA_SSRT_SAST_MASK) != 0u) || (ch == (cmd & SIM_CHANNEL_MASK))){
+				simDma0.TCD[ch].CSR |= DMA_CSR_START_MASK;
+			}
+			else{}
+		}
+		simDma0.SSRT = SIM_DMA_NOP;
+	}
+	else{}
+	simDma0.CEEI = SIM_DMA_NOP;
+	simDma0.SEEI = SIM_DMA_NOP;
+	simDma0.CERR = SIM_DMA_NOP;
+
+	if((simSiren != 0u) && ((simDma0.ERQ & (1u << simSirenCh)) == 0u)){
+		SimSirenOff();
+	}
+	else{}
+	for(ch = 0u; ch < SIM_DMA_CHANNELS; ch++){
+		if((simDma0.TCD[ch].CSR & DMA_CSR_START_MASK) != 0u){
+			simDma0.TCD[ch].CSR &= (INT16U)~DMA_CSR_START_MASK;
+			SimDmaService(ch);
+		}
+		else{}
+	}
+}
+
+/*****************************************************************************
+ * SimDwtSync() - A CYCCNT write moves the offset, from the access it was
+ * 				  made through.  Done at the next DWT access instead of
+ * 				  through the dirty flags, as the cycle count reads SchedStat
+ * 				  times every task with are most of the firmware's accesses.
+ ******************************************************************************/
+static void SimDwtSync(void){
+	if(simDwt.CYCCNT != simDwtShadow){
+		simDwtOffset = simDwt.CYCCNT - (INT32U)simDwtAt;
+		simDwtShadow = simDwt.CYCCNT;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimSysTickSync() - Start the count from LOAD on ENABLE, stop without it.
+ * 					  Only the core clock source is modelled.
+ ******************************************************************************/
+static void SimSysTickSync(void){
+	INT8U run = (INT8U)((simSysTick.CTRL & SysTick_CTRL_ENABLE_Msk) != 0u);
+
+	if((run != 0u) && (simSysTickNext == SIM_NEVER)){
+		if((simSysTick.CTRL & SysTick_CTRL_CLKSOURCE_Msk) == 0u){
+			SimFail("SysTick modelled on the core clock only");
+		}
+		else{}
+		simSysTickNext = SimNow + (SIM_TIME_T)(simSysTick.LOAD & SysTick_LOAD_RELOAD_Msk) + 1u;
+	}
+	else if((run == 0u) && (simSysTickNext != SIM_NEVER)){
+		simSysTickNext = SIM_NEVER;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimDmaSource() - A peripheral request: every enabled channel routed to it.
+ ******************************************************************************/
+static void SimDmaSource(INT8U source){
+	INT8U ch;
+	INT8U cfg;
+
+	for(ch = 0u; ch < SIM_DMA_CHANNELS; ch++){
+		cfg = SimRegDmamux.CHCFG[ch];
+		if(((cfg & DMAMUX_CHCFG_ENBL_MASK) != 0u) && ((cfg & DMAMUX_CHCFG_SOURCE_MASK) == source)){
+			SimDmaRequest(ch);
+		}
+		else{}
+	}
+}
+
+/*****************************************************************************
+ * SimDmaRequest() - A hardware request, served if the channel's ERQ is set.
+ ******************************************************************************/
+static void SimDmaRequest(INT8U ch){
+	if((simDma0.ERQ & (1u << ch)) != 0u){
+		SimDmaService(ch);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimDmaService() - Run a minor loop and the channels it links to, then apply
+ * 					 what the transfers wrote into peripheral registers.  Only
+ * 					 the peripherals written are synced, most requests move
+ * 					 data to or from memory.
+ ******************************************************************************/
+static void SimDmaService(INT8U ch){
+	INT8U links = 0u;
+	INT8U next = ch;
+
+	simDmaDirty = 0u;
+	while(next != SIM_NO_CHANNEL){
+		links++;
+		if(links > SIM_DMA_LINK_MAX){
+			SimFail("DMA channel %u: channel links do not end", ch);
+		}
+		else{}
+		next = SimDmaMinor(next);
+	}
+	if(simDmaDirty != 0u){
+		SimPeriphSync(simDmaDirty);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * SimDmaMinor() - One minor loop of a channel and its major loop bookkeeping.
+ *
+ * 	Parameters: ch - DMA channel
+ * 	Returns: channel linked to, SIM_NO_CHANNEL for none
+ ******************************************************************************/
+static INT8U SimDmaMinor(INT8U ch){
+	DMA_TCD_Type *tcd = &simDma0.TCD[ch];
+	INT32U attr = tcd->ATTR;
+	INT8U ssize = SimDmaSize((attr & DMA_ATTR_SSIZE_MASK) >> DMA_ATTR_SSIZE_SHIFT);
+	INT8U dsize = SimDmaSize((attr & DMA_ATTR_DSIZE_MASK) >> DMA_ATTR_DSIZE_SHIFT);
+	INT32U smod = (attr & DMA_ATTR_SMOD_MASK) >> DMA_ATTR_SMOD_SHIFT;
+	INT32U dmod = (attr & DMA_ATTR_DMOD_MASK) >> DMA_ATTR_DMOD_SHIFT;
+	INT32U saddr = tcd->SADDR;
+	INT32U daddr = tcd->DADDR;
+	INT32U nbytes = tcd->NBYTES_MLNO;
+	INT16U citer = tcd->CITER_ELINKNO;
+	INT16U csr = tcd->CSR;
+	INT16U countmask = ((citer & SIM_CITER_ELINK_MASK) != 0u) ? SIM_CITER_LINK_COUNT_MASK : SIM_CITER_COUNT_MASK;
+	INT16U count = citer & countmask;
+	INT8U link = SIM_NO_CHANNEL;
+	INT32U moved;
+
+	if((ssize != dsize) || (count == 0u) || (nbytes == 0u) || ((nbytes % ssize) != 0u)){
+		SimFail("DMA channel %u: TCD not modelled (sizes %u/%u, NBYTES %u, CITER %u)", ch, ssize, dsize, nbytes, count);
+	}
+	else{}
+
+	simDmaCh = ch;
+	for(moved = 0u; moved < nbytes; moved += ssize){
+		SimMemWrite(daddr, dsize, SimMemRead(saddr, ssize));
+		saddr = SimDmaStep(saddr, (INT16S)tcd->SOFF, smod);
+		daddr = SimDmaStep(daddr, (INT16S)tcd->DOFF, dmod);
+	}
+	simDmaCh = SIM_NO_CHANNEL;
+	tcd->SADDR = saddr;
+	tcd->DADDR = daddr;
+
+	count--;
+	if(count != 0u){
+		tcd->CITER_ELINKNO = (INT16U)((citer & ~countmask) | count);
+		if((citer & SIM_CITER_ELINK_MASK) != 0u){
+			link = (INT8U)((citer >> SIM_CITER_LINKCH_SHIFT) & SIM_CHANNEL_MASK);
+		}
+		else{}
+	}
+	else{ //major loop done, the minor link gives way to the major one
+		if((csr & DMA_CSR_ESG_MASK) != 0u){
+			memcpy((void *)tcd, SimMemPtr(tcd->DLAST_SGA), SIM_DMA_TCD_BYTES);
+		}
+		else{
+			tcd->SADDR = saddr + tcd->SLAST;
+			tcd->DADDR = daddr + tcd->DLAST_SGA;
+			tcd->CITER_ELINKNO = tcd->BITER_ELINKNO;
+			tcd->CSR |= DMA_CSR_DONE_MASK;
+		}
+		if((csr & DMA_CSR_INTMAJOR_MASK) != 0u){
+			simDma0.INT |= 1u << ch;
+			SimIrqPend((IRQn_Type)(DMA0_DMA16_IRQn + (ch & 0x0fu)));
+		}
+		else{}
+		if((csr & DMA_CSR_DREQ_MASK) != 0u){
+			simDma0.ERQ &= ~(1u << ch);
+		}
+		else{}
+		if((csr & DMA_CSR_MAJORELINK_MASK) != 0u){
+			link = (INT8U)((csr & DMA_CSR_MAJORLINKCH_MASK) >> DMA_CSR_MAJORLINKCH_SHIFT);
+		}
+		else{}
+	}
+	return(link);
+}
+
+/*****************************************************************************
+ * SimDmaStep() - Add an offset keeping the address above the modulo bits.
+ ******************************************************************************/
+static INT32U SimDmaStep(INT32U addr, INT32S off, INT32U mod){
+	INT32U mask;
+	INT32U next = addr + (INT32U)off;
+
+	if(mod != 0u){
+		mask = (1u << mod) - 1u;
+		next = (addr & ~mask) | (next & mask);
+	}
+	else{}
+	return(next);
+}
+
+/*****************************************************************************
+ * SimDmaSize() - Bytes of an SSIZE/DSIZE code, 8, 16 and 32 bit only.
+ ******************************************************************************/
+static INT8U SimDmaSize(INT32U code){
+	INT8U size = 0u;
+
+	if(code <= 2u){
+		size = (INT8U)(1u << code);
+	}
+	else{}
+	return(size);
+}
+
+/*****************************************************************************
+ * SimMemRead(), SimMemWrite() - DMA accesses.  A read of the ADC result
+ * 								 clears COCO, a write to SC1A is a software
+ * 								 trigger, a write into DAC0 is the siren.
+ ******************************************************************************/
+static INT32U SimMemRead(INT32U addr, INT8U size){
+	void *p = SimMemPtr(addr);
+	INT32U val;
+
+	if(size == 1u){
+		val = *(volatile INT8U *)p;
+	}
+	else if(size == 2u){
+		val = *(volatile INT16U *)p;
+	}
+	else{
+		val = *(volatile INT32U *)p;
+	}
+	if(SimInside(addr, simAdc0.R, sizeof(simAdc0.R)) == TRUE){
+		simAdc0.SC1[0] &= ~ADC_SC1_COCO_MASK;
+	}
+	else{}
+	return(val);
+}
+
+static void SimMemWrite(INT32U addr, INT8U size, INT32U val){
+	void *p = SimMemPtr(addr);
+
+	if(size == 1u){
+		*(volatile INT8U *)p = (INT8U)val;
+	}
+	else if(size == 2u){
+		*(volatile INT16U *)p = (INT16U)val;
+	}
+	else{
+		*(volatile INT32U *)p = val;
+	}
+	if(SimInside(addr, &simAdc0.SC1[0], sizeof(simAdc0.SC1[0])) == TRUE){
+		simAdcSc1 = simAdc0.SC1[0] & ~ADC_SC1_COCO_MASK;
+		SimAdcSoftStart();
+	}
+	else{}
+	if(SimInside(addr, &simPit, sizeof(simPit)) == TRUE){
+		simDmaDirty |= SIM_DIRTY_PIT;
+	}
+	else if(SimInside(addr, &simLptmr0, sizeof(simLptmr0)) == TRUE){
+		simDmaDirty |= SIM_DIRTY_LPTMR;
+	}
+	else if(SimInside(addr, &simTsi0, sizeof(simTsi0)) == TRUE){
+		simDmaDirty |= SIM_DIRTY_TSI;
+	}
+	else if(SimInside(addr, &simAdc0, sizeof(simAdc0)) == TRUE){
+		simDmaDirty |= SIM_DIRTY_ADC;
+	}
+	else if(SimInside(addr, &simSysTick, sizeof(simSysTick)) == TRUE){
+		simDmaDirty |= SIM_DIRTY_SYSTICK;
+	}
+	else{}
+	if((SimInside(addr, &simDac0, sizeof(simDac0)) == TRUE) && (simSiren == 0u)){
+		simSiren = 1u;
+		simSirenCh = simDmaCh;
+		SimTrace("SIREN on");
+	}
+	else{}
+}
+
+static void *SimMemPtr(INT32U addr){
+	if(addr == 0u){
+		SimFail("DMA access to address 0");
+	}
+	else{}
+	return((void *)(uintptr_t)addr);
+}
+
+static INT8U SimInside(INT32U addr, const volatile void *block, INT32U bytes){
+	uintptr_t start = (uintptr_t)block;
+
+	return((INT8U)((addr >= start) && (addr < (start + bytes))));
+}
+
+/*****************************************************************************
+ * SimSirenOff() - The DMA feeding DAC0 stopped.
+ ******************************************************************************/
+static void SimSirenOff(void){
+	simSiren = 0u;
+	simSirenCh = SIM_NO_CHANNEL;
+	SimTrace("SIREN off");
+}
@@ -0,0 +1,456 @@
+/********************************************************************************
+* SimScript - Scenario player and sensor models of the security system
+* 			  simulator.
+*
+* 	A scenario is a text file of steps, one a line, in time order:
+*
+* 		<time> <command> [arguments]
+*
+* 	The time is a number with an optional unit, ms, s (the default), m or h,
+* 	and may have a fraction.  '#' starts a comment.  Commands:
+*
+* 		temp C				sensor temperature, degrees C
+* 		ramp C duration		move linearly from the present temperature to C
+* 		noise lsb			ADC noise, +/- lsb codes
+* 		touch 1|2 on|off	touch or release an electrode
+* 		pad 1|2 base delta	TSI count of an electrode, untouched and added by a touch
+* 		padnoise counts		TSI count noise, +/- counts
+* 		key K				press a key, A-D, 0-9, * or hash for #, which
+* 							would start a comment
+* 		seed n				noise generator seed
+* 		clockerr ppm		LPTMR0 count clock frequency error against the
+* 							core, + runs fast, as LPO or crystal drift
+* 		expect STATE		fail the run unless the system state is STATE,
+* 							ARMED, DISARMED or ALARM, so a step after a touch
+* 							bounds the touch to ALARM latency
+* 		end					end of the run, otherwise 10 s. after the last step
+*
+* 	Each step is traced as SCN with its text when it's applied.  A failed
+* 	expect stops the run with exit status 2, as make check sees.  The noise
+* 	comes from a fixed LCG so a scenario gives the same trace every run.
+*
+* 	The temperature sensor is the MCP9701 on ADC0 channel 3 the firmware's
+* 	table assumes, 0.4 V + 19.5 mV/C against a 3.3 V reference.  Electrode 1
+* 	is TSI channel 11, electrode 2 channel 12, as in Sense.c.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "MCUType.h"
+#include "Key.h"
+#include "Sim.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define SIM_SCRIPT_MAX_STEPS 1024u
+#define SIM_SCRIPT_LINE_LEN 128u
+#define SIM_SCRIPT_WORD_LEN 32u
+#define SIM_SCRIPT_TAIL_CYCLES (10ull*SIM_CORE_HZ) //run on after the last step
+#define SIM_TEMP_ADCH 3u
+#define SIM_TEMP_V0 0.4 //sensor output at 0 C
+#define SIM_TEMP_VPERC 0.0195
+#define SIM_VREF 3.3
+#define SIM_ADC_FULL 65536.0
+#define SIM_ADC_MAX 0xffff
+#define SIM_TSI_MAX 0xffff
+#define SIM_PADS 2u
+#define SIM_PAD1_CH 11u
+#define SIM_PAD2_CH 12u
+#define SIM_LCG_MUL 1103515245u
+#define SIM_LCG_ADD 12345u
+#define SIM_PPM_MIN (-999999) // clock error that still leaves a clock
+
+typedef enum{SCN_TEMP, SCN_RAMP, SCN_NOISE, SCN_TOUCH, SCN_PAD, SCN_PADNOISE, SCN_KEY,
+	SCN_SEED, SCN_CLOCKERR, SCN_EXPECT, SCN_END} SIM_SCN_CMD_T;
+
+typedef struct{
+	SIM_TIME_T time;
+	SIM_SCN_CMD_T cmd;
+	INT32U arg[3];
+	FP64 val;
+	SIM_TIME_T dur;
+	INT8C word[SIM_SCRIPT_WORD_LEN]; //expect state
+	INT8C text[SIM_SCRIPT_LINE_LEN];
+}SIM_SCN_STEP_T;
+
+typedef struct{
+	INT8U ch;
+	INT32U base;
+	INT32U delta;
+	INT8U touched;
+}SIM_PAD_T;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static SIM_SCN_STEP_T simSteps[SIM_SCRIPT_MAX_STEPS];
+static INT32U simNumSteps;
+static INT32U simStepNext; //first step not yet applied
+static FP64 simTempFrom = 22.0; //temperature at simRampStart
+static FP64 simTempTo = 22.0; //and at simRampEnd
+static SIM_TIME_T simRampStart;
+static SIM_TIME_T simRampEnd;
+static INT32U simAdcNoise;
+static INT32U simPadNoise;
+static INT32U simLcg = 1u;
+static SIM_PAD_T simPads[SIM_PADS] = {{SIM_PAD1_CH, 1000u, 400u, 0u}, {SIM_PAD2_CH, 8000u, 5000u, 0u}};
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT8U SimParseTime(const INT8C *strg, SIM_TIME_T *time);
+static INT8U SimParseStep(INT8C *line, SIM_SCN_STEP_T *step);
+static void SimApply(const SIM_SCN_STEP_T *step);
+static FP64 SimTempNow(void);
+static INT32S SimNoise(INT32U amp);
+static INT32S SimClamp(INT32S val, INT32S max);
+////////////////////////////////////////////////////////////////////////////////////////
+
+/*****************************************************************************
+ * SimScriptLoad() - Read and check a scenario.
+ *
+ * 	Parameters: path - scenario file
+ * 	Returns: end of the run
+ ******************************************************************************/
+SIM_TIME_T SimScriptLoad(const char *path){
+	FILE *file = fopen(path, "r");
+	INT8C line[SIM_SCRIPT_LINE_LEN];
+	INT32U lineno = 0u;
+	SIM_TIME_T last = 0u;
+	SIM_TIME_T end = SIM_NEVER;
+	INT8C *hash;
+
+	if(file == NULL){
+		SimFail("can't open scenario %s", path);
+	}
+	else{}
+	while(fgets(line, (int)sizeof(line), file) != NULL){
+		lineno++;
+		hash = strchr(line, '#');
+		if(hash != NULL){
+			*hash = '\0';
+		}
+		else{}
+		line[strcspn(line, "\r\n")] = '\0';
+		while((strlen(line) != 0u) && isspace((unsigned char)line[strlen(line) - 1u])){
+			line[strlen(line) - 1u] = '\0';
+		}
+		if(strspn(line, " \t") != strlen(line)){
+			if(simNumSteps == SIM_SCRIPT_MAX_STEPS){
+				SimFail("%s:%u: more than %u steps", path, lineno, SIM_SCRIPT_MAX_STEPS);
+			}
+			else{}
+			if(SimParseStep(line, &simSteps[simNumSteps]) == FALSE){
+				SimFail("%s:%u: bad step '%s'", path, lineno, line);
+			}
+			else{}
+			if(simSteps[simNumSteps].time < last){
+				SimFail("%s:%u: step before the one above it", path, lineno);
+			}
+			else{}
+			last = simSteps[simNumSteps].time;
+			if((simSteps[simNumSteps].cmd == SCN_END) && (end == SIM_NEVER)){
+				end = last;
+			}
+			else{}
+			simNumSteps++;
+		}
+		else{}
+	}
+	(void)fclose(file);
+	if(end == SIM_NEVER){
+		end = last + SIM_SCRIPT_TAIL_CYCLES;
+	}
+	else{}
+	return(end);
+}
+
+/*****************************************************************************
+ * SimScriptNext() - Time of the next step to apply.
+ ******************************************************************************/
+SIM_TIME_T SimScriptNext(void){
+	SIM_TIME_T next = SIM_NEVER;
+
+	if(simStepNext < simNumSteps){
+		next = simSteps[simStepNext].time;
+	}
+	else{}
+	return(next);
+}
+
+/*****************************************************************************
+ * SimScriptEvent() - Apply the steps due at SimNow.
+ ******************************************************************************/
+void SimScriptEvent(void){
+	while((simStepNext < simNumSteps) && (simSteps[simStepNext].time <= SimNow)){
+		SimApply(&simSteps[simStepNext]);
+		simStepNext++;
+	}
+}
+
+/*****************************************************************************
+ * SimScriptAdcCode() - The 16 bit result of a conversion at SimNow.
+ *
+ * 	Parameters: adch - ADC input channel
+ * 	Returns: result, 0 for an input with nothing on it
+ ******************************************************************************/
+INT16U SimScriptAdcCode(INT8U adch){
+	INT32S code = 0;
+	FP64 volts;
+
+	if(adch == SIM_TEMP_ADCH){
+		volts = SIM_TEMP_V0 + (SIM_TEMP_VPERC*SimTempNow());
+		code = (INT32S)((volts*SIM_ADC_FULL)/SIM_VREF) + SimNoise(simAdcNoise);
+		code = SimClamp(code, SIM_ADC_MAX);
+	}
+	else{}
+	return((INT16U)code);
+}
+
+/*****************************************************************************
+ * SimScriptTsiCount() - The count of a scan at SimNow.
+ *
+ * 	Parameters: tsich - TSI channel
+ * 	Returns: count, 0 for a channel with no electrode
+ ******************************************************************************/
+INT16U SimScriptTsiCount(INT8U tsich){
+	INT32S count = 0;
+	INT8U pad;
+
+	for(pad = 0u; pad < SIM_PADS; pad++){
+		if(simPads[pad].ch == tsich){
+			count = (INT32S)simPads[pad].base + SimNoise(simPadNoise);
+			if(simPads[pad].touched != 0u){
+				count += (INT32S)simPads[pad].delta;
+			}
+			else{}
+			count = SimClamp(count, SIM_TSI_MAX);
+		}
+		else{}
+	}
+	return((INT16U)count);
+}
+
+/*****************************************************************************
+ * SimParseStep() - One scenario line into a step.
+ *
+ * 	Parameters: line - the text, comment and newline removed
+ * 				step - filled in
+ * 	Returns: FALSE if the line isn't a step
+ ******************************************************************************/
+static INT8U SimParseStep(INT8C *line, SIM_SCN_STEP_T *step){
+	INT8C timestrg[32];
+	INT8C cmd[16];
+	INT8C a1[32] = "";
+	INT8C a2[32] = "";
+	INT8C a3[32] = "";
+	INT8C *text = line + strspn(line, " \t");
+	INT8U ok = FALSE;
+	int fields;
+
+	text += strcspn(text, " \t"); //the time is in the trace stamp
+	text += strspn(text, " \t");
+	(void)snprintf(step->text, sizeof(step->text), "%s", text);
+	fields = sscanf(line, "%31s %15s %31s %31s %31s", timestrg, cmd, a1, a2, a3);
+	if((fields >= 2) && (SimParseTime(timestrg, &step->time) == TRUE)){
+		if((strcmp(cmd, "temp") == 0) && (fields == 3)){
+			step->cmd = SCN_TEMP;
+			step->val = strtod(a1, NULL);
+			ok = TRUE;
+		}
+		else if((strcmp(cmd, "ramp") == 0) && (fields == 4)){
+			step->cmd = SCN_RAMP;
+			step->val = strtod(a1, NULL);
+			ok = SimParseTime(a2, &step->dur);
+		}
+		else if((strcmp(cmd, "noise") == 0) && (fields == 3)){
+			step->cmd = SCN_NOISE;
+			step->arg[0] = (INT32U)strtoul(a1, NULL, 0);
+			ok = TRUE;
+		}
+		else if((strcmp(cmd, "touch") == 0) && (fields == 4)){
+			step->cmd = SCN_TOUCH;
+			step->arg[0] = (INT32U)strtoul(a1, NULL, 0);
+			step->arg[1] = (INT32U)(strcmp(a2, "on") == 0);
+			ok = (INT8U)((step->arg[0] >= 1u) && (step->arg[0] <= SIM_PADS) && ((step->arg[1] != 0u) || (strcmp(a2, "off") == 0)));
+		}
+		else if((strcmp(cmd, "pad") == 0) && (fields == 5)){
+			step->cmd = SCN_PAD;
+			step->arg[0] = (INT32U)strtoul(a1, NULL, 0);
+			step->arg[1] = (INT32U)strtoul(a2, NULL, 0);
+			step->arg[2] = (INT32U)strtoul(a3, NULL, 0);
+			ok = (INT8U)((step->arg[0] >= 1u) && (step->arg[0] <= SIM_PADS));
+		}
+		else if((strcmp(cmd, "padnoise") == 0) && (fields == 3)){
+			step->cmd = SCN_PADNOISE;
+			step->arg[0] = (INT32U)strtoul(a1, NULL, 0);
+			ok = TRUE;
+		}
+		else if((strcmp(cmd, "key") == 0) && (fields == 3)){
+			step->cmd = SCN_KEY;
+			step->arg[0] = (INT32U)toupper((unsigned char)a1[0]);
+			if(strcmp(a1, "hash") == 0){
+				step->arg[0] = '#';
+				ok = TRUE;
+			}
+			else{
+				ok = (INT8U)((a1[1] == '\0') && (((step->arg[0] >= 'A') && (step->arg[0] <= 'D'))
+						|| (isdigit((int)step->arg[0]) != 0) || (step->arg[0] == '*')));
+			}
+		}
+		else if((strcmp(cmd, "seed") == 0) && (fields == 3)){
+			step->cmd = SCN_SEED;
+			step->arg[0] = (INT32U)strtoul(a1, NULL, 0);
+			ok = TRUE;
+		}
+		else if((strcmp(cmd, "clockerr") == 0) && (fields == 3)){
+			step->cmd = SCN_CLOCKERR;
+			step->arg[0] = (INT32U)strtol(a1, NULL, 0);
+			ok = (INT8U)((INT32S)step->arg[0] >= SIM_PPM_MIN);
+		}
+		else if((strcmp(cmd, "expect") == 0) && (fields == 3)){
+			step->cmd = SCN_EXPECT;
+			(void)snprintf(step->word, sizeof(step->word), "%s", a1);
+			ok = TRUE;
+		}
+		else if((strcmp(cmd, "end") == 0) && (fields == 2)){
+			step->cmd = SCN_END;
+			ok = TRUE;
+		}
+		else{}
+	}
+	else{}
+	return(ok);
+}
+
+/*****************************************************************************
+ * SimParseTime() - A time with an optional ms, s, m or h unit into cycles.
+ ******************************************************************************/
+static INT8U SimParseTime(const INT8C *strg, SIM_TIME_T *time){
+	INT8C *unit;
+	FP64 val = strtod(strg, &unit);
+	FP64 scale = -1.0;
+
+	if(unit != strg){
+		if((strcmp(unit, "") == 0) || (strcmp(unit, "s") == 0)){
+			scale = (FP64)SIM_CORE_HZ;
+		}
+		else if(strcmp(unit, "ms") == 0){
+			scale = (FP64)SIM_CORE_HZ/1000.0;
+		}
+		else if(strcmp(unit, "m") == 0){
+			scale = (FP64)SIM_CORE_HZ*60.0;
+		}
+		else if(strcmp(unit, "h") == 0){
+			scale = (FP64)SIM_CORE_HZ*3600.0;
+		}
+		else{}
+	}
+	else{}
+	if((scale > 0.0) && (val >= 0.0)){
+		*time = (SIM_TIME_T)((val*scale) + 0.5);
+	}
+	else{}
+	return((INT8U)((scale > 0.0) && (val >= 0.0)));
+}
+
+/*****************************************************************************
+ * SimApply() - Apply a step.
+ ******************************************************************************/
+static void SimApply(const SIM_SCN_STEP_T *step){
+	static const INT8C keys[] = {DC1, DC2, DC3, DC4};
+	SIM_PAD_T *pad = &simPads[(step->arg[0] - 1u) % SIM_PADS];
+
+	SimTrace("SCN %s", step->text);
+	switch(step->cmd){
+		case SCN_TEMP:
+			simTempFrom = step->val;
+			simTempTo = step->val;
+			simRampStart = SimNow;
+			simRampEnd = SimNow;
+			break;
+		case SCN_RAMP:
+			simTempFrom = SimTempNow();
+			simTempTo = step->val;
+			simRampStart = SimNow;
+			simRampEnd = SimNow + step->dur;
+			break;
+		case SCN_NOISE:
+			simAdcNoise = step->arg[0];
+			break;
+		case SCN_TOUCH:
+			pad->touched = (INT8U)step->arg[1];
+			break;
+		case SCN_PAD:
+			pad->base = step->arg[1];
+			pad->delta = step->arg[2];
+			break;
+		case SCN_PADNOISE:
+			simPadNoise = step->arg[0];
+			break;
+		case SCN_KEY:
+			if((step->arg[0] >= 'A') && (step->arg[0] <= 'D')){
+				SimKeyPush(keys[step->arg[0] - 'A']);
+			}
+			else{
+				SimKeyPush((INT8C)step->arg[0]);
+			}
+			break;
+		case SCN_SEED:
+			simLcg = step->arg[0];
+			break;
+		case SCN_CLOCKERR:
+			SimLptmrClockErr((INT32S)step->arg[0]);
+			break;
+		case SCN_EXPECT:
+			if(strcmp(SimBoardState(), step->word) != 0){
+				SimFail("expected %s, state is %s", step->word, SimBoardState());
+			}
+			else{}
+			break;
+		default: //SCN_END, SimCore stops the run
+			break;
+	}
+}
+
+/*****************************************************************************
+ * SimTempNow() - Sensor temperature at SimNow, degrees C.
+ ******************************************************************************/
+static FP64 SimTempNow(void){
+	FP64 temp = simTempTo;
+
+	if(SimNow < simRampEnd){
+		temp = simTempFrom + (((simTempTo - simTempFrom)*(FP64)(SimNow - simRampStart))/(FP64)(simRampEnd - simRampStart));
+	}
+	else{}
+	return(temp);
+}
+
+/*****************************************************************************
+ * SimNoise() - Uniform noise in -amp..amp from the LCG.
+ ******************************************************************************/
+static INT32S SimNoise(INT32U amp){
+	INT32S noise = 0;
+
+	if(amp != 0u){
+		simLcg = (simLcg*SIM_LCG_MUL) + SIM_LCG_ADD;
+		noise = (INT32S)((simLcg >> 16)%((2u*amp) + 1u)) - (INT32S)amp;
+	}
+	else{}
+	return(noise);
+}
+
+static INT32S SimClamp(INT32S val, INT32S max){
+	INT32S clamped = val;
+
+	if(val < 0){
+		clamped = 0;
+	}
+	else if(val > max){
+		clamped = max;
+	}
+	else{}
+	return(clamped);
+}
@@ -0,0 +1,17 @@
+/*******************************************************************************
+* BasicIO.h - Simulator stand-in for the BasicIO serial module.  Output goes to
+* 			  the trace as UART lines; there is no input.
+*
+*******************************************************************************/
+
+#ifndef BASICIO_H_
+#define BASICIO_H_
+
+#define BIO_BIT_RATE_9600 9600u
+
+void BIOOpen(INT32U bitrate);
+void BIOWrite(INT8C c);
+void BIOPutStrg(const INT8C *strg);
+void BIOOutDecWord(INT32U binword, INT8U field);
+
+#endif /* BASICIO_H_ */
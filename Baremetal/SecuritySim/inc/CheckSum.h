@@ -0,0 +1,12 @@
+/*******************************************************************************
+* CheckSum.h - Simulator stand-in for the flash checksum module.  There is no
+* 			   flash image on the host, so the sum is a fixed value.
+*
+*******************************************************************************/
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+INT16U CSCalc(INT8U *startaddr, INT8U *endaddr);
+
+#endif /* CHECKSUM_H_ */
@@ -0,0 +1,15 @@
+/*******************************************************************************
+* K65TWR_ClkCfg.h - Simulator stand-in for the K65TWR clock setup.  The
+* 					simulated clocks are fixed at the values it programs.
+*
+*******************************************************************************/
+
+#ifndef K65TWR_CLKCFG_H_
+#define K65TWR_CLKCFG_H_
+
+#define SYSTEM_CLOCK 180000000u
+#define BUS_CLOCK 60000000u
+
+void K65TWR_BootClock(void);
+
+#endif /* K65TWR_CLKCFG_H_ */
@@ -0,0 +1,38 @@
+/*******************************************************************************
+* K65TWR_GPIO.h - Simulator stand-in for the K65TWR GPIO header.  The LEDs go
+* 				  to the trace, the debug bits compile away.
+*
+*******************************************************************************/
+
+#ifndef K65TWR_GPIO_H_
+#define K65TWR_GPIO_H_
+
+void SimLedSet(INT8U led, INT8U on);
+
+#define LED8_TURN_ON() SimLedSet(8u, 1u)
+#define LED8_TURN_OFF() SimLedSet(8u, 0u)
+#define LED9_TURN_ON() SimLedSet(9u, 1u)
+#define LED9_TURN_OFF() SimLedSet(9u, 0u)
+
+#define DB0_TURN_ON() ((void)0)
+#define DB0_TURN_OFF() ((void)0)
+#define DB1_TURN_ON() ((void)0)
+#define DB1_TURN_OFF() ((void)0)
+#define DB2_TURN_ON() ((void)0)
+#define DB2_TURN_OFF() ((void)0)
+#define DB3_TURN_ON() ((void)0)
+#define DB3_TURN_OFF() ((void)0)
+#define DB4_TURN_ON() ((void)0)
+#define DB4_TURN_OFF() ((void)0)
+#define DB5_TURN_ON() ((void)0)
+#define DB5_TURN_OFF() ((void)0)
+#define DB6_TURN_ON() ((void)0)
+#define DB6_TURN_OFF() ((void)0)
+#define DB7_TURN_ON() ((void)0)
+#define DB7_TURN_OFF() ((void)0)
+
+void GpioDBugBitsInit(void);
+void GpioLED8Init(void);
+void GpioLED9Init(void);
+
+#endif /* K65TWR_GPIO_H_ */
@@ -0,0 +1,20 @@
+/*******************************************************************************
+* Key.h - Simulator stand-in for the keypad module.  Key presses come from the
+* 		  scenario; A-D are returned as DC1-DC4 like the real keypad, the
+* 		  digits, * and # as their characters.
+*
+*******************************************************************************/
+
+#ifndef KEY_H_
+#define KEY_H_
+
+#define DC1 0x11
+#define DC2 0x12
+#define DC3 0x13
+#define DC4 0x14
+
+void KeyInit(void);
+void KeyTask(void);
+INT8C KeyGet(void);
+
+#endif /* KEY_H_ */
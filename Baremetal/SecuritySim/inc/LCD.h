@@ -0,0 +1,19 @@
+/*******************************************************************************
+* LCD.h - Simulator stand-in for the 2x16 character LCD module.  Writes go to a
+* 		  display buffer that the trace prints whenever a line changes, and
+* 		  each character is charged the controller's write time.
+*
+*******************************************************************************/
+
+#ifndef LCD_H_
+#define LCD_H_
+
+void LcdInit(void);
+void LcdClrLine(INT8U line);
+void LcdMoveCursor(INT8U row, INT8U col);
+void LcdDispChar(INT8C c);
+void LcdDispStrg(const INT8C *strg);
+void LcdDispByte(INT8U b);
+void LcdDispDecWord(INT32U binword, INT8U field);
+
+#endif /* LCD_H_ */
@@ -0,0 +1,27 @@
+/*******************************************************************************
+* MCUType.h - Simulator stand-in for the K65 project types header.  Same type
+* 			  names and widths as on the target, on the simulated device header.
+*
+*******************************************************************************/
+
+#ifndef MCUTYPE_H_
+#define MCUTYPE_H_
+
+#include "MK65F18.h"
+
+typedef char INT8C;
+typedef unsigned char INT8U;
+typedef signed char INT8S;
+typedef unsigned short INT16U;
+typedef signed short INT16S;
+typedef unsigned int INT32U;
+typedef signed int INT32S;
+typedef unsigned long long INT64U;
+typedef signed long long INT64S;
+typedef float FP32;
+typedef double FP64;
+
+#define FALSE 0
+#define TRUE 1
+
+#endif /* MCUTYPE_H_ */
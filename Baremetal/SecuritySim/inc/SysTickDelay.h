@@ -0,0 +1,15 @@
+/*******************************************************************************
+* SysTickDelay.h - Simulator stand-in for the SysTick delay module.  Init
+* 				   starts the 1 mS. tick interrupt as the module does, so it
+* 				   wakes WFI until the firmware stops it; delays advance
+* 				   simulated time and fail the run while it is stopped.
+*
+*******************************************************************************/
+
+#ifndef SYSTICKDELAY_H_
+#define SYSTICKDELAY_H_
+
+INT32U SysTickDlyInit(void);
+void SysTickDelay(INT32U ms);
+
+#endif /* SYSTICKDELAY_H_ */
@@ -0,0 +1,208 @@
+/********************************************************************************
+* FiltTest - Host test of the TSIFilter touch decision filter against scan
+* 			 traces.
+*
+* 		filttest trace...
+*
+* 	A trace is a text file of steps, one a line, run on one filter.  '#' starts
+* 	a comment.  Steps:
+*
+* 		init count press release	TSIFiltInit() at the calibration count
+* 		scan count [xN] [=S]		N scans of count (1), each returning S
+* 		ramp from to xN [=S]		N scans moving linearly from from to to
+* 		expect state S				debounced state now, 1 touched
+* 		expect base lo hi			baseline count within lo - hi
+* 		expect idle 0|1				TSIFiltIdle()
+*
+* 	Prints "trace: ok" or the first failed step and exits 1 if any trace
+* 	failed, 2 if one can't be read.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "MCUType.h"
+#include "TSIFilter.h"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define FILT_LINE_LEN 128u
+#define FILT_MAX_WORDS 6u
+#define FILT_ANY_STATE 0xffu
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT32U FiltRunTrace(const char *path);
+static INT32U FiltSplit(char *line, char **words);
+static INT32U FiltScans(TSI_FILT_T *filt, INT32U from, INT32U to, char **words, INT32U nwords,
+	const char *where);
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv){
+	int arg;
+	INT32U status = 0u;
+	INT32U result;
+
+	if(argc < 2){
+		fprintf(stderr, "usage: filttest trace...\n");
+		status = 1u;
+	}
+	else{}
+	for(arg = 1; arg < argc; arg++){
+		result = FiltRunTrace(argv[arg]);
+		if(result > status){
+			status = result;
+		}
+		else{}
+	}
+	return((int)status);
+}
+
+/*****************************************************************************
+ * FiltRunTrace() - Play one trace.
+ *
+ * 	Parameters: path - trace file
+ * 	Returns: 0 passed, 1 failed, 2 unreadable
+ ******************************************************************************/
+static INT32U FiltRunTrace(const char *path){
+	FILE *file;
+	char line[FILT_LINE_LEN];
+	char where[FILT_LINE_LEN + 16u];
+	char *words[FILT_MAX_WORDS];
+	TSI_FILT_T filt;
+	INT32U nwords;
+	INT32U lineno = 0u;
+	INT32U status = 0u;
+	INT32U lo;
+	INT32U hi;
+	INT32U got;
+
+	file = fopen(path, "r");
+	if(file == NULL){
+		fprintf(stderr, "%s: can't open\n", path);
+		status = 2u;
+	}
+	else{
+		TSIFiltInit(&filt, 0u, 0u, 0u);
+		while((status == 0u) && (fgets(line, sizeof(line), file) != NULL)){
+			lineno++;
+			(void)snprintf(where, sizeof(where), "%s:%u", path, lineno);
+			nwords = FiltSplit(line, words);
+			if(nwords == 0u){
+				//blank or comment line
+			}
+			else if((strcmp(words[0], "init") == 0) && (nwords == 4u)){
+				TSIFiltInit(&filt, (INT16U)strtoul(words[1], NULL, 0), (INT16U)strtoul(words[2], NULL, 0),
+					(INT16U)strtoul(words[3], NULL, 0));
+			}
+			else if((strcmp(words[0], "scan") == 0) && (nwords >= 2u)){
+				lo = (INT32U)strtoul(words[1], NULL, 0);
+				status = FiltScans(&filt, lo, lo, &words[2], nwords - 2u, where);
+			}
+			else if((strcmp(words[0], "ramp") == 0) && (nwords >= 4u)){
+				status = FiltScans(&filt, (INT32U)strtoul(words[1], NULL, 0), (INT32U)strtoul(words[2], NULL, 0),
+					&words[3], nwords - 3u, where);
+			}
+			else if((strcmp(words[0], "expect") == 0) && (nwords >= 3u)){
+				lo = (INT32U)strtoul(words[2], NULL, 0);
+				hi = (nwords > 3u) ? (INT32U)strtoul(words[3], NULL, 0) : lo;
+				if(strcmp(words[1], "state") == 0){
+					got = filt.state;
+				}
+				else if(strcmp(words[1], "base") == 0){
+					got = TSIFiltBaseline(&filt);
+				}
+				else if(strcmp(words[1], "idle") == 0){
+					got = TSIFiltIdle(&filt);
+				}
+				else{
+					lo = 1u; //unknown, always fails
+					hi = 0u;
+					got = 0u;
+				}
+				if((got < lo) || (got > hi)){
+					printf("%s: expected %s %u-%u, got %u\n", where, words[1], lo, hi, got);
+					status = 1u;
+				}
+				else{}
+			}
+			else{
+				printf("%s: bad step %s\n", where, words[0]);
+				status = 2u;
+			}
+		}
+		(void)fclose(file);
+		if(status == 0u){
+			printf("%s: ok\n", path);
+		}
+		else{}
+	}
+	return(status);
+}
+
+/*****************************************************************************
+ * FiltScans() - Run the scans of a scan or ramp step.
+ *
+ * 	Parameters: filt - filter under test
+ * 				from, to - first and last count, equal for a scan step
+ * 				words - the optional xN and =S words
+ * 				where - file:line for a failure
+ * 	Returns: 0 passed, 1 a scan returned the wrong state
+ ******************************************************************************/
+static INT32U FiltScans(TSI_FILT_T *filt, INT32U from, INT32U to, char **words, INT32U nwords,
+	const char *where){
+	INT32U scans = 1u;
+	INT32U state = FILT_ANY_STATE;
+	INT32U word;
+	INT32U scan;
+	INT32U count;
+	INT32U got;
+	INT32U status = 0u;
+
+	for(word = 0u; word < nwords; word++){
+		if(words[word][0] == 'x'){
+			scans = (INT32U)strtoul(&words[word][1], NULL, 0);
+		}
+		else if(words[word][0] == '='){
+			state = (INT32U)strtoul(&words[word][1], NULL, 0);
+		}
+		else{}
+	}
+	for(scan = 0u; (scan < scans) && (status == 0u); scan++){
+		if(scans > 1u){
+			count = (INT32U)((INT32S)from + (((INT32S)to - (INT32S)from)*(INT32S)scan)/((INT32S)scans - 1));
+		}
+		else{
+			count = from;
+		}
+		got = TSIFiltUpdate(filt, (INT16U)count);
+		if((state != FILT_ANY_STATE) && (got != state)){
+			printf("%s: scan %u of %u, count %u: expected state %u, got %u\n", where, scan + 1u, scans,
+				count, state, got);
+			status = 1u;
+		}
+		else{}
+	}
+	return(status);
+}
+
+/*****************************************************************************
+ * FiltSplit() - Split a line into words, dropping the comment.
+ *
+ * 	Returns: number of words
+ ******************************************************************************/
+static INT32U FiltSplit(char *line, char **words){
+	INT32U nwords = 0u;
+	char *word;
+
+	line[strcspn(line, "#")] = '\0';
+	word = strtok(line, " \t\r\n");
+	while((word != NULL) && (nwords < FILT_MAX_WORDS)){
+		words[nwords] = word;
+		nwords++;
+		word = strtok(NULL, " \t\r\n");
+	}
+	return(nwords);
+}
@@ -0,0 +1,116 @@
+/********************************************************************************
+* LogTest - Host check of the temperature log's window queries.  Readings that
+* 			swing by more than a step holds are logged through several wraps
+* 			of the bucket ring, and after each bucket every window
+* 			TempLogStats() accepts is compared with a scan of the readings
+* 			kept here, and every window past the log must be refused.
+*
+* 		logtest
+*
+* 	TempLog.c is included so its bucket tables can be read; the rest of the
+* 	security system is linked from the simulator build.  Exits 1 on the first
+* 	mismatch.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include "TempLog.c"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define LOG_TEST_READINGS (TEMP_LOG_BUCKET_SAMPS*TEMP_LOG_BUCKETS*3u + 21u)
+#define LOG_TEST_SWING 400 // tenths, more than TEMP_LOG_STEP_MAX
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static INT16S logTestVal[LOG_TEST_READINGS];
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT32U LogTestWindows(INT32U logged);
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void){
+	INT32U ind;
+	INT32U seed = 1u;
+	INT32U windows = 0u;
+	INT32U checked;
+	int status = 0;
+
+	TempLogInit();
+	for(ind = 0u; (ind < LOG_TEST_READINGS) && (status == 0); ind++){
+		seed = (seed*1103515245u) + 12345u;
+		logTestVal[ind] = (INT16S)((INT32S)((seed >> 16) % (2u*LOG_TEST_SWING)) - LOG_TEST_SWING);
+		TempLogAdd(logTestVal[ind]);
+		if((((ind + 1u) % TEMP_LOG_BUCKET_SAMPS) == 1u) || (ind == (LOG_TEST_READINGS - 1u))){
+			checked = LogTestWindows(ind + 1u);
+			if(checked == 0u){
+				status = 1;
+			}
+			else{}
+			windows += checked;
+		}
+		else{}
+	}
+
+	if(status == 0){
+		printf("log windows: %u windows ok\n", windows);
+	}
+	else{
+		printf("log windows: FAILED after %u readings\n", ind);
+	}
+	return(status);
+}
+
+/*****************************************************************************
+ * LogTestWindows() - Check every window of the log against logTestVal[], and
+ * 					  that each bucket's keyframe is its first reading.
+ *
+ * 	Parameters: logged - readings logged so far
+ * 	Returns: windows checked, 0 on a mismatch
+ ******************************************************************************/
+static INT32U LogTestWindows(INT32U logged){
+	TEMP_LOG_STATS_T stats;
+	INT32U headfirst = ((logged - 1u)/TEMP_LOG_BUCKET_SAMPS)*TEMP_LOG_BUCKET_SAMPS;
+	INT32U first;
+	INT32U last;
+	INT32U ind;
+	INT32S sum;
+	INT16S min;
+	INT16S max;
+	INT16U oldest;
+	INT16U newest;
+	INT32U checked = 0u;
+	INT8U ok = TRUE;
+
+	for(oldest = 0u; (oldest <= TEMP_LOG_BUCKETS) && (ok == TRUE); oldest++){
+		for(newest = 0u; (newest <= oldest) && (ok == TRUE); newest++){
+			if(((INT32U)oldest*TEMP_LOG_BUCKET_SAMPS) > headfirst){ //before the first reading
+				ok = (INT8U)(TempLogStats((INT8U)newest, (INT8U)oldest, &stats) == FALSE);
+			}
+			else if(oldest >= TEMP_LOG_BUCKETS){ //overwritten
+				ok = (INT8U)(TempLogStats((INT8U)newest, (INT8U)oldest, &stats) == FALSE);
+			}
+			else{
+				first = headfirst - ((INT32U)oldest*TEMP_LOG_BUCKET_SAMPS);
+				last = (newest == 0u) ? logged : (headfirst - (((INT32U)newest - 1u)*TEMP_LOG_BUCKET_SAMPS));
+				min = logTestVal[first];
+				max = logTestVal[first];
+				sum = 0;
+				for(ind = first; ind < last; ind++){
+					min = (logTestVal[ind] < min) ? logTestVal[ind] : min;
+					max = (logTestVal[ind] > max) ? logTestVal[ind] : max;
+					sum += logTestVal[ind];
+				}
+				ok = (INT8U)((TempLogStats((INT8U)newest, (INT8U)oldest, &stats) == TRUE)
+					&& (stats.min == min) && (stats.max == max) && (stats.count == (last - first))
+					&& (stats.avg == (INT16S)(sum/(INT32S)(last - first)))
+					&& (TempLogDecode((INT8U)((tempLogHead + TEMP_LOG_BUCKETS - oldest) % TEMP_LOG_BUCKETS), 0u, 0)
+						== logTestVal[first]));
+				checked++;
+			}
+		}
+	}
+	return((ok == TRUE) ? checked : 0u);
+}
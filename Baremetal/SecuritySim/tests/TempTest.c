@@ -0,0 +1,107 @@
+/********************************************************************************
+* TempTest - Host sweep of the temperature conversion.  Every 16 bit ADC code
+* 			 goes through TempCodeToDeciC() and the fahrenheit path and is
+* 			 compared with the sensor line worked in double precision.
+*
+* 		temptest
+*
+* 	Temp.c is included so its static conversion functions can be called; the
+* 	rest of the security system is linked from the simulator build so Temp.c
+* 	links as it is.  Prints the worst error of each unit and the host cycles
+* 	per conversion, and exits 1 if an error is over TEMP_TEST_MAX_ERR.
+*
+* 	TEMP_TEST_MAX_ERR is half a tenth, the output rounding, plus TEMP_TEST_SLACK
+* 	Q16 counts for the fixed point path: an exact value within a few Q16 counts
+* 	of a rounding tie can round either way.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <math.h>
+#include "Temp.c"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define TEMP_TEST_CODES 65536u
+#define TEMP_TEST_SLACK 8.0 // Q16 counts
+#define TEMP_TEST_MAX_ERR (0.5 + (TEMP_TEST_SLACK/65536.0)) // tenths
+#define TEMP_TEST_VREF 3.3
+#define TEMP_TEST_V0 0.4 // sensor output at 0 C
+#define TEMP_TEST_VPERC 0.0195
+#define TEMP_TEST_PASSES 100u // sweeps timed for the cycle count
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static INT64U TempTestCycles(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void){
+	INT32U code;
+	INT32U pass;
+	INT32U worstccode = 0u;
+	INT32U worstfcode = 0u;
+	FP64 refc;
+	FP64 errc;
+	FP64 errf;
+	FP64 maxc = 0.0;
+	FP64 maxf = 0.0;
+	INT64U start;
+	INT64U cycles;
+	volatile INT32S sink = 0;
+	int status = 0;
+
+	for(code = 0u; code < TEMP_TEST_CODES; code++){
+		refc = ((((FP64)code*TEMP_TEST_VREF)/TEMP_TEST_CODES) - TEMP_TEST_V0)/TEMP_TEST_VPERC*10.0;
+		errc = fabs((FP64)TempCodeToDeciC((INT16U)code) - refc);
+		errf = fabs((FP64)TempQ16ToDeciF(TempCodeToQ16((INT16U)code)) - ((refc*9.0/5.0) + 320.0));
+		if(errc > maxc){
+			maxc = errc;
+			worstccode = code;
+		}
+		else{}
+		if(errf > maxf){
+			maxf = errf;
+			worstfcode = code;
+		}
+		else{}
+	}
+
+	start = TempTestCycles();
+	for(pass = 0u; pass < TEMP_TEST_PASSES; pass++){
+		for(code = 0u; code < TEMP_TEST_CODES; code++){
+			sink += TempCodeToDeciC((INT16U)code);
+		}
+	}
+	cycles = TempTestCycles() - start;
+
+	printf("temp sweep: C max error %.6f tenths at code %u, F max error %.6f tenths at code %u\n",
+		maxc, worstccode, maxf, worstfcode);
+	printf("temp sweep: %.1f host cycles per conversion\n",
+		(FP64)cycles/((FP64)TEMP_TEST_PASSES*TEMP_TEST_CODES));
+	if((maxc > TEMP_TEST_MAX_ERR) || (maxf > TEMP_TEST_MAX_ERR)){
+		printf("temp sweep: FAILED, limit %.6f tenths\n", TEMP_TEST_MAX_ERR);
+		status = 1;
+	}
+	else{
+		printf("temp sweep: ok\n");
+	}
+	return(status);
+}
+
+/*****************************************************************************
+ * TempTestCycles() - Host cycle counter, the time stamp counter on x86 and
+ * 					  nanoseconds elsewhere.
+ ******************************************************************************/
+static INT64U TempTestCycles(void){
+	INT64U now;
+#if defined(__x86_64__) || defined(__i386__)
+	now = __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = ((INT64U)ts.tv_sec*1000000000u) + (INT64U)ts.tv_nsec;
+#endif
+	return(now);
+}
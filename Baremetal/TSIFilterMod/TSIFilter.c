@@ -0,0 +1,130 @@
+/*******************************************************************************
+* TSIFilter.c - Touch decision filter for one TSI electrode.
+*
+* 	The baseline is an exponential average kept scaled by 2^TSI_FILT_SHIFT,
+* 	basefx += count - basefx/2^TSI_FILT_SHIFT, so it has no truncation drift.
+* 	It only moves on released scans with a released decision, so a finger
+* 	held on the pad is never averaged into the baseline.  Everything is
+* 	shifts, adds and compares; one update is a few dozen cycles.
+*
+*******************************************************************************/
+#include "MCUType.h"
+#include "TSIFilter.h"
+
+#define TSI_FILT_MASK ((1u << TSI_FILT_M) - 1u)
+#define TSI_FILT_MAX_COUNT 0xffffu
+
+static INT16U tsiFiltAdd(INT16U base, INT16U offset);
+static INT8U tsiFiltOnes(INT8U bits);
+
+/*****************************************************
+ * TSIFiltInit() - Start released at the calibration count.
+ *****************************************************/
+void TSIFiltInit(TSI_FILT_T *filt, INT16U count, INT16U pressoffset, INT16U releaseoffset){
+	filt->basefx = (INT32U)count << TSI_FILT_SHIFT;
+	filt->pressoffset = pressoffset;
+	filt->releaseoffset = releaseoffset;
+	filt->history = 0u;
+	filt->state = 0u;
+}
+
+/*****************************************************
+ * TSIFiltUpdate() - Decide the scan against the current
+ * 					 level, debounce, then track the baseline
+ * 					 if released.
+ *****************************************************/
+INT8U TSIFiltUpdate(TSI_FILT_T *filt, INT16U count){
+	INT8U raw;
+	INT8U ones;
+
+	if(count >= TSIFiltLevel(filt)){
+		raw = 1u;
+	}
+	else{
+		raw = 0u;
+	}
+	filt->history = (INT8U)(((filt->history << 1) | raw) & TSI_FILT_MASK);
+	ones = tsiFiltOnes(filt->history);
+
+	if((filt->state == 0u) && (ones >= TSI_FILT_N)){
+		filt->state = 1u;
+	}
+	else if((filt->state != 0u) && (ones <= (TSI_FILT_M - TSI_FILT_N))){
+		filt->state = 0u;
+	}
+	else{}
+
+	if((filt->state == 0u) && (raw == 0u)){
+		filt->basefx = filt->basefx + count - (filt->basefx >> TSI_FILT_SHIFT);
+	}
+	else{}
+
+	return(filt->state);
+}
+
+/*****************************************************
+ * TSIFiltLevel() - Press level released, release level
+ * 					touched.
+ *****************************************************/
+INT16U TSIFiltLevel(const TSI_FILT_T *filt){
+	INT16U level;
+
+	if(filt->state == 0u){
+		level = tsiFiltAdd(TSIFiltBaseline(filt), filt->pressoffset);
+	}
+	else{
+		level = tsiFiltAdd(TSIFiltBaseline(filt), filt->releaseoffset);
+	}
+	return(level);
+}
+
+/*****************************************************
+ * TSIFiltBaseline() - Baseline in counts.
+ *****************************************************/
+INT16U TSIFiltBaseline(const TSI_FILT_T *filt){
+	return((INT16U)(filt->basefx >> TSI_FILT_SHIFT));
+}
+
+/*****************************************************
+ * TSIFiltIdle() - Released and nothing pending in the
+ * 				   debounce window.
+ *****************************************************/
+INT8U TSIFiltIdle(const TSI_FILT_T *filt){
+	INT8U idle;
+
+	if((filt->state == 0u) && (filt->history == 0u)){
+		idle = TRUE;
+	}
+	else{
+		idle = FALSE;
+	}
+	return(idle);
+}
+
+/*****************************************************
+ * tsiFiltAdd() - base + offset, saturated at the largest
+ * 				  TSICNT so a level can't wrap below the
+ * 				  baseline.
+ *****************************************************/
+static INT16U tsiFiltAdd(INT16U base, INT16U offset){
+	INT32U sum = (INT32U)base + offset;
+
+	if(sum > TSI_FILT_MAX_COUNT){
+		sum = TSI_FILT_MAX_COUNT;
+	}
+	else{}
+	return((INT16U)sum);
+}
+
+/*****************************************************
+ * tsiFiltOnes() - Number of set bits in the window.
+ *****************************************************/
+static INT8U tsiFiltOnes(INT8U bits){
+	INT8U ones = 0u;
+
+	while(bits != 0u){
+		ones += (INT8U)(bits & 1u);
+		bits >>= 1;
+	}
+	return(ones);
+}
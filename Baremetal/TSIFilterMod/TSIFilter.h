@@ -0,0 +1,66 @@
+/*******************************************************************************
+* TSIFilter.h - Touch decision filter for one TSI electrode.  Tracks the
+* 				untouched count with an integer IIR baseline that is frozen
+* 				while touched, decides touch against a press level and
+* 				release with a lower release level (hysteresis), and
+* 				debounces the decisions N of the last M scans.
+*
+*******************************************************************************/
+
+#ifndef TSIFILTER_H_
+#define TSIFILTER_H_
+
+#define TSI_FILT_SHIFT 6u // baseline IIR weight 1/2^6 per untouched scan
+#define TSI_FILT_M 5u // debounce window, scans
+#define TSI_FILT_N 3u // touched decisions in the window to press, released to release
+
+/*****************************************************
+ * TSI_FILT_T - filter state for one electrode.
+ *
+ * 	-basefx: baseline count << TSI_FILT_SHIFT
+ * 	-pressoffset: counts above baseline to press
+ * 	-releaseoffset: counts above baseline to stay pressed
+ * 	-history: last TSI_FILT_M raw decisions, bit 0 newest
+ * 	-state: debounced state, 1 touched
+ *****************************************************/
+typedef struct{
+	INT32U basefx;
+	INT16U pressoffset;
+	INT16U releaseoffset;
+	INT8U history;
+	INT8U state;
+}TSI_FILT_T;
+
+/*****************************************************
+ * Start the filter released with the baseline at count,
+ * the calibration scan.  releaseoffset should be below
+ * pressoffset.
+ *****************************************************/
+void TSIFiltInit(TSI_FILT_T *filt, INT16U count, INT16U pressoffset, INT16U releaseoffset);
+
+/*****************************************************
+ * Run one scan count through the filter.  Returns the
+ * debounced state, 1 touched.
+ *****************************************************/
+INT8U TSIFiltUpdate(TSI_FILT_T *filt, INT16U count);
+
+/*****************************************************
+ * Count a scan must reach to be a touched decision:
+ * the press level when released, the release level when
+ * touched.  Used for the hardware wake thresholds.
+ *****************************************************/
+INT16U TSIFiltLevel(const TSI_FILT_T *filt);
+
+/*****************************************************
+ * Current baseline count.
+ *****************************************************/
+INT16U TSIFiltBaseline(const TSI_FILT_T *filt);
+
+/*****************************************************
+ * TRUE when released with no touched decision left in
+ * the debounce window, so nothing can change without a
+ * count above the press level.
+ *****************************************************/
+INT8U TSIFiltIdle(const TSI_FILT_T *filt);
+
+#endif /* TSIFILTER_H_ */
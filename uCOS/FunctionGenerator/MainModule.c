@@ -4,12 +4,23 @@
 *  is centered at 1.65V with Vpk=0 to 1.5V, selectable with a resolution of 21 steps using
 *  the TSI touch sensors. Frequency is entered using the keypad and saved with the '#' key,
 *  modified with the 'D' key.  Waveform type is selected with the A (sine) and B(ramp)
-*  keys. The current state of the waveform is displayed to the LCD as described below.
+*  keys. The C key steps the modulation through off, AM and FM with a sine modulator at
+*  MOD_DEPTH percent; an entry of MOD_MAX_FREQ or less sets the modulator frequency.
+*  The current state of the waveform is displayed to the LCD as described below.
+*
+*  The '*' key makes the next key a command, its result shown on the bottom row until
+*  the key after it:
+*   *1 - *9 - arm a burst of 1-9 cycles, played on each SW2 press, not while one plays
+*   *0 - leave burst mode, continuous output
+*   *# - burst latency, L last and J max - min, in bus cycles from the SW2 edge
+*   *A - WaveTask wake latency, W worst in uS, and O half buffers it missed
+*   *B - TSI ISR cost, C worst in CPU_TS counts, and D touch events dropped
 *
 *  LCD Display Scheme:
 *   Left side, top row - frequency of output signal
 *   Left side, bottom row - desired frequency
 *   Right side, top row - waveform amplitude (0-20)
+*   Middle, bottom row - modulation (AM, FM or blank)
 *   Right side, bottom row - waveform type (SIN or TRI)
 *
 *  For an amplitude of 0, 1.65V DC is output from the generator. At high frequencies, the
@@ -19,8 +30,8 @@
 *  Debug bits are defined as follows (in ascending order of assertion rate):
 *   DB0 - WaveTask - runs every 1.3ms (64 samples in half Ping-Pong buffer * 1/48kHz sample rate)
 *   DB1 - KeyTask - set to run every 8ms
-*   DB2 - TSITask - set to run every 8ms
-*   DB3 - TSIProcTask - runs every two TSI scans (16ms)
+*   DB2 - TSI0_IRQHandler - runs at the end of every electrode scan
+*   DB3 - TSIProcTask - runs after a TSI scan set that changed an electrode state
 *   DB4 - UITask - runs on every keypress
 *   DB5 - LcdLayeredTask - runs on every write to LCD
 *
@@ -36,6 +47,8 @@
 #include "uCOSKey.h"
 #include "TSIModule.h"
 #include "WaveModule.h"
+#include "BasicIO.h"
+#include "ResAlloc.h"
 
 /********************************************************************
 * Module Defines
@@ -43,6 +56,7 @@
 // KEY MODULE
 #define KEYPAD_A_BUTTON 0x11U
 #define KEYPAD_B_BUTTON 0x12U
+#define KEYPAD_C_BUTTON 0x13U
 #define KEYPAD_D_BUTTON 0x14U
 // LCD MODULE
 #define CURSOR_FORWARD 1U
@@ -58,13 +72,18 @@
 // AppTSIProcTask()
 #define AMPL_INCREMENT 0U
 #define AMPL_DECREMENT 1U
-#define DEASSERTED 0U
-#define ASSERTED 1U
-#define DOWNPRESS 0U // TSI left index
-#define UPPRESS 1U   // TSI right index
+#define DOWNPRESS TSI_RIGHT // TSI electrode index
+#define UPPRESS TSI_LEFT    // TSI electrode index
+#define SWIPE_STEP_DIV 2U   // swipe speed in pads/s per amplitude step
 // UpdateAmp()
 #define MAX_AMPL 20u
 #define MIN_AMPL 0u
+// AppUITask() commands
+#define CMD_KEY '*'
+#define BLANK_ROW "                "
+// AppUITask() modulation
+#define MOD_DEPTH 50u // percent, AM depth or FM deviation
+#define MOD_DFLT_FREQ 5u // modulator frequency until one is entered
 //
 
 
@@ -98,6 +117,9 @@ static void  AppTSIProcTask(void *p_arg);
 static INT8U NumInput(INT8C keyin);
 static INT8U ApplyInput(INT16U *freq, INT8U val, INT8U backspace);
 static INT8U UpdateAmp(INT8U delta, INT8U *amplitude);
+static void DispMod(INT8U mode);
+static void DispEntryRow(INT16U freqentry, INT8U modmode);
+static void UICommand(INT8C key);
 
 
 // Error trap code template
@@ -153,11 +175,13 @@ static void AppStartTask(void *p_arg) {
      * Or, alternatively, you can comment out this line, or remove it. If you do, you
      * will not have accurate CPU load information                                       */
 //    OSStatTaskCPUUsageInit(&os_err); // NOTE: DISABLED IN app_cfg.h
+    BIOOpen(BIO_BIT_RATE_9600);         /* ResAlloc's report and failure halt        */
     GpioDBugBitsInit();
     LcdInit();
     KeyInit();
     TSIInit();
     WaveInit();
+    ResReport();                        /* PIT/DMA assignments to the terminal          */
 
     OSTaskCreate(&AppUITaskTCB,           /* Create UITask                   */
                 "App UITask ",
@@ -211,11 +235,21 @@ static void AppUITask(void *p_arg){
 
     INT32U wavemodfreq;
     INT8U wavemodtype;
+    WAVE_T modulator;
+    INT8U modmode;
+    INT8U cmdprefix; // last key was CMD_KEY
+    INT8U cmdshown; // bottom row holds a command result
 
     reset=1; // high flag
     keyinput=0u; // 0 values for reset
     freqentry=0u;
     numentry=0u;
+    modmode=WAVE_MOD_NONE;
+    cmdprefix=FALSE;
+    cmdshown=FALSE;
+    modulator.type=SINWAVE;
+    modulator.freq=MOD_DFLT_FREQ;
+    modulator.ampl=MOD_DEPTH;
 
     while(1){
         DB4_TURN_ON();
@@ -240,6 +274,18 @@ static void AppUITask(void *p_arg){
             reset=0;
         }
 
+        if(cmdshown){ // put the entry row back
+            DispEntryRow(freqentry, modmode);
+            cmdshown=FALSE;
+        } else {}
+
+        if(cmdprefix){ // this key is a command, not an entry
+            UICommand(keyinput);
+            cmdprefix=FALSE;
+            cmdshown=TRUE;
+            keyinput=0u; // nothing left for the switch
+        } else {}
+
         switch(keyinput){
             case KEYPAD_A_BUTTON: // send new data to WaveModule, display on LCD
                 wavemodtype=SINWAVE;
@@ -259,6 +305,24 @@ static void AppUITask(void *p_arg){
                 }
 		else{} 
                 break;
+            case CMD_KEY: // the next key is a command
+                LcdDispString(LCD_ROW_2, LCD_COL_9, UI_LAYER, "*");
+                cmdprefix=TRUE;
+                break;
+            case KEYPAD_C_BUTTON: // next modulation mode
+                if(modmode==WAVE_MOD_NONE){
+                    modmode=WAVE_MOD_AM;
+                } else if(modmode==WAVE_MOD_AM){
+                    modmode=WAVE_MOD_FM;
+                } else {
+                    modmode=WAVE_MOD_NONE;
+                }
+                if((freqentry>0u) && (freqentry<=MOD_MAX_FREQ)){
+                    modulator.freq=(INT32U) freqentry;
+                } else {}
+                WaveModSet(modmode, &modulator);
+                DispMod(modmode);
+                break;
             case KEYPAD_D_BUTTON:
                 (void)ApplyInput(&freqentry,0,BACKSPACE); // remove last entry
                 LcdDispDecWord(LCD_ROW_2, LCD_COL_1, UI_LAYER, (INT32U) freqentry, SHOW_FIVE_DIGITS, MODE_LZ);
@@ -284,10 +348,11 @@ static void AppUITask(void *p_arg){
 
 /*****************************************************************************************
 * TSIProcessTask() - Reads touch sensor inputs
-*  Interprets TSI module input and updates amplitude status as appropriate.  Helper functions
-*  do not allow the amplitude to be outside the range of 0-20.  Will not accept a sensor
-*  input until that sensor has been deasserted for at least one sampling (press and hold
-*  does not change amplitude by more than one).
+*  Drains the TSI event queue and updates amplitude status as appropriate.  Helper functions
+*  do not allow the amplitude to be outside the range of 0-20.  A tap changes the amplitude by
+*  one, holding a pad auto-repeats with the accelerating step from the TSI module, and a swipe
+*  toward a pad moves it by the swipe speed over SWIPE_STEP_DIV.  Gestures that came and went
+*  while the task was busy are still counted.
 *
 * Trevor Schwarz, 2/28/2020
 *****************************************************************************************/
@@ -295,10 +360,11 @@ static void AppTSIProcTask(void *p_arg){
     OS_ERR os_err;
     (void)p_arg;
 
-    INT8U *touchsense; // pointer to an array  
+    TSI_EVENT_T tsievent; // one event from the TSI module
     INT8U lcdchange; // track whether the display needs to update
     INT8U reset;
-    INT8U prevstate[2]={0,0}; // used to track last state of button presses
+    INT8U delta;
+    INT16S steps;
 
     INT8U amplitude;
 
@@ -306,7 +372,7 @@ static void AppTSIProcTask(void *p_arg){
 
     while(1) {
         DB3_TURN_OFF(); // don't assert debug bit while waiting
-        touchsense=TSIPend(0, &os_err); // read the touch sensors
+        TSIEventPend(0, &os_err); // wait for touch events
         WaveAmplGet(&amplitude); // read the wave data
         DB3_TURN_ON();
 
@@ -318,20 +384,31 @@ static void AppTSIProcTask(void *p_arg){
             lcdchange=FALSE;
         }
 
-        if(touchsense[DOWNPRESS] && !prevstate[DOWNPRESS]){ // if DOWNPRESS and legal, decrement
-            lcdchange=UpdateAmp(AMPL_DECREMENT, &amplitude);
-            prevstate[DOWNPRESS]=ASSERTED;
-        }
-        if (touchsense[UPPRESS] && !prevstate[UPPRESS]){ // if UPPRESS and legal, increment
-            lcdchange=UpdateAmp(AMPL_INCREMENT, &amplitude);
-            prevstate[UPPRESS]=ASSERTED;
-        }
-        if (!touchsense[DOWNPRESS]){ // if no DOWNPRESS, make next decrement legal
-            prevstate[DOWNPRESS]=DEASSERTED;
+        while(TSIEventGet(&tsievent)){ // every event since the last wake up
+            if(tsievent.electrode == DOWNPRESS){ // tap, hold or swipe toward DOWNPRESS decrements
+                delta=AMPL_DECREMENT;
+            } else {
+                delta=AMPL_INCREMENT;
+            }
+            if(tsievent.type == TSI_EV_TAP){
+                steps=1;
+            } else if(tsievent.type == TSI_EV_REPEAT){
+                steps=tsievent.value;
+            } else if(tsievent.type == TSI_EV_SWIPE){
+                steps=(INT16S)(tsievent.value/SWIPE_STEP_DIV);
+                if(steps < 1){
+                    steps=1;
+                } else if(steps > (INT16S)MAX_AMPL){
+                    steps=(INT16S)MAX_AMPL;
+                } else {}
+            } else {
+                steps=0; // press and release edges are covered by the gestures
+            }
+            while(steps > 0){ // UpdateAmp() refuses steps past the limits
+                lcdchange|=UpdateAmp(delta, &amplitude);
+                steps--;
+            }
         }
-        if (!touchsense[UPPRESS]){ // if no UPPRESS, make next increment legal
-            prevstate[UPPRESS]=DEASSERTED;
-        } else {}
 
         if(lcdchange){
             DB3_TURN_OFF(); // pends on mutex key
@@ -371,6 +448,100 @@ static INT8U UpdateAmp(INT8U delta, INT8U *amplitude){
 }
 
 
+/*****************************************************************************************
+* DispMod() - Helper Function -
+*  Shows the modulation mode on the bottom row of the UI_LAYER, blank for none.
+*
+*  parameter:
+*   mode = WAVE_MOD_NONE, WAVE_MOD_AM or WAVE_MOD_FM
+*****************************************************************************************/
+static void DispMod(INT8U mode){
+    if(mode==WAVE_MOD_AM){
+        LcdDispString(LCD_ROW_2, LCD_COL_10, UI_LAYER, "AM");
+    } else if(mode==WAVE_MOD_FM){
+        LcdDispString(LCD_ROW_2, LCD_COL_10, UI_LAYER, "FM");
+    } else {
+        LcdDispString(LCD_ROW_2, LCD_COL_10, UI_LAYER, "  ");
+    }
+}
+
+/*****************************************************************************************
+* DispEntryRow() - Helper Function -
+*  Redraws the bottom row of the UI_LAYER: frequency entry, modulation and wave type.
+*
+*  parameters:
+*   freqentry = frequency being entered
+*   modmode = WAVE_MOD_NONE, WAVE_MOD_AM or WAVE_MOD_FM
+*****************************************************************************************/
+static void DispEntryRow(INT16U freqentry, INT8U modmode){
+    INT8U wavetype;
+
+    LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, BLANK_ROW);
+    LcdDispDecWord(LCD_ROW_2, LCD_COL_1, UI_LAYER, (INT32U) freqentry, SHOW_FIVE_DIGITS, MODE_LZ);
+    LcdDispString(LCD_ROW_2, LCD_COL_6, UI_LAYER, "HZ");
+    DispMod(modmode);
+    WaveTypeGet(&wavetype);
+    if(wavetype==SINWAVE){
+        LcdDispString(LCD_ROW_2, LCD_COL_14, UI_LAYER, "SIN");
+    } else {
+        LcdDispString(LCD_ROW_2, LCD_COL_14, UI_LAYER, "TRI");
+    }
+}
+
+/*****************************************************************************************
+* UICommand() - Helper Function -
+*  Runs the command key that followed CMD_KEY and shows its result on the bottom row of
+*  the UI_LAYER. Unknown keys leave the row blank.
+*
+*  parameter:
+*   key = key pressed after CMD_KEY
+*****************************************************************************************/
+static void UICommand(INT8C key){
+    WAVE_BURST_STATS_T burststats;
+    WAVE_WAKE_STATS_T wakestats;
+    TSI_SCAN_COST_T tsicost;
+    CPU_ERR cpu_err;
+    INT32U tsperus;
+    INT8U num;
+    INT8U burst;
+
+    LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, BLANK_ROW);
+    num=NumInput(key);
+    if(num==0u){
+        WaveBurstDisarm();
+        LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "BURST OFF");
+    } else if(num<10u){
+        burst=WaveBurstArm((INT16U) num);
+        if(burst==WAVE_BURST_ARMED){
+            LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "BURST");
+            LcdDispDecWord(LCD_ROW_2, LCD_COL_7, UI_LAYER, (INT32U) num, 1u, MODE_LZ);
+        } else if(burst==WAVE_BURST_BUSY){
+            LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "BURST PLAYING");
+        } else {
+            LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "BURST TOO LONG");
+        }
+    } else if(key=='#'){
+        WaveBurstStatsGet(&burststats);
+        LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "L");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_2, UI_LAYER, burststats.last, SHOW_FIVE_DIGITS, MODE_LZ);
+        LcdDispString(LCD_ROW_2, LCD_COL_8, UI_LAYER, "J");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_9, UI_LAYER, burststats.max - burststats.min, SHOW_FIVE_DIGITS, MODE_LZ);
+    } else if(key==KEYPAD_A_BUTTON){
+        WaveWakeStatsGet(&wakestats);
+        tsperus=CPU_TS_TmrFreqGet(&cpu_err)/1000000u;
+        LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "W");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_2, UI_LAYER, (INT32U) wakestats.max/tsperus, SHOW_FIVE_DIGITS, MODE_LZ);
+        LcdDispString(LCD_ROW_2, LCD_COL_8, UI_LAYER, "O");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_9, UI_LAYER, wakestats.overruns, SHOW_FIVE_DIGITS, MODE_LZ);
+    } else if(key==KEYPAD_B_BUTTON){
+        TSIScanCostGet(&tsicost);
+        LcdDispString(LCD_ROW_2, LCD_COL_1, UI_LAYER, "C");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_2, UI_LAYER, (INT32U) tsicost.max, SHOW_FIVE_DIGITS, MODE_LZ);
+        LcdDispString(LCD_ROW_2, LCD_COL_8, UI_LAYER, "D");
+        LcdDispDecWord(LCD_ROW_2, LCD_COL_9, UI_LAYER, TSIEventDroppedGet(), SHOW_FIVE_DIGITS, MODE_LZ);
+    } else {}
+}
+
 /*****************************************************************************************
 * NumInput() - Helper Function -
 *  Checks if ASCII from KeyPend is a valid keypad number entry and if so returns the
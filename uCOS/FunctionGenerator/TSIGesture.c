@@ -0,0 +1,214 @@
+/*********************************************************************************
+ * TSIGesture.c - Gesture decoder for the TSI module.
+ *
+ * States:
+ *  -IDLE: nothing pressed.
+ *  -DOWN: one pad pressed. Held TSI_GEST_LONG_MS it auto-repeats, the step
+ *         doubling every TSI_GEST_ACCEL_REPEATS repeats up to TSI_GEST_STEP_MAX.
+ *         A second pad pressed within TSI_GEST_SWIPE_MS of the first is a swipe.
+ *  -LIFTED: the pad was released before it repeated. If another pad is
+ *         pressed within TSI_GEST_GAP_MS it is still a swipe, otherwise a tap.
+ *  -WAIT: a swipe or an interrupted hold, wait for every pad to be released.
+ *
+ * Swipe speed is pads per second from the first press to the second. Times
+ * are kept in CPU_TS counts and timers compare the unsigned time elapsed
+ * since they started, so they survive the counter wrapping; the only
+ * division is the swipe speed, once per swipe.
+ *
+ *********************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "TSIModule.h"
+#include "TSIGesture.h"
+
+/*********************************************************************
+* Module defines
+********************************************************************/
+#define TSI_GEST_LONG_MS 500u //hold before auto-repeat
+#define TSI_GEST_REPEAT_MS 150u //auto-repeat interval
+#define TSI_GEST_ACCEL_REPEATS 4u //repeats at each step size
+#define TSI_GEST_STEP_MAX 8 //largest auto-repeat step
+#define TSI_GEST_SWIPE_MS 400u //first press to second press, longest swipe
+#define TSI_GEST_GAP_MS 120u //release to next press that still swipes
+#define TSI_GEST_SPEED_MAX 0x7fff
+
+typedef enum{TSI_GEST_IDLE, TSI_GEST_DOWN, TSI_GEST_LIFTED, TSI_GEST_WAIT}TSI_GEST_STATE_T;
+
+/********************************************************************
+* Private Resources
+********************************************************************/
+static TSI_GEST_STATE_T tsiGestState = TSI_GEST_IDLE;
+static INT16U tsiGestDown; //TSI_ELECTRODE_BIT() of every pad pressed
+static INT8U tsiGestFirst; //pad that started the gesture
+static CPU_TS tsiGestT0; //first press
+static CPU_TS tsiGestMark; //timer start, DOWN: press or last repeat, LIFTED: release
+static CPU_TS tsiGestWait; //timer length from tsiGestMark
+static INT8U tsiGestRepeats;
+static INT16S tsiGestStep;
+static CPU_TS tsiGestLongTs; //gesture times in CPU_TS counts
+static CPU_TS tsiGestRepeatTs;
+static CPU_TS tsiGestSwipeTs;
+static CPU_TS tsiGestGapTs;
+static CPU_INT32U tsiGestFreq;
+
+static void tsiGestSet(TSI_EVENT_T *gesture, INT8U electrode, INT8U type, INT16S value, CPU_TS ts);
+static INT16S tsiGestSpeed(CPU_TS dt);
+
+/*********************************************************************
+* TSIGestInit() - Convert the gesture times to CPU_TS counts.
+********************************************************************/
+void TSIGestInit(CPU_INT32U tsfreq){
+	tsiGestFreq = tsfreq;
+	tsiGestLongTs = (tsfreq/1000u)*TSI_GEST_LONG_MS;
+	tsiGestRepeatTs = (tsfreq/1000u)*TSI_GEST_REPEAT_MS;
+	tsiGestSwipeTs = (tsfreq/1000u)*TSI_GEST_SWIPE_MS;
+	tsiGestGapTs = (tsfreq/1000u)*TSI_GEST_GAP_MS;
+	tsiGestState = TSI_GEST_IDLE;
+	tsiGestDown = 0u;
+}
+
+/*********************************************************************
+* TSIGestEdge() - Press and release transitions.
+********************************************************************/
+INT8U TSIGestEdge(INT8U electrode, INT8U type, CPU_TS ts, TSI_EVENT_T *gesture){
+	INT8U found = FALSE;
+
+	if(type == TSI_EV_PRESS){
+		tsiGestDown |= TSI_ELECTRODE_BIT(electrode);
+	}
+	else{
+		tsiGestDown &= (INT16U)~TSI_ELECTRODE_BIT(electrode);
+	}
+
+	switch(tsiGestState){
+		case TSI_GEST_IDLE:
+			if(type == TSI_EV_PRESS){
+				tsiGestFirst = electrode;
+				tsiGestT0 = ts;
+				tsiGestMark = ts;
+				tsiGestWait = tsiGestLongTs;
+				tsiGestRepeats = 0u;
+				tsiGestStep = 1;
+				tsiGestState = TSI_GEST_DOWN;
+			}
+			else{}
+			break;
+		case TSI_GEST_DOWN:
+			if((type == TSI_EV_PRESS) && (electrode != tsiGestFirst)){
+				if((tsiGestRepeats == 0u) && ((ts - tsiGestT0) <= tsiGestSwipeTs)){
+					tsiGestSet(gesture, electrode, TSI_EV_SWIPE, tsiGestSpeed(ts - tsiGestT0), ts);
+					found = TRUE;
+				}
+				else{}
+				tsiGestState = TSI_GEST_WAIT; //swiped, or a second pad ended the hold
+			}
+			else if((type == TSI_EV_RELEASE) && (electrode == tsiGestFirst)){
+				if(tsiGestRepeats == 0u){
+					tsiGestMark = ts;
+					tsiGestWait = tsiGestGapTs;
+					tsiGestState = TSI_GEST_LIFTED;
+				}
+				else{
+					tsiGestState = TSI_GEST_WAIT;
+				}
+			}
+			else{}
+			break;
+		case TSI_GEST_LIFTED:
+			if(type == TSI_EV_PRESS){
+				if(electrode != tsiGestFirst){
+					tsiGestSet(gesture, electrode, TSI_EV_SWIPE, tsiGestSpeed(ts - tsiGestT0), ts);
+					tsiGestState = TSI_GEST_WAIT;
+				}
+				else{
+					//pressed again before the gap ran out, tap and start over//
+					tsiGestSet(gesture, tsiGestFirst, TSI_EV_TAP, 0, ts);
+					tsiGestT0 = ts;
+					tsiGestMark = ts;
+					tsiGestWait = tsiGestLongTs;
+					tsiGestState = TSI_GEST_DOWN;
+				}
+				found = TRUE;
+			}
+			else{}
+			break;
+		default: //TSI_GEST_WAIT
+			break;
+	}
+	if((tsiGestState == TSI_GEST_WAIT) && (tsiGestDown == 0u)){
+		tsiGestState = TSI_GEST_IDLE;
+	}
+	else{}
+	return(found);
+}
+
+/*********************************************************************
+* TSIGestTick() - Auto-repeat while held, tap once the swipe gap has
+*            passed.
+********************************************************************/
+INT8U TSIGestTick(CPU_TS ts, TSI_EVENT_T *gesture){
+	INT8U found = FALSE;
+
+	if((tsiGestState == TSI_GEST_DOWN) && ((ts - tsiGestMark) >= tsiGestWait)){
+		tsiGestSet(gesture, tsiGestFirst, TSI_EV_REPEAT, tsiGestStep, ts);
+		found = TRUE;
+		tsiGestRepeats++;
+		if(((tsiGestRepeats % TSI_GEST_ACCEL_REPEATS) == 0u) && (tsiGestStep < TSI_GEST_STEP_MAX)){
+			tsiGestStep = (INT16S)(tsiGestStep*2);
+		}
+		else{}
+		tsiGestMark = tsiGestMark + tsiGestWait; //no drift from late ticks
+		tsiGestWait = tsiGestRepeatTs;
+	}
+	else if((tsiGestState == TSI_GEST_LIFTED) && ((ts - tsiGestMark) >= tsiGestWait)){
+		tsiGestSet(gesture, tsiGestFirst, TSI_EV_TAP, 0, ts);
+		found = TRUE;
+		tsiGestState = TSI_GEST_IDLE;
+	}
+	else{}
+	return(found);
+}
+
+/*********************************************************************
+* TSIGestIdle() - No gesture in progress.
+********************************************************************/
+INT8U TSIGestIdle(void){
+	INT8U idle;
+
+	if(tsiGestState == TSI_GEST_IDLE){
+		idle = TRUE;
+	}
+	else{
+		idle = FALSE;
+	}
+	return(idle);
+}
+
+/*********************************************************************
+* tsiGestSet() - Fill in a gesture event.
+********************************************************************/
+static void tsiGestSet(TSI_EVENT_T *gesture, INT8U electrode, INT8U type, INT16S value, CPU_TS ts){
+	gesture->ts = ts;
+	gesture->electrode = electrode;
+	gesture->type = type;
+	gesture->value = value;
+}
+
+/*********************************************************************
+* tsiGestSpeed() - Pads per second for dt CPU_TS counts between pads.
+********************************************************************/
+static INT16S tsiGestSpeed(CPU_TS dt){
+	CPU_INT32U speed;
+
+	if(dt == 0u){
+		dt = 1u;
+	}
+	else{}
+	speed = tsiGestFreq/dt;
+	if(speed > TSI_GEST_SPEED_MAX){
+		speed = TSI_GEST_SPEED_MAX;
+	}
+	else{}
+	return((INT16S)speed);
+}
@@ -0,0 +1,49 @@
+/*********************************************************************************
+ * TSIGesture.h - Gesture decoder for the TSI module. Turns the press and
+ * release edges of the electrodes into taps, auto-repeating long presses and
+ * swipes from one pad to another. Called from the TSI ISR once per edge and
+ * once per scan, every call is a few compares and adds.
+ *
+ *********************************************************************************/
+
+#ifndef TSIGESTURE_H_
+#define TSIGESTURE_H_
+
+/*********************************************************************
+* TSIGestInit() - Convert the gesture times to CPU_TS counts.
+*
+*    Parameters:
+*        tsfreq: CPU_TS counts per second
+*    Returns: none
+********************************************************************/
+void TSIGestInit(CPU_INT32U tsfreq);
+
+/*********************************************************************
+* TSIGestEdge() - Run an electrode press or release through the decoder.
+*
+*    Parameters:
+*        electrode: electrode table index
+*        type: TSI_EV_PRESS or TSI_EV_RELEASE
+*        ts: OS_TS_GET() of the scan
+*        gesture: filled in when a gesture is decoded
+*    Returns: TRUE if *gesture holds a new gesture
+********************************************************************/
+INT8U TSIGestEdge(INT8U electrode, INT8U type, CPU_TS ts, TSI_EVENT_T *gesture);
+
+/*********************************************************************
+* TSIGestTick() - Advance the decoder's timers, once per scan.
+*
+*    Parameters:
+*        ts: OS_TS_GET() of the scan
+*        gesture: filled in when a gesture is decoded
+*    Returns: TRUE if *gesture holds a new gesture
+********************************************************************/
+INT8U TSIGestTick(CPU_TS ts, TSI_EVENT_T *gesture);
+
+/*********************************************************************
+* TSIGestIdle() - TRUE when no gesture is in progress, so the decoder
+*            needs no more ticks until the next press.
+********************************************************************/
+INT8U TSIGestIdle(void);
+
+#endif /* TSIGESTURE_H_ */
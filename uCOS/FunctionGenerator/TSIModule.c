@@ -1,15 +1,54 @@
 /*********************************************************************************
- * TSIModule.c - A TSI module that runs under MicroC/OS for the two touch sensors
+ * TSIModule.c - A TSI module that runs under MicroC/OS for the touch sensors
  * onboard the K65TWR Development kit.
- * This version provides public resources TSIInit, and TSIPend. TSIInit simply
- * initializes the touch sensor electrodes while TSIPend pends on a semaphore
- * that is posted after both the right and left electrodes have been scanned.
- * It then returns an array that contains the state of both the left and right
- * electrodes.
+ * This version provides public resources TSIInit, TSIEventPend and
+ * TSIEventGet. TSIInit simply initializes the touch sensor electrodes. Every
+ * press and release is queued as a TSI_EVENT_T with the electrode and the
+ * time stamp of the scan that changed it; TSIEventPend waits for events and
+ * TSIEventGet pops them, so a consumer drains everything that happened since
+ * it last ran and no edge is lost between its wake ups.
  *
- * Requires the following be defined in app_cfg.h
- * 			APP_CFG_TSI_TASK_PRIO
- *			APP_CFG_TSI_TASK_STK_SIZE
+ * tsiEvQ is a single producer, single consumer ring: only the ISR writes an
+ * entry and then tsiEvHead, only the consumer reads an entry and then
+ * advances tsiEvTail, so neither side needs a lock. The indexes run free and
+ * are masked into the ring. A full ring drops the new event and counts it in
+ * tsiEvDropped.
+ *
+ * The edges and a tick every scan also drive TSIGesture, which queues taps,
+ * accelerating auto-repeats and swipes into the same ring. Active scanning
+ * continues while a gesture is in progress so its timers keep running. The
+ * ISR measures its own cost in CPU_TS counts, see TSIScanCostGet().
+ *
+ * The electrodes are listed in tsiElectrodes, each with its channel, pin,
+ * press and release offsets and scan weight. TSIInit() builds tsiScanSeq from
+ * the weights, a smooth weighted round robin, so an electrode with weight 2 is
+ * scanned twice per pass, spread out between the others. Adding a pad is one
+ * line in the table; the per scan work is a table lookup and does not depend
+ * on the number of electrodes.
+ *
+ * Each scan count goes through a TSIFilter: the baseline tracks slow drift
+ * while the electrode is released, touch is decided against a press level
+ * and released against a lower release level, and a state only changes after
+ * TSI_FILT_N of the last TSI_FILT_M scans agree.
+ * The filter is the one in Baremetal/TSIFilterMod, shared with the security
+ * system and tested on the host by make check in Baremetal/SecuritySim.
+ *
+ * Scanning is run by the TSI end of scan interrupt. TSI0_IRQHandler() reads
+ * the finished electrode and starts the next one in tsiScanSeq right away, so
+ * the electrodes are scanned back to back with no task in the loop. Events
+ * are queued at the scan whose filter state changed, and the semaphore is
+ * posted once at the end of each pass that queued any.
+ *
+ * With TSI_WAKE_EN set, the module idles in wake mode whenever no electrode is
+ * touched: a PIT and DMA channel pair from ResAlloc play tsiWakeTbl, which
+ * repeats tsiScanSeq and for each entry writes the electrode's out-of-range
+ * threshold to TSHD and then starts its scan. The TSI only interrupts when a
+ * count crosses a threshold. The ISR then switches to the end of scan
+ * sequencer above until every electrode is released and its debounce window
+ * is clear. The last entry of the table has a zero threshold,
+ * so once every TSI_WAKE_ENTRIES scans it forces a pass that refreshes the
+ * baselines, and the table is rewritten from them. The DMA resumes past that
+ * entry, at the start of the table.
  *
  *02/22/2020 Original TSIModule.c complete, Sam Condon
  *********************************************************************************/
@@ -20,6 +59,9 @@
 #include "app_cfg.h"
 #include "os.h"
 #include "TSIModule.h"
+#include "TSIFilter.h"
+#include "ResAlloc.h"
+#include "TSIGesture.h"
 #include "K65TWR_GPIO.h"
 #include "MK65F18.h"
 
@@ -28,56 +70,104 @@
 ********************************************************************/
 #define RIGHT_TOUCH_OFFSET 0x01ff
 #define LEFT_TOUCH_OFFSET 0x01ff
-#define LEFT_CH 12u //TSI left electrode channel
-#define RIGHT_CH 11u //TSI right electrode channel
-#define LEFT_IND 1u//TSI left electrode index into status data
-#define RIGHT_IND 0u//TSI right electrode index into status data
+#define RIGHT_RELEASE_OFFSET 0x0180 //counts above baseline to stay touched
+#define LEFT_RELEASE_OFFSET 0x0180
+#define LEFT_CH 12u //TSI left electrode channel, PTB19
+#define RIGHT_CH 11u //TSI right electrode channel, PTB18
+#define TSI_SEQ_MAX 16u //longest scan sequence, sum of the electrode weights
+#define TSI_EVQ_SIZE 16u //events in tsiEvQ, power of two
+#define TSI_EVQ_MASK (TSI_EVQ_SIZE-1u)
+
+#define TSI_WAKE_EN 1u
+#define TSI_WAKE_PERIOD 300000u // bus clocks between scans, 5 ms per electrode scan at 60MHz
+#define TSI_WAKE_ENTRIES 64u // scans per table pass, the last one rebaselines, 320 ms
+#define TSI_WAKE_SMOD 9u // 2^9 bytes, tsiWakeTbl length, source modulo wraps the table
+#define TSI_WAKE_TBL_BYTES 512u // {TSHD, DATA} words for each entry
+#define TSI_WAKE_WORD 4u
 
 /**********************************************************************
- * TSI_T: TSI status struct, holds threshold and status values of each
- * 		  electrode
+ * TSI_ELECTRODE_T: one entry of the electrode table
  *
- * 		  index 0 holds data for the right electrode
- * 		  index 1 holds data for the left electrode
+ * 		  -ch: TSI channel
+ * 		  -port, pin: the channel's pin, set to the TSI function
+ * 		  -pressoffset: counts above baseline to press
+ * 		  -releaseoffset: counts above baseline to stay pressed
+ * 		  -weight: scans per pass of tsiScanSeq, higher reacts faster
+ **********************************************************************/
+typedef struct{
+	INT8U ch;
+	PORT_Type *port;
+	INT8U pin;
+	INT16U pressoffset;
+	INT16U releaseoffset;
+	INT8U weight;
+}TSI_ELECTRODE_T;
+
+/**********************************************************************
+ * TSI_T: TSI status struct, holds threshold and status values of each
+ * 		  electrode, indexed like tsiElectrodes
  * Sam Condon, 02/22/2020 
  **********************************************************************/
 typedef struct{
-	INT16U tsiTouchLevels[2]; //array that holds oscillator count threshold
-	INT8U tsiStates[2]; //array that holds state of each electrode
-	OS_SEM flag;
+	TSI_FILT_T tsiFilt[TSI_NUM_ELECTRODES]; //baseline, thresholds and debounce of each electrode
+	OS_SEM flag; //posted after a pass that queued events
 }TSI_T;
 
 /********************************************************************
 * Private Resources
 ********************************************************************/
 static TSI_T tsiBuffer;
-static void TSITask(void *p_arg);
-static OS_TCB TSITaskTCB;
-static CPU_STK TSITaskStk[APP_CFG_TSI_TASK_STK_SIZE];
-OS_SEM ElectrodeScanCompleteFlag;
+static const TSI_ELECTRODE_T tsiElectrodes[TSI_NUM_ELECTRODES] = {
+	{RIGHT_CH, PORTB, 18u, RIGHT_TOUCH_OFFSET, RIGHT_RELEASE_OFFSET, 1u}, //TSI_RIGHT
+	{LEFT_CH, PORTB, 19u, LEFT_TOUCH_OFFSET, LEFT_RELEASE_OFFSET, 1u}    //TSI_LEFT
+};
+static INT8U tsiScanSeq[TSI_SEQ_MAX]; //electrode indexes in scan order, one pass per post
+static INT8U tsiSeqLen; //entries used in tsiScanSeq
+static INT8U tsiScanIndex; //position in tsiScanSeq of the scan in progress
+static INT16U tsiScanStates; //bit TSI_ELECTRODE_BIT(e) set while electrode e is touched
+static INT16U tsiScanBusy; //electrodes touched or debouncing
+static INT8U tsiEvQueued; //events queued in the pass in progress
+static volatile TSI_EVENT_T tsiEvQ[TSI_EVQ_SIZE];
+static volatile INT8U tsiEvHead; //next entry the ISR writes
+static volatile INT8U tsiEvTail; //next entry the consumer reads
+static INT32U tsiEvDropped; //events lost to a full ring
+static TSI_SCAN_COST_T tsiScanCost;
+static void TSISeqBuild(void);
+static void TSIEventPut(INT8U electrode, INT8U type, INT16S value, CPU_TS ts);
+#if TSI_WAKE_EN
+static INT32U tsiWakeTbl[TSI_WAKE_TBL_BYTES/TSI_WAKE_WORD] __attribute__((aligned(TSI_WAKE_TBL_BYTES))); //TSHD, DATA pairs
+static RES_PERIODIC_T tsiWakeDma; //PIT and DMA channel from ResAlloc
+static const INT8C tsiOwnerStrg[] = "TSI wake";
+static void TSIWakeInit(void);
+static void TSIWakeTblUpdate(void);
+static void TSIWakeStart(void);
+static void TSIWakeStop(void);
+#endif
+
+void TSI0_IRQHandler(void);
 
 
 /********************************************************************
 * TSIInit() - Initialization routine for the TSI module.
 *             First a calibration is run to test the oscillator
-*             count when there is no touch. Offsets defined by
-*             RIGHT_TOUCH_OFFSET and LEFT_TOUCH_OFFSET are then
-*             added to those measured levels
+*             count when there is no touch, which starts each
+*             electrode's filter baseline. Press and release levels
+*             are the table's offsets above the baseline.
 *
 * Sam Condon, 02/22/2020
 ********************************************************************/
 void TSIInit(void){
 
 	OS_ERR os_err;
-
-	INT16U baselinelevelleft;
-	INT16U baselinelevelright;
+	CPU_ERR cpu_err;
+	INT8U ind;
 
 	//Configure SCGC and GPIO Port////////////////////////
-	SIM->SCGC5 |= SIM_SCGC5_PORTB_MASK;
+	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK | SIM_SCGC5_PORTB_MASK | SIM_SCGC5_PORTC_MASK; //ports with TSI channels
 	SIM->SCGC5 |= SIM_SCGC5_TSI(1);
-	PORTB->PCR[18] &= (0xffffffff & PORT_PCR_MUX(0x0U));
-	PORTB->PCR[19] &= (0xffffffff & PORT_PCR_MUX(0x0U));
+	for(ind = 0u; ind < TSI_NUM_ELECTRODES; ind++){
+		tsiElectrodes[ind].port->PCR[tsiElectrodes[ind].pin] = PORT_PCR_MUX(0x0U);
+	}
 	//////////////////////////////////////////////////////
 
 	//CONFIGURE TSI/////////////////////////
@@ -88,112 +178,342 @@ void TSIInit(void){
 	TSI0->GENCS |= TSI_GENCS_NSCN(15U);
 	TSI0->GENCS |= TSI_GENCS_TSIEN_MASK;
 
-	//TSI0 LEFT ELECTRODE CALIBRATION//////////////////////////////////////////////////////////////////////
-	TSI0->DATA = TSI_DATA_TSICH(LEFT_CH);
-	TSI0->DATA |= TSI_DATA_SWTS(1);
-
-	while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
-		//wait for scan to complete
-	}
-	TSI0->GENCS |= TSI_GENCS_EOSF(1); //clear end of scan flag
-
-	baselinelevelleft = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
-	tsiBuffer.tsiTouchLevels[LEFT_IND] = (INT16U)(baselinelevelleft + LEFT_TOUCH_OFFSET);
-	////////////////////////////////////////////////////////////////////////////////////////////////////
+	//TSI0 ELECTRODE CALIBRATION//////////////////////////////////////////////////////////////////////
+	for(ind = 0u; ind < TSI_NUM_ELECTRODES; ind++){
+		TSI0->DATA = TSI_DATA_TSICH(tsiElectrodes[ind].ch);
+		TSI0->DATA |= TSI_DATA_SWTS(1);
 
-	//TSI0 RIGHT ELECTRODE CALIBRATION///////////////////////////////////////////////////////////////////////
-	TSI0->DATA = TSI_DATA_TSICH(RIGHT_CH);
-	TSI0->DATA |= TSI_DATA_SWTS(1);
+		while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
+			//wait for scan to complete
+		}
+		TSI0->GENCS |= TSI_GENCS_EOSF(1); //clear end of scan flag
 
-	while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
-		//wait for scan to complete
+		TSIFiltInit(&tsiBuffer.tsiFilt[ind], (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK),
+					tsiElectrodes[ind].pressoffset, tsiElectrodes[ind].releaseoffset);
 	}
-	TSI0->GENCS |= TSI_GENCS_EOSF(1);
-
-	baselinelevelright = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
-	tsiBuffer.tsiTouchLevels[RIGHT_IND] = (INT16U)(baselinelevelright + RIGHT_TOUCH_OFFSET);
 	//////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	//CREATE SEMAPHOR FLAGS//////////////////////////////////////////////////////////////////////
 	OSSemCreate(&(tsiBuffer.flag), "TSI Scan Complete Semaphore", 0, &os_err);
-	OSSemCreate(&ElectrodeScanCompleteFlag, "Electrode Scan Complete Semaphore", 0u, &os_err);
 	//////////////////////////////////////////////////////////////////////////////////////////////
 
-	//CREATE TSI TASK///////////////////
-	OSTaskCreate((OS_TCB*)&TSITaskTCB,
-	             (CPU_CHAR*)"TSI Task",
-	             (OS_TASK_PTR)TSITask,
-	             (void*) 0,
-	             (OS_PRIO) APP_CFG_TSI_TASK_PRIO,
-	             (CPU_STK*)&TSITaskStk[0],
-	             (CPU_STK)(APP_CFG_TSI_TASK_STK_SIZE / 10u),
-	             (CPU_STK_SIZE) APP_CFG_TSI_TASK_STK_SIZE,
-	             (OS_MSG_QTY) 0,
-	             (OS_TICK) 0,
-	             (void*) 0,
-	             (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
-	             (OS_ERR*)&os_err);
+	//START INTERRUPT DRIVEN SCANNING/////
+	TSIGestInit(CPU_TS_TmrFreqGet(&cpu_err));
+	TSISeqBuild();
+	tsiScanIndex = 0u;
+	TSI0->GENCS |= TSI_GENCS_EOSF(1);
+#if TSI_WAKE_EN
+	TSIWakeInit();
+	TSI0->GENCS |= TSI_GENCS_TSIIEN(1);
+	NVIC_ClearPendingIRQ(TSI0_IRQn);
+	NVIC_EnableIRQ(TSI0_IRQn);
+	TSIWakeStart(); //nothing touched yet, idle on hardware thresholds
+#else
+	TSI0->GENCS |= TSI_GENCS_ESOR(1) | TSI_GENCS_TSIIEN(1); //interrupt on end of scan
+	NVIC_ClearPendingIRQ(TSI0_IRQn);
+	NVIC_EnableIRQ(TSI0_IRQn);
+	TSI0->DATA = TSI_DATA_TSICH(tsiElectrodes[tsiScanSeq[tsiScanIndex]].ch);
+	TSI0->DATA |= TSI_DATA_SWTS(1);
+#endif
 	////////////////////////////////////
 
 }
 
 /********************************************************************
-* TSIPend() - A function to provide access to the TSI buffer via a
-*             semaphore.
+* TSISeqBuild() - Fill tsiScanSeq from the electrode weights with a
+* 			  smooth weighted round robin: each slot every electrode
+* 			  gains its weight in credit, the one with the most
+* 			  credit is scanned and pays back the total weight.
+* 			  Weights of 1, 2 and 1 give 1 0 2 1 for example.
+*
+*  	 -Private
+********************************************************************/
+static void TSISeqBuild(void){
+	INT16S credit[TSI_NUM_ELECTRODES];
+	INT16S total = 0;
+	INT8U ind;
+	INT8U best;
+	INT8U slot;
+
+	for(ind = 0u; ind < TSI_NUM_ELECTRODES; ind++){
+		credit[ind] = 0;
+		total += (INT16S)tsiElectrodes[ind].weight;
+	}
+	if(total > (INT16S)TSI_SEQ_MAX){
+		total = (INT16S)TSI_SEQ_MAX;
+	}
+	else{}
+
+	for(slot = 0u; slot < (INT8U)total; slot++){
+		best = 0u;
+		for(ind = 0u; ind < TSI_NUM_ELECTRODES; ind++){
+			credit[ind] += (INT16S)tsiElectrodes[ind].weight;
+			if(credit[ind] > credit[best]){
+				best = ind;
+			}
+			else{}
+		}
+		credit[best] -= total;
+		tsiScanSeq[slot] = best;
+	}
+	tsiSeqLen = (INT8U)total;
+}
+
+/********************************************************************
+* TSIEventPend() - Wait for touch events. Returns after a pass that
+*             queued any, or right away if some were queued since the
+*             last wait; drain them with TSIEventGet().
 *    -Public
 *
 * Sam Condon, 02/24/2020
 ********************************************************************/
-INT8U* TSIPend(INT16U tout, OS_ERR *os_err){
+void TSIEventPend(INT16U tout, OS_ERR *os_err){
 	OSSemPend(&(tsiBuffer.flag),tout, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
-	return(tsiBuffer.tsiStates);
 }
 
 /********************************************************************
-* TSITask() - Scan right and left electrodes, update the TSI buffer,
-* 			  post semaphore that TSIPend waits on.
+* TSIEventGet() - Pop the oldest event into *event. Returns TRUE if
+*             there was one, FALSE if the queue is empty. Only one
+*             task may consume events.
+*    -Public
+********************************************************************/
+INT8U TSIEventGet(TSI_EVENT_T *event){
+	INT8U tail = tsiEvTail;
+	INT8U got = FALSE;
+
+	if(tail != tsiEvHead){
+		event->ts = tsiEvQ[tail & TSI_EVQ_MASK].ts;
+		event->electrode = tsiEvQ[tail & TSI_EVQ_MASK].electrode;
+		event->type = tsiEvQ[tail & TSI_EVQ_MASK].type;
+		event->value = tsiEvQ[tail & TSI_EVQ_MASK].value;
+		tsiEvTail = (INT8U)(tail + 1u); //entry is free once the tail passes it
+		got = TRUE;
+	}
+	else{}
+	return(got);
+}
+
+/********************************************************************
+* TSIEventDroppedGet() - Events lost because the queue was full.
+*    -Public
+********************************************************************/
+INT32U TSIEventDroppedGet(void){
+	return(tsiEvDropped);
+}
+
+/********************************************************************
+* TSIScanCostGet() - Copies the TSI ISR cost counters, in CPU_TS
+*             counts.
+*    -Public
+********************************************************************/
+void TSIScanCostGet(TSI_SCAN_COST_T *localcost){
+	CPU_SR_ALLOC();
+	CPU_CRITICAL_ENTER();
+	*localcost = tsiScanCost;
+	CPU_CRITICAL_EXIT();
+}
+
+/********************************************************************
+* TSIEventPut() - Queue an event. Called only from the TSI ISR, the
+*             single producer.
 *
 *  	 -Private
-* Sam Condon, 02/24/2020
 ********************************************************************/
-static void TSITask(void *p_arg){
-
-	OS_ERR os_err;
+static void TSIEventPut(INT8U electrode, INT8U type, INT16S value, CPU_TS ts){
+	INT8U head = tsiEvHead;
 
-	INT8U electrodeindex = RIGHT_CH;
-	
-	(void)p_arg;
+	if((INT8U)(head - tsiEvTail) < TSI_EVQ_SIZE){
+		tsiEvQ[head & TSI_EVQ_MASK].ts = ts;
+		tsiEvQ[head & TSI_EVQ_MASK].electrode = electrode;
+		tsiEvQ[head & TSI_EVQ_MASK].type = type;
+		tsiEvQ[head & TSI_EVQ_MASK].value = value;
+		tsiEvHead = (INT8U)(head + 1u); //publish after the entry is written
+		tsiEvQueued = TRUE;
+	}
+	else{
+		tsiEvDropped++;
+	}
+}
 
-	while(1){
+/********************************************************************
+* TSI0_IRQHandler() - End of scan. Filter the finished electrode and
+* 			  queue an event if its state changed, step the gesture
+* 			  decoder, start the next one in tsiScanSeq, and at the
+* 			  end of each pass post the semaphore TSIEventPend waits
+* 			  on if events were queued.
+*
+*  	 -Private
+********************************************************************/
+void TSI0_IRQHandler(void){
 
+	OS_ERR os_err;
+	INT8U ind;
+	INT16U bit;
+	INT8U scanmore = FALSE; //continue active scanning
+	TSI_EVENT_T gesture;
+	CPU_TS now;
 
-		TSI0->GENCS |= TSI_GENCS_EOSF(1);
-		TSI0->DATA = TSI_DATA_TSICH(electrodeindex);
-		TSI0->DATA |= TSI_DATA_SWTS(1);
+	OSIntEnter();
+	DB2_TURN_ON();
+	now = OS_TS_GET();
+#if TSI_WAKE_EN
+	if((TSI0->GENCS & TSI_GENCS_ESOR_MASK) == 0u){
+		//wake mode threshold crossed, scan a pass from the start of the sequence//
+		TSIWakeStop();
+		tsiScanIndex = 0u;
+		scanmore = TRUE;
+	}
+	else
+#endif
+	{
+		TSI0->GENCS |= TSI_GENCS_EOSF(1); //clear end of scan flag
 
-		while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0U){
-		    //wait for scan to complete
-		    DB2_TURN_OFF();
-		    OSTimeDly(8u, OS_OPT_TIME_DLY, &os_err);
-		    DB2_TURN_ON();
+		ind = tsiScanSeq[tsiScanIndex];
+		bit = TSI_ELECTRODE_BIT(ind);
+		if(TSIFiltUpdate(&tsiBuffer.tsiFilt[ind], (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK)) != 0u){
+			if((tsiScanStates & bit) == 0u){
+				tsiScanStates |= bit;
+				TSIEventPut(ind, TSI_EV_PRESS, 0, now);
+				if(TSIGestEdge(ind, TSI_EV_PRESS, now, &gesture)){
+					TSIEventPut(gesture.electrode, gesture.type, gesture.value, gesture.ts);
+				}
+				else{}
+			}
+			else{}
 		}
-
-		if((INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK) >= tsiBuffer.tsiTouchLevels[electrodeindex-11u]){
-			tsiBuffer.tsiStates[electrodeindex-11u] = 1U;
+		else{
+			if((tsiScanStates & bit) != 0u){
+				tsiScanStates &= (INT16U)~bit;
+				TSIEventPut(ind, TSI_EV_RELEASE, 0, now);
+				if(TSIGestEdge(ind, TSI_EV_RELEASE, now, &gesture)){
+					TSIEventPut(gesture.electrode, gesture.type, gesture.value, gesture.ts);
+				}
+				else{}
+			}
+			else{}
+		}
+		if(TSIGestTick(now, &gesture)){
+			TSIEventPut(gesture.electrode, gesture.type, gesture.value, gesture.ts);
+		}
+		else{}
+		if(TSIFiltIdle(&tsiBuffer.tsiFilt[ind]) == FALSE){
+			tsiScanBusy |= bit;
 		}
 		else{
-			tsiBuffer.tsiStates[electrodeindex-11u] = 0U;
+			tsiScanBusy &= (INT16U)~bit;
 		}
-		if(electrodeindex == LEFT_CH){
-			electrodeindex = RIGHT_CH;
-			OSSemPost(&(tsiBuffer.flag), OS_OPT_POST_1, &os_err);
+
+		tsiScanIndex++;
+		if(tsiScanIndex >= tsiSeqLen){
+			tsiScanIndex = 0u;
+			if(tsiEvQueued){
+				tsiEvQueued = FALSE;
+				OSSemPost(&(tsiBuffer.flag), OS_OPT_POST_1, &os_err);
+			}
+			else{}
+			if((tsiScanBusy != 0u) || (TSIGestIdle() == FALSE)){
+				scanmore = TRUE; //touched, debouncing or timing a gesture
+			}
+			else{}
 		}
 		else{
-			electrodeindex = LEFT_CH;
+			scanmore = TRUE; //pass not finished
 		}
+	}
+
+#if TSI_WAKE_EN
+	if(scanmore == FALSE){
+		TSIWakeStart(); //all released, back to hardware thresholds
+	}
+	else
+#endif
+	{
+		//start the next electrode right away//
+		TSI0->DATA = TSI_DATA_TSICH(tsiElectrodes[tsiScanSeq[tsiScanIndex]].ch);
+		TSI0->DATA |= TSI_DATA_SWTS(1);
+	}
+	tsiScanCost.last = OS_TS_GET() - now;
+	if(tsiScanCost.last > tsiScanCost.max){
+		tsiScanCost.max = tsiScanCost.last;
+	}
+	else{}
+	DB2_TURN_OFF();
+	OSIntExit();
+}
+
+#if TSI_WAKE_EN
+/********************************************************************
+* TSIWakeInit() - Build the wake scan table, tsiScanSeq repeated, and
+* 			  set up a PIT and DMA channel pair to play it. Each PIT
+* 			  period writes one {TSHD, DATA} pair: DADDR starts at
+* 			  TSHD and steps back to DATA, so the threshold is in
+* 			  place before SWTS starts the scan. The thresholds are
+* 			  filled in by TSIWakeStart().
+*
+*  	 -Private
+********************************************************************/
+static void TSIWakeInit(void){
+	INT16U ind;
+
+	for(ind = 0u; ind < TSI_WAKE_ENTRIES; ind++){
+		tsiWakeTbl[2u*ind] = TSI_TSHD_THRESH(0u) | TSI_TSHD_THRESL(0u);
+		tsiWakeTbl[(2u*ind)+1u] = TSI_DATA_TSICH(tsiElectrodes[tsiScanSeq[ind % tsiSeqLen]].ch) | TSI_DATA_SWTS(1);
+	}
+
+	if(ResPeriodicAlloc(TSI_WAKE_PERIOD, FALSE, tsiOwnerStrg, &tsiWakeDma) == FALSE){ //loads the PIT and routes the DMAMUX
+		ResFail(tsiOwnerStrg);
+	}
+	else{}
 
+	DMA0->TCD[tsiWakeDma.dmach].SADDR = DMA_SADDR_SADDR(tsiWakeTbl);
+	DMA0->TCD[tsiWakeDma.dmach].SOFF = DMA_SOFF_SOFF(TSI_WAKE_WORD);
+	DMA0->TCD[tsiWakeDma.dmach].ATTR = DMA_ATTR_SMOD(TSI_WAKE_SMOD) | DMA_ATTR_SSIZE(2) | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(2);
+	DMA0->TCD[tsiWakeDma.dmach].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(2u*TSI_WAKE_WORD);
+	DMA0->TCD[tsiWakeDma.dmach].SLAST = DMA_SLAST_SLAST(0);
+	DMA0->TCD[tsiWakeDma.dmach].DADDR = DMA_DADDR_DADDR(&TSI0->TSHD);
+	DMA0->TCD[tsiWakeDma.dmach].DOFF = DMA_DOFF_DOFF(-(INT16S)TSI_WAKE_WORD); // TSHD, then DATA
+	DMA0->TCD[tsiWakeDma.dmach].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+	DMA0->TCD[tsiWakeDma.dmach].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+	DMA0->TCD[tsiWakeDma.dmach].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(2u*TSI_WAKE_WORD); // back to TSHD
+	DMA0->TCD[tsiWakeDma.dmach].CSR = 0u;
+}
+
+/********************************************************************
+* TSIWakeTblUpdate() - Write each electrode's press level into every
+* 			  entry but the last, which keeps its zero threshold so
+* 			  it always interrupts and rescans for the baselines.
+********************************************************************/
+static void TSIWakeTblUpdate(void){
+	INT16U ind;
+	INT32U tshd[TSI_NUM_ELECTRODES];
 
+	for(ind = 0u; ind < TSI_NUM_ELECTRODES; ind++){
+		tshd[ind] = TSI_TSHD_THRESH(TSIFiltLevel(&tsiBuffer.tsiFilt[ind])) | TSI_TSHD_THRESL(0u);
 	}
+	for(ind = 0u; ind < (TSI_WAKE_ENTRIES-1u); ind++){
+		tsiWakeTbl[2u*ind] = tshd[tsiScanSeq[ind % tsiSeqLen]];
+	}
+}
+
+/********************************************************************
+* TSIWakeStart() - Out of range interrupts only, PIT/DMA scanning,
+* 			  with thresholds from the current baselines.
+********************************************************************/
+static void TSIWakeStart(void){
+	TSIWakeTblUpdate();
+	TSI0->GENCS = (TSI0->GENCS & ~TSI_GENCS_ESOR_MASK) | TSI_GENCS_OUTRGF(1) | TSI_GENCS_EOSF(1); //flags are write 1 to clear
+	DMA0->SERQ = DMA_SERQ_SERQ(tsiWakeDma.dmach);
+	PIT->CHANNEL[tsiWakeDma.pit].TCTRL = PIT_TCTRL_TEN(1);
+}
+
+/********************************************************************
+* TSIWakeStop() - Stop PIT/DMA scanning, end of scan interrupts.
+********************************************************************/
+static void TSIWakeStop(void){
+	PIT->CHANNEL[tsiWakeDma.pit].TCTRL = 0u;
+	DMA0->CERQ = DMA_CERQ_CERQ(tsiWakeDma.dmach);
+	TSI0->GENCS |= TSI_GENCS_OUTRGF(1) | TSI_GENCS_EOSF(1) | TSI_GENCS_ESOR(1);
 }
+#endif
 
 
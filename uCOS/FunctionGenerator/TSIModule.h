@@ -1,15 +1,11 @@
 /*********************************************************************************
- * TSIModule.c - A TSI module that runs under MicroC/OS for the two touch sensors
+ * TSIModule.c - A TSI module that runs under MicroC/OS for the touch sensors
  * onboard the K65TWR Development kit.
- * This version provides public resources TSIInit, and TSIPend. TSIInit simply
- * initializes the touch sensor electrodes while TSIPend pends on a semaphore
- * that is posted after both the right and left electrodes have been scanned.
- * It then returns an array that contains the state of both the left and right
- * electrodes.
- *
- * Requires the following be defined in app_cfg.h
- * 			APP_CFG_TSI_TASK_PRIO
- *			APP_CFG_TSI_TASK_STK_SIZE
+ * This version provides public resources TSIInit, TSIEventPend and
+ * TSIEventGet. TSIInit simply initializes the touch sensor electrodes. Each
+ * press and release is queued as a time stamped TSI_EVENT_T by the TSI end
+ * of scan interrupt; TSIEventPend waits until events are queued and
+ * TSIEventGet drains them one at a time.
  *
  *02/22/2020 Sam Condon, Original TSIModule.c complete  
  *********************************************************************************/
@@ -18,25 +14,76 @@
 #define TSIMODULE_H_
 
 //PUBLIC RESOURCES///////////////////////////////////////////////////////
+#define TSI_NUM_ELECTRODES 2u //entries in the electrode table, at most 16
+#define TSI_RIGHT 0u //electrode table index of the right pad
+#define TSI_LEFT 1u //electrode table index of the left pad
+#define TSI_ELECTRODE_BIT(e) ((INT16U)(1u << (e))) //bit of electrode e in a mask
+#define TSI_EV_RELEASE 0u
+#define TSI_EV_PRESS 1u
+#define TSI_EV_TAP 2u //short press, no swipe
+#define TSI_EV_REPEAT 3u //long press auto-repeat, value is the step
+#define TSI_EV_SWIPE 4u //electrode is the pad swiped to, value is pads per second
+
+/**********************************************************************
+ * TSI_EVENT_T: one touch event
+ *
+ * 		  -ts: OS_TS_GET() at the end of the scan that changed the state
+ * 		  -electrode: electrode table index, TSI_RIGHT or TSI_LEFT
+ * 		  -type: one of TSI_EV_*
+ * 		  -value: repeat step or swipe speed, 0 otherwise
+ **********************************************************************/
+typedef struct{
+	CPU_TS ts;
+	INT8U electrode;
+	INT8U type;
+	INT16S value;
+}TSI_EVENT_T;
+
+/**********************************************************************
+ * TSI_SCAN_COST_T: TSI ISR execution time in CPU_TS counts, the last
+ * 		  scan and the worst since reset
+ **********************************************************************/
+typedef struct{
+	CPU_TS last;
+	CPU_TS max;
+}TSI_SCAN_COST_T;
 
 /********************************************************************
 * TSIInit() - Initialization routine for the TSI module.
 *             First a calibration is run to test the oscillator
-*             count when there is no touch. Offsets defined by
-*             RIGHT_TOUCH_OFFSET and LEFT_TOUCH_OFFSET are then
-*             added to those measured levels
+*             count when there is no touch, which starts each
+*             electrode's filter baseline. Press and release levels
+*             are the table's offsets above the baseline.
 *
 * Sam Condon, 02/22/2020
 ********************************************************************/
 void TSIInit(void);		
 
 /********************************************************************
-* TSIPend() - A function to provide access to the TSI buffer after a new
-* 	      scan is run.
+* TSIEventPend() - Wait until touch events are queued. Returns at
+* 	      once if any were queued since the last wait.
 *
 * Sam Condon, 02/22/2020
 ********************************************************************/
-INT8U* TSIPend(INT16U tout, OS_ERR *os_err);		//Pend on a TSI press
+void TSIEventPend(INT16U tout, OS_ERR *os_err);
+
+/********************************************************************
+* TSIEventGet() - Pop the oldest touch event. Returns TRUE with
+* 	      *event filled in, FALSE when the queue is empty. One
+* 	      consumer task only.
+********************************************************************/
+INT8U TSIEventGet(TSI_EVENT_T *event);
+
+/********************************************************************
+* TSIEventDroppedGet() - Events lost to a full queue since reset.
+********************************************************************/
+INT32U TSIEventDroppedGet(void);
+
+/********************************************************************
+* TSIScanCostGet() - Copy the TSI ISR cost counters, filter, events
+* 	      and gesture decoding included.
+********************************************************************/
+void TSIScanCostGet(TSI_SCAN_COST_T *localcost);
 /////////////////////////////////////////////////////////////////////////
 
 #endif /* TSIMODULE_H_ */
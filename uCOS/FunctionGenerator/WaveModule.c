@@ -18,6 +18,7 @@
 #include "LcdLayered.h"
 #include "WaveModule.h"
 #include "K65TWR_GPIO.h"
+#include "ResAlloc.h"
 
 /************************************************************
  * MODULE DEFINES
@@ -53,38 +54,178 @@
 #define DAC_MID_VAL 134152192u //(2047*2^16), DAC input representing (1/2)*Vref
 #define SCALED_MID_VAL 6097826u //(2047)*(3.0/3.3)*(1/20)*2^16, Scale factor DAC value DC offset 
 
+// OUTPUT BACKEND --------------------
+// With WAVE_DACBUF_EN set, samples are moved into the 16 word DAC0 data buffer in bursts of
+// DACBUF_BURST samples and the buffer read pointer is stepped by the PDB0 DAC interval trigger.
+// This cuts the DMA requests from 48000/s (one per sample, PIT paced) to 6000/s.
+#ifndef WAVE_DACBUF_EN // tests/Makefile builds both backends
+#define WAVE_DACBUF_EN 1u
+#endif
+#define DACBUF_WORDS 16u // depth of the DAC0 data buffer
+#define DACBUF_BURST 8u // samples per DMA request, half of the DAC0 data buffer
+#define DACBUF_WM_4WORDS 3u // watermark flag set when the read pointer is 4 words from the upper limit
+#define DACBUF_DMOD 5u // 2^5 bytes, destination modulo wraps DMA writes over DAT[0]-DAT[15]
+#define DAC_IDLE_VAL 0x800u // DAC input for (1/2)Vref, 1.65V
+#define PDB_DAC_VAL 1249U // (desired trigger period / bus clock period) - 1, same 48kHz rate as PIT_VAL
+#define PDB_TRG_SOFTWARE 15u // PDB trigger input select for the software trigger
+#define DMA_SRC_DAC0 45u // DMAMUX request source for DAC0 buffer flags
+#define DMA_SRC_ALWAYS_ON 60u // DMAMUX always enabled source, gated by the PIT trigger
+
+#if WAVE_DACBUF_EN
+#define WAVE_DMA_NBYTES (DACBUF_BURST*SAMPLE_SIZE) // bytes moved per DMA request
+#else
+#define WAVE_DMA_NBYTES SAMPLE_SIZE
+#endif
+#define WAVE_DMA_ITER ((BUF_SIZE*SAMPLE_SIZE)/WAVE_DMA_NBYTES) // DMA requests per ping-pong buffer
+
+// INTERPOLATION STAGE ---------------
+// With WAVE_INTERP_EN set, WaveTask generates samples at SAMPLE_FREQ/INTERP_L and a
+// polyphase FIR (CMSIS arm_fir_interpolate_q15) upsamples them into the ping-pong buffer.
+// At INTERP_L=2 the internal rate is 24kHz, still above twice MAX_FREQ.
+#define WAVE_INTERP_EN 1u
+#define INTERP_L 2u // interpolation factor
+#define INTERP_TAPS 32u // FIR length, INTERP_TAPS/INTERP_L taps per polyphase branch
+#define INTERP_Q15_SHIFT 3u // 12 bit DAC code <-> q15, leaves 6dB headroom for filter overshoot
+#define DAC_MAX_VAL 0x0fffu // largest 12 bit DAC input
+
+#if WAVE_INTERP_EN
+#define GEN_RATE_DIV INTERP_L
+#else
+#define GEN_RATE_DIV 1u
+#endif
+#define GEN_FREQ (SAMPLE_FREQ/GEN_RATE_DIV) // rate of the per-sample generator
+#define GEN_BLOCK ((BUF_SIZE/2u)/GEN_RATE_DIV) // generated samples per half ping-pong buffer
+
+// BURST MODE ------------------------
+// WaveBurstArm() stops the continuous output and prepares N cycles in waveBurstBuffer.
+// A falling edge on SW2 raises a DMA request that timestamps the edge and then starts the
+// burst PIT, which paces the burst output channel through the table straight into DAT[0].
+// The table ends with the 1.65V idle sample and the channel stops itself (DREQ) at the end
+// of the table. The PIT and DMA channels all come from ResAlloc at WaveInit().
+#define BURST_MAX_SAMPS 2048u // burst table length, N cycles plus the trailing idle sample
+#define BURST_TRIG_IRQC 2u // PORT PCR IRQC code for a DMA request on a falling edge
+#define BURST_TRIG_OFF 0u // PORT PCR IRQC code for a plain input, no requests
+#define DMA_SRC_PORTA 49u // DMAMUX request source for PORTA pin DMA requests (SW2)
+#define PIT_FREE_RUN 0xffffffffu // PIT load value for a free running down counter
+#define PIT_PERIOD (PIT_VAL+1u) // bus cycles per sample
+
+// MODULATION STAGE ------------------
+// With WAVE_MOD_EN set, a low rate modulator (waveModParams) is evaluated once per
+// generated block and linearly interpolated across the block. AM scales the block
+// around mid-scale with a Q15 gain ramp, FM holds the carrier frequency per block at
+// the modulator's mid-block value, so neither adds a per-sample modulator evaluation.
+#define WAVE_MOD_EN 1u
+#define MOD_BLOCK_PERIOD (SAMPLE_PERIOD*(BUF_SIZE/2u)) // q31 period fraction per Hz per block
+#define MOD_Q15_ONE 32768 // 1.0 in q15, held in an INT32S
+#define MOD_LFSR_SEED 0xace1u // non-zero start value of the noise LFSR
+#define MOD_LFSR_TAPS 0xb400u // 16 bit maximal length Galois LFSR taps
+
+// ISR TO TASK -----------------------
+// WaveOutIsr() posts the index of the half that just finished to the
+// WaveTask message queue, the kernel stamps the post so WaveTask can measure its
+// wake latency. A post that finds the queue full means WaveTask missed a half.
+#define WAVE_TASK_Q_SIZE 2u // one half being filled plus one pending
+
 ////////////////////////////////////////
 
 /**************************************
- * BUFFER Struct:
+ * GEN Struct:
+ *
+ *     Phase state of the per-sample waveform generator,
+ *     kept between blocks so the output is continuous.
+ *************************************/
+typedef struct{
+	q31_t xargsin; //sine phase, q31 fraction of a period
+	INT64U xi; //ramp sample index, 16.16 fixed point
+	INT64U x1; //samples in half a ramp period, 16.16 fixed point
+	INT8U index; //0 rising, 1 falling portion of the ramp
+}WAVE_GEN_T;
+
+/**************************************
+ * MOD Struct:
  *
- *     This struct contains the halfwayflag semaphore for
- *     the DMA ISR to post and WaveTask to pend.     
+ *     Modulator state, advanced once per generated block.
  *************************************/
 typedef struct{
-	INT8U bufindex;
-	OS_SEM halfwayflag;
-}BUF_UPDATE_FLAG_T;
+	q31_t phase; //q31 fraction of a modulator period
+	INT16U lfsr; //noise generator state
+	q15_t last; //modulator value at the end of the previous block
+}WAVE_MOD_STATE_T;
 
 /************************************************************
  * PRIVATE RESOURCES
  ************************************************************/
 static INT16U waveOutputBuffer[BUF_SIZE]; //Ouput buffer to DAC
-static BUF_UPDATE_FLAG_T waveBufUpdateFlag; //Flag struct
+static WAVE_WAKE_STATS_T waveWakeStats;
 static OS_TCB waveTaskTCB;
 static CPU_STK waveTaskStack[APP_CFG_WAVE_TASK_STK_SIZE];
 static WAVE_T waveParams;
 static OS_MUTEX waveMutexKey;
 
+static INT16U waveBurstBuffer[BURST_MAX_SAMPS]; //N cycle table played on a trigger edge
+static INT16U waveBurstSamps; //samples in the armed burst, including the idle sample
+static INT8U waveBurstArmed;
+static volatile INT32U waveBurstEdgeStamp; //waveBurstTsPit value at the SW2 edge request, written by DMA
+static volatile INT32U waveBurstEndStamp; //waveBurstTsPit value after the last sample, written by DMA
+static WAVE_BURST_STATS_T waveBurstStats;
+
+static INT8U waveOutCh; //continuous output DMA channel
+#if !WAVE_DACBUF_EN
+static RES_PERIODIC_T waveOutPit; //PIT pacing waveOutCh
+#endif
+static RES_PERIODIC_T waveBurstOut; //burst sample clock PIT and the channel it paces, table to DAC0
+static INT8U waveBurstTrigCh; //requested by the SW2 edge, stamps the edge
+static INT8U waveBurstStartCh; //linked from waveBurstTrigCh, writes the burst PIT TCTRL
+static INT8U waveBurstEndCh; //linked from the output channel, stamps the last sample
+static INT8U waveBurstTsPit; //free running timestamp counter
+static const INT8C waveOwnerStrg[] = "Wave";
+static const INT8C waveBurstOwnerStrg[] = "Wave burst";
+
+#if WAVE_MOD_EN
+static WAVE_T waveModParams; //modulator type, frequency and depth
+static INT8U waveModMode; //WAVE_MOD_NONE, WAVE_MOD_AM or WAVE_MOD_FM
+#endif
+static const INT32U waveBurstPitStart = PIT_TCTRL_TEN(1); //written to the burst PIT TCTRL by waveBurstStartCh
+#if WAVE_INTERP_EN
+static q15_t waveInterpIn[GEN_BLOCK]; //generator output at GEN_FREQ
+static q15_t waveInterpState[(INTERP_TAPS/INTERP_L)+GEN_BLOCK-1u];
+static arm_fir_interpolate_instance_q15 waveInterp;
+
+// Kaiser windowed sinc (beta=5), cutoff SAMPLE_FREQ/4, gain INTERP_L. Passband flat to 10kHz
+// (-0.2dB), images of a 10kHz tone (14kHz) are -32dB, 16kHz and up below -58dB.
+static const q15_t waveInterpCoeffs[INTERP_TAPS] = {
+    -35, -73, 128, 204, -307, -443, 618, 843, -1132, -1508, 2009, 2707, -3758, -5568, 9635, 29448,
+    29448, 9635, -5568, -3758, 2707, 2009, -1508, -1132, 843, 618, -443, -307, 204, 128, -73, -35
+};
+#endif
+
 /*****************************************************************************************
 * Function Prototypes.
 *****************************************************************************************/
 static void WaveTask(void* p_arg);
+static void WaveResAlloc(void);
+#if WAVE_DACBUF_EN
+static void PDBInit(void);
+#else
 static void PITInit(void);
+#endif
 static void DACInit(void);
 static void DMAInit(void);
 static INT16U SineCalc(q31_t xarg);
-void DMA0_DMA16_IRQHandler(void);
+static void WaveGenerate(WAVE_GEN_T *gen, const WAVE_T *wave, INT8U ratediv, INT16U *outbuf, INT16U nsamps);
+static void WaveOutputStart(void);
+static void WaveOutputStop(void);
+static void BurstDMAInit(void);
+#if WAVE_INTERP_EN
+static void WaveInterp(INT16U *outbuf);
+#endif
+#if WAVE_MOD_EN
+static q15_t WaveModEval(WAVE_MOD_STATE_T *mstate, const WAVE_T *mod);
+static INT32U WaveModFM(INT32U freq, q15_t mval, INT8U depth);
+static void WaveModAM(INT16U *buf, q15_t mstart, q15_t mend, INT8U depth);
+#endif
+static void WaveOutIsr(void);
+static void WaveBurstEndIsr(void);
 
 /***************************************************************************
  *WaveInit() - Initialization function for the WaveModule. After calling this
@@ -102,28 +243,27 @@ void WaveInit(void){
     q31_t xarg; //q31 format input for CMSIS sin function	
     INT8U k; //iterator used in for loops below 
 
+    WaveResAlloc(); // PIT and DMA channels for both output paths
+
     waveParams.freq=10;
-    waveBufUpdateFlag.bufindex = 0u;
     xarg = 0u;
 
     //Populate first half of buffer before enabling DMA and PIT
-    for(k = (BUF_SIZE/2)*waveBufUpdateFlag.bufindex; k < (BUF_SIZE/2)*(waveBufUpdateFlag.bufindex+1); k++){
+    for(k = 0u; k < (BUF_SIZE/2); k++){
             xarg += (q31_t)waveParams.freq*SAMPLE_PERIOD; //increment xarg to next sample
             xarg &= !MSB_MASK; // ensure xarg remains positive
             waveOutputBuffer[k] = SineCalc(xarg); //update buffer index k
     }
 
-    waveBufUpdateFlag.bufindex = 1u; //set index of buffer to next half
+	OSMutexCreate(&waveMutexKey, "Wave Params Mutex", &os_err);
 
-    DACInit(); // prep for samples from DMA
-    DMAInit(); // configure DMA
-    PITInit(); // configure PIT to set sample rate
-    DMAMUX->CHCFG[0] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60); // ENABLE
-    NVIC_EnableIRQ(DMA0_DMA16_IRQn); // DMA CH0 Interrupts enabled
-    DMA0->SERQ=DMA_SERQ_SERQ(0); // Enable DMA channel
+#if WAVE_INTERP_EN
+	// WaveTask filters from its first wake, so the state must be set first
+	(void)arm_fir_interpolate_init_q15(&waveInterp, INTERP_L, INTERP_TAPS, waveInterpCoeffs, waveInterpState, GEN_BLOCK);
+#endif
 
+    WaveOutputStart(); // start DAC, DMA and sample clock
 
-	OSSemCreate(&waveBufUpdateFlag.halfwayflag, "Buffer Halfway Flag", 0u, &os_err);
 	OSTaskCreate((OS_TCB*)&waveTaskTCB,
 	             (CPU_CHAR*)"Wave Task",
 	             (OS_TASK_PTR)WaveTask,
@@ -132,13 +272,12 @@ void WaveInit(void){
 	             (CPU_STK*)&waveTaskStack[0],
 	             (CPU_STK)(APP_CFG_WAVE_TASK_STK_SIZE / 10u),
 	             (CPU_STK_SIZE) APP_CFG_WAVE_TASK_STK_SIZE,
-	             (OS_MSG_QTY) 0,
+	             (OS_MSG_QTY) WAVE_TASK_Q_SIZE,
 	             (OS_TICK) 0,
 	             (void*) 0,
 	             (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
 	             (OS_ERR*)&os_err);
-
-	OSMutexCreate(&waveMutexKey, "Wave Params Mutex", &os_err);
+    ResDmaIsrSet(waveOutCh, WaveOutIsr); // half buffer interrupts enabled, WaveTask queue exists
 
 }
 
@@ -287,88 +426,405 @@ void WaveAmplSet(INT8U* localampl){
     OSMutexPost(&waveMutexKey, OS_OPT_POST_NONE, &os_err);
 }
 
+/****************************************************************************
+ *WaveBurstArm() - Stop the continuous output and arm a burst of ncycles
+ *            periods of the current waveform. Every falling edge on SW2
+ *            then plays the burst once and the output returns to 1.65V.
+ *            The trigger path is all DMA, no task runs between the edge
+ *            and the first sample.
+ *
+ *            While a burst plays its table and TCDs are left alone. The
+ *            trigger channel's DONE flag is set by the edge and cleared by
+ *            WaveBurstEndIsr() when it re-arms, so with the trigger request
+ *            off, ACTIVE or DONE means a burst is between its edge and its
+ *            end interrupt.
+ *
+ *          Parameters:
+ *              ncycles: number of periods in each burst
+ *
+ *          Returns:
+ *          	WAVE_BURST_ARMED, WAVE_BURST_TOO_LONG if the burst does not
+ *          	fit in BURST_MAX_SAMPS, or WAVE_BURST_BUSY if one is playing
+ ****************************************************************************/
+INT8U WaveBurstArm(INT16U ncycles){
+    OS_ERR os_err;
+    WAVE_T wave;
+    WAVE_GEN_T gen = {0};
+    INT32U nsamps;
+    INT8U status = WAVE_BURST_ARMED;
+    CPU_SR_ALLOC();
+
+    WaveGet(&wave);
+    nsamps = (((INT32U)ncycles*SAMPLE_FREQ) + wave.freq - 1u)/wave.freq; // whole cycles, rounded up
+    if((ncycles == 0u) || ((nsamps + 1u) > BURST_MAX_SAMPS)){
+        return WAVE_BURST_TOO_LONG;
+    } else {}
+
+    OSMutexPend(&waveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS*)0, &os_err);
+    if(waveBurstArmed){
+        CPU_CRITICAL_ENTER(); // WaveBurstEndIsr() re-enables the trigger
+        DMA0->CERQ = DMA_CERQ_CERQ(waveBurstTrigCh); // no new edge while the table is checked
+        if((DMA0->TCD[waveBurstTrigCh].CSR & (DMA_CSR_ACTIVE_MASK | DMA_CSR_DONE_MASK)) != 0u){
+            DMA0->SERQ = DMA_SERQ_SERQ(waveBurstTrigCh);
+            status = WAVE_BURST_BUSY;
+        } else {
+            ResDmaIsrSet(waveBurstEndCh, 0);
+        }
+        CPU_CRITICAL_EXIT();
+    } else {
+        WaveOutputStop();
+    }
+    if(status == WAVE_BURST_ARMED){
+        WaveGenerate(&gen, &wave, 1u, waveBurstBuffer, (INT16U)nsamps);
+        waveBurstBuffer[nsamps] = DAC_IDLE_VAL; // hold 1.65V after the last cycle
+        waveBurstSamps = (INT16U)(nsamps + 1u);
+        BurstDMAInit();
+        waveBurstArmed = TRUE;
+    } else {}
+    OSMutexPost(&waveMutexKey, OS_OPT_POST_NONE, &os_err);
+    return status;
+}
+
+/****************************************************************************
+ *WaveBurstDisarm() - Leave burst mode and restart the continuous output.
+ *
+ *          Parameters: none
+ *          Returns: none
+ ****************************************************************************/
+void WaveBurstDisarm(void){
+    OS_ERR os_err;
+    OSMutexPend(&waveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS*)0, &os_err);
+    if(waveBurstArmed){
+        ResDmaIsrSet(waveBurstEndCh, 0);
+        DMA0->CERQ = DMA_CERQ_CERQ(waveBurstTrigCh);
+        DMA0->CERQ = DMA_CERQ_CERQ(waveBurstOut.dmach);
+        DMAMUX->CHCFG[waveBurstTrigCh] = 0u;
+        PIT->CHANNEL[waveBurstOut.pit].TCTRL = 0u;
+        GpioSw2Init(BURST_TRIG_OFF); // SW2 back to a plain input
+        waveBurstArmed = FALSE;
+        WaveOutputStart();
+    } else {}
+    OSMutexPost(&waveMutexKey, OS_OPT_POST_NONE, &os_err);
+}
+
+/****************************************************************************
+ *WaveBurstStatsGet() - Copies the burst latency counters. Latency is in bus
+ *            cycles from the SW2 edge to the first sample, measured with the
+ *            free running waveBurstTsPit counter. The edge is stamped by the
+ *            DMA channel the PORTA request itself starts, before the burst
+ *            PIT is started, so the trigger path is inside the measurement.
+ *            max - min is the trigger jitter.
+ *
+ *          Parameters:
+ *              localstats: pointer to a local WAVE_BURST_STATS_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveBurstStatsGet(WAVE_BURST_STATS_T *localstats){
+    CPU_SR_ALLOC();
+    CPU_CRITICAL_ENTER();
+    *localstats = waveBurstStats;
+    CPU_CRITICAL_EXIT();
+}
+
+#if WAVE_MOD_EN
+/****************************************************************************
+ *WaveModSet() - Selects the modulation mode and copies the local modulator
+ *            parameters. mod->type is SINWAVE, TRIWAVE or NOISEWAVE,
+ *            mod->freq is limited to MOD_MAX_FREQ and mod->ampl is the
+ *            depth in percent, limited to MOD_MAX_DEPTH.
+ *
+ *          Parameters:
+ *              mode: WAVE_MOD_NONE, WAVE_MOD_AM or WAVE_MOD_FM
+ *              localmod: pointer to local modulator WAVE_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveModSet(INT8U mode, WAVE_T* localmod){
+    OS_ERR os_err;
+    OSMutexPend(&waveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS*)0, &os_err);
+    waveModParams.type = localmod->type;
+    waveModParams.freq = (localmod->freq > MOD_MAX_FREQ) ? MOD_MAX_FREQ : localmod->freq;
+    waveModParams.ampl = (localmod->ampl > MOD_MAX_DEPTH) ? MOD_MAX_DEPTH : localmod->ampl;
+    waveModMode = mode;
+    OSMutexPost(&waveMutexKey, OS_OPT_POST_NONE, &os_err);
+}
+
+/****************************************************************************
+ *WaveModGet() - Copies the modulation mode and modulator parameters.
+ *
+ *          Parameters:
+ *              mode: pointer to local mode
+ *              localmod: pointer to local modulator WAVE_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveModGet(INT8U* mode, WAVE_T* localmod){
+    OS_ERR os_err;
+    OSMutexPend(&waveMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS*)0, &os_err);
+    *mode = waveModMode;
+    *localmod = waveModParams;
+    OSMutexPost(&waveMutexKey, OS_OPT_POST_NONE, &os_err);
+}
+#endif
+
+/****************************************************************************
+ *WaveWakeStatsGet() - Copies the DMA half buffer ISR to WaveTask wake latency
+ *            counters, in CPU_TS counts.
+ *
+ *          Parameters:
+ *              localstats: pointer to a local WAVE_WAKE_STATS_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveWakeStatsGet(WAVE_WAKE_STATS_T *localstats){
+    CPU_SR_ALLOC();
+    CPU_CRITICAL_ENTER();
+    *localstats = waveWakeStats;
+    CPU_CRITICAL_EXIT();
+}
+
 /**************************************************************************
  * WaveTask() - Writes to the ping-pong buffer, OutputBuffer with next 
- * 	        BUF_SIZE chunk of waveform samples.
+ * 	        BUF_SIZE chunk of waveform samples. With WAVE_INTERP_EN the
+ * 	        samples are generated at GEN_FREQ into waveInterpIn and
+ * 	        WaveInterp() fills the half buffer. With WAVE_MOD_EN the
+ * 	        modulator is stepped once per block and applied to the block.
  *
  * Sam Condon, Trevor Schwarz, 02/27/2020
  *************************************************************************/
 static void WaveTask(void* p_arg){
 
 	OS_ERR os_err;
+	WAVE_GEN_T gen = {0}; //generator phase, carried across blocks
+	INT8U start; // first sample of the half buffer being filled
+	OS_MSG_SIZE half; // half buffer the DMA just finished, from the ISR
+	CPU_TS postts; // time stamp of the ISR post
+	CPU_TS wakets;
+	INT16U *genbuf; // generator output, the half buffer itself or the interpolator input
+#if WAVE_MOD_EN
+	WAVE_MOD_STATE_T modstate = {0, MOD_LFSR_SEED, 0};
+	WAVE_T carrier; //waveParams with the per block FM frequency
+	q15_t modstart; //modulator value at the start of the block
+#endif
+
+	(void)p_arg;
+
+	while(1){
+		DB0_TURN_OFF();
+		(void)OSTaskQPend(0u, OS_OPT_PEND_BLOCKING, &half, &postts, &os_err);
+		DB0_TURN_ON();
+		wakets = OS_TS_GET() - postts;
+		waveWakeStats.last = wakets;
+		if(wakets > waveWakeStats.max){
+		    waveWakeStats.max = wakets;
+		} else {}
+		waveWakeStats.count++;
+
+		start = (INT8U)((BUF_SIZE/2)*half);
+#if WAVE_INTERP_EN
+		genbuf = (INT16U *)waveInterpIn;
+#else
+		genbuf = &waveOutputBuffer[start];
+#endif
+
+#if WAVE_MOD_EN
+		carrier = waveParams;
+		modstart = modstate.last;
+		(void)WaveModEval(&modstate, &waveModParams);
+		if(waveModMode == WAVE_MOD_FM){
+		    carrier.freq = WaveModFM(carrier.freq, (q15_t)(((INT32S)modstart + modstate.last)/2), waveModParams.ampl);
+		} else {}
+		WaveGenerate(&gen, &carrier, GEN_RATE_DIV, genbuf, GEN_BLOCK);
+		if(waveModMode == WAVE_MOD_AM){
+		    WaveModAM(genbuf, modstart, modstate.last, waveModParams.ampl);
+		} else {}
+#else
+		WaveGenerate(&gen, &waveParams, GEN_RATE_DIV, genbuf, GEN_BLOCK);
+#endif
+
+#if WAVE_INTERP_EN
+		WaveInterp(&waveOutputBuffer[start]);
+#endif
+	}
+}
+
+/**************************************************************************
+ * WaveGenerate() - Computes nsamps waveform samples into outbuf as 12 bit
+ *                  DAC codes. The generator runs at SAMPLE_FREQ/ratediv.
+ *
+ *    Parameters:
+ *        gen: generator phase state, updated for the next call
+ *        wave: type, frequency and amplitude to generate
+ *        ratediv: SAMPLE_FREQ divider of the generator rate
+ *        outbuf: destination of the samples
+ *        nsamps: number of samples to compute
+ *************************************************************************/
+static void WaveGenerate(WAVE_GEN_T *gen, const WAVE_T *wave, INT8U ratediv, INT16U *outbuf, INT16U nsamps){
+
 	//sin process variables
 	INT64U sinecalcret;
 	INT64U sineprocinter;
 	INT64U xarg; //x value for ramp function processing 
-	q31_t xargsin; //q31 format fixed point for input into sin function
-	
-	//ramp process variables
-	INT64U xi; //sample index for ramp function
-	INT64U x1; //peak ramp sample index
+	INT64U x1; //half ramp period for this call
+	INT16U k; // for loop iterator
 
-	INT8U index; // 0 or 1 flag for portion of ramp wave
-	INT8U k; // for loop iterator
+	if(wave->type==TRIWAVE){
+	    x1=( ((SAMPLE_FREQ/ratediv)/2)*(ONE_16) )/(INT64U)wave->freq;
+	    if((gen->x1 != 0u) && (x1 != gen->x1)){
+	        gen->xi = (gen->xi*x1)/gen->x1; // keep the ramp position when the period changes
+	    } else {}
+	    gen->x1 = x1;
+	} else{}
 
-	xarg = 0u;
-	xargsin=0u;
-	xi = 0u;
-	x1 = 0u;
-	index = 0u;
+	for(k = 0u; k < nsamps; k++){
 
-	(void)p_arg;
+	    if(wave->type==TRIWAVE){
+            //
+	        gen->xi+=ONE_16;
+            if(gen->xi>gen->x1 && gen->index==0){
+                gen->index=1; // shift index up to xi's current location
+            } else if (gen->xi>(2*gen->x1)){
+                gen->index=0;
+                gen->xi-=(2*gen->x1);
+            } else {}
+            // argument adjustment according to index
+            if(gen->index==0){
+                xarg = gen->xi*ONE_32;
+                xarg = xarg/gen->x1;
+                xarg -= 1;
+            } else {
+                // index 1
+                xarg = ((gen->xi-gen->x1)*ONE_32);
+                xarg = xarg/gen->x1;
+                xarg -= 1;
+                xarg = ONE_32 - xarg;
+            }
 
-	while(1){
-		DB0_TURN_OFF();
-		OSSemPend(&waveBufUpdateFlag.halfwayflag, 0u, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-		DB0_TURN_ON();
+            xarg = xarg >> 20; //shift xarg down to 12 bit
+            xarg = xarg*GAIN_SCALE*(INT64U)wave->ampl;
+            xarg += DAC_MID_VAL;
+            xarg -= SCALED_MID_VAL*(INT64U)wave->ampl;
+            xarg = xarg >> 16; //shift xarg down to 16 bit to set in output buffer
+
+            outbuf[k] = (INT16U)xarg;
+	    } else{ // SINWAVE
+            gen->xargsin += (q31_t)wave->freq*SAMPLE_PERIOD*ratediv; //move xarg to next sample
+            gen->xargsin &= ~MSB_MASK; //mask out sign bit of xarg
+            sinecalcret = SineCalc(gen->xargsin);
+            sineprocinter = sinecalcret*(DAC_SAMP_SCALE_SINE)*(INT64U)wave->ampl + DAC_SHIFT((INT64U)wave->ampl);
+            outbuf[k] = (INT16U)(sineprocinter>>32);
+	    }
+	}
+}
+
+#if WAVE_INTERP_EN
+/**********************************************************************
+* WaveInterp() - Upsample the GEN_BLOCK samples in waveInterpIn by
+*                INTERP_L into one half of the ping-pong buffer.
+*                DAC codes are centered and scaled to q15 for the
+*                filter, the q15 result is written in place in outbuf
+*                and converted back to clamped 12 bit DAC codes.
+*
+*    Parameters:
+*        outbuf: first sample of the half buffer to fill
+***********************************************************************/
+static void WaveInterp(INT16U *outbuf){
+
+	INT8U k;
+	INT32S sample;
+
+	for(k = 0u; k < GEN_BLOCK; k++){
+	    waveInterpIn[k] = (q15_t)(((INT32S)(INT16U)waveInterpIn[k] - (INT32S)DAC_IDLE_VAL) << INTERP_Q15_SHIFT);
+	}
+
+	arm_fir_interpolate_q15(&waveInterp, waveInterpIn, (q15_t *)outbuf, GEN_BLOCK);
+
+	for(k = 0u; k < (BUF_SIZE/2u); k++){
+	    sample = ((INT32S)(q15_t)outbuf[k] >> INTERP_Q15_SHIFT) + (INT32S)DAC_IDLE_VAL;
+	    if(sample < 0){
+	        sample = 0;
+	    } else if(sample > (INT32S)DAC_MAX_VAL){
+	        sample = (INT32S)DAC_MAX_VAL;
+	    } else {}
+	    outbuf[k] = (INT16U)sample;
+	}
+}
+#endif
+
+#if WAVE_MOD_EN
+/**********************************************************************
+* WaveModEval() - Advance the modulator by one block and return its q15
+*                 value at the end of the block. The value is also kept
+*                 in mstate->last as the start of the next block. Noise
+*                 draws a new LFSR value once per modulator period.
+**********************************************************************/
+static q15_t WaveModEval(WAVE_MOD_STATE_T *mstate, const WAVE_T *mod){
+	q31_t phase;
+	INT32S tri;
+
+	phase = (mstate->phase + (q31_t)(mod->freq*MOD_BLOCK_PERIOD)) & (q31_t)~MSB_MASK;
+	if(mod->type == SINWAVE){
+	    mstate->last = (q15_t)(arm_sin_q31(phase) >> 16);
+	} else if(mod->type == TRIWAVE){
+	    tri = (INT32S)(phase >> 15); // 0 - 65535 over one period
+	    if(tri < MOD_Q15_ONE){
+	        tri = (2*tri) - MOD_Q15_ONE;
+	    } else {
+	        tri = (3*MOD_Q15_ONE) - 1 - (2*tri);
+	    }
+	    mstate->last = (q15_t)tri;
+	} else { // NOISEWAVE
+	    if(phase < mstate->phase){ // period wrapped, next random level
+	        mstate->lfsr = (mstate->lfsr & 1u) ? ((mstate->lfsr >> 1) ^ MOD_LFSR_TAPS) : (mstate->lfsr >> 1);
+	    } else {}
+	    mstate->last = (q15_t)mstate->lfsr;
+	}
+	mstate->phase = phase;
+	return mstate->last;
+}
+
+/**********************************************************************
+* WaveModFM() - Carrier frequency for one block, freq*(1 + depth*mval),
+*               held to MIN_FREQ - MAX_FREQ.
+**********************************************************************/
+static INT32U WaveModFM(INT32U freq, q15_t mval, INT8U depth){
+	INT32S dev;
+	dev = (INT32S)((freq*depth)/MOD_MAX_DEPTH); // peak deviation in Hz
+	dev = (INT32S)freq + ((dev*mval) >> 15);
+	if(dev < (INT32S)MIN_FREQ){
+	    dev = (INT32S)MIN_FREQ;
+	} else if(dev > (INT32S)MAX_FREQ){
+	    dev = (INT32S)MAX_FREQ;
+	} else {}
+	return (INT32U)dev;
+}
 
-		if(waveParams.type==TRIWAVE){
-		    x1=( (SAMPLE_FREQ/2)*(ONE_16) )/(INT64U)waveParams.freq;
-		} else{}
-
-		for(k = (BUF_SIZE/2)*waveBufUpdateFlag.bufindex; k < (BUF_SIZE/2)*(waveBufUpdateFlag.bufindex+1); k++){
-
-		    if(waveParams.type==TRIWAVE){
-	            //
-		        xi+=ONE_16;
-	            if(xi>x1 && index==0){
-	                index=1; // shift index up to xi's current location
-	            } else if (xi>(2*x1)){
-	                index=0;
-	                xi-=(2*x1);
-	            } else {}
-	            // argument adjustment according to index
-	            if(index==0){
-	                xarg = xi*ONE_32;
-	                xarg = xarg/x1;
-	                xarg -= 1;
-	            } else {
-	                // index 1
-	                xarg = ((xi-x1)*ONE_32);
-	                xarg = xarg/x1;
-	                xarg -= 1;
-	                xarg = ONE_32 - xarg;
-	            }
-
-	            xarg = xarg >> 20; //shift xarg down to 12 bit
-	            xarg = xarg*GAIN_SCALE*(INT64U)waveParams.ampl;
-	            xarg += DAC_MID_VAL;
-	            xarg -= SCALED_MID_VAL*(INT64U)waveParams.ampl;
-	            xarg = xarg >> 16; //shift xarg down to 16 bit to set in output buffer
-
-	            waveOutputBuffer[k] = xarg;
-		    } else{ // SINWAVE
-	            xargsin += (q31_t)waveParams.freq*SAMPLE_PERIOD; //move xarg to next sample
-	            xargsin &= ~MSB_MASK; //mask out sign bit of xarg
-	            sinecalcret = SineCalc(xargsin);
-	            sineprocinter = sinecalcret*(DAC_SAMP_SCALE_SINE)*(INT64U)waveParams.ampl + DAC_SHIFT((INT64U)waveParams.ampl);
-	            waveOutputBuffer[k] = (INT16U)(sineprocinter>>32);
-		    }
-
-
-		}
+/**********************************************************************
+* WaveModAM() - Scale a block of DAC codes around mid-scale. The gain
+*               1 - depth*(1 - m)/2 is computed for the block end points
+*               and ramped linearly across the block, so the peak never
+*               exceeds the carrier amplitude.
+**********************************************************************/
+static void WaveModAM(INT16U *buf, q15_t mstart, q15_t mend, INT8U depth){
+	INT64S dq15; //depth in q15, products reach 2^31 at full depth
+	INT32S gain;
+	INT32S gainstep;
+	INT8U k;
+
+	dq15 = ((INT64S)depth*MOD_Q15_ONE)/MOD_MAX_DEPTH;
+	gain = MOD_Q15_ONE - (INT32S)((dq15*(MOD_Q15_ONE - mstart)) >> 16);
+	gainstep = (MOD_Q15_ONE - (INT32S)((dq15*(MOD_Q15_ONE - mend)) >> 16) - gain)/(INT32S)GEN_BLOCK;
+	for(k = 0u; k < GEN_BLOCK; k++){
+	    buf[k] = (INT16U)((INT32S)DAC_IDLE_VAL + ((((INT32S)buf[k] - (INT32S)DAC_IDLE_VAL)*gain) >> 15));
+	    gain += gainstep;
 	}
 }
+#endif
 
 /**********************************************************************
 * SineCalc() - Helper function for using the arm_sin function
@@ -388,78 +844,302 @@ static INT16U SineCalc(q31_t xarg){
 }
 
 /*****************************************************************************************
-* PITInit() - Initialize PIT to trigger the DMA at 48 kHz.
+* WaveResAlloc() - Take the PIT and DMA channels of the continuous and burst output from
+*                  ResAlloc. Both sample clocks are started and stopped here, so their
+*                  PITs must be owned, not shared through a divider. Halts in ResFail()
+*                  if any of them is already taken.
+*****************************************************************************************/
+static void WaveResAlloc(void){
+    INT8U ok;
+
+#if WAVE_DACBUF_EN
+    waveOutCh = ResDmaAlloc(waveOwnerStrg);
+    ok = (INT8U)((waveOutCh != RES_NONE) && (ResMuxClaim(DMA_SRC_DAC0, waveOwnerStrg) == TRUE));
+#else
+    ok = (INT8U)((ResPeriodicAlloc(PIT_PERIOD, FALSE, waveOwnerStrg, &waveOutPit) == TRUE) &&
+                 (waveOutPit.divch == RES_NONE));
+    waveOutCh = waveOutPit.dmach;
+#endif
+    if(ok == FALSE){
+        ResFail(waveOwnerStrg);
+    } else {}
+
+    ok = (INT8U)((ResPeriodicAlloc(PIT_PERIOD, FALSE, waveBurstOwnerStrg, &waveBurstOut) == TRUE) &&
+                 (waveBurstOut.divch == RES_NONE));
+    waveBurstTrigCh = ResDmaAlloc(waveBurstOwnerStrg);
+    waveBurstStartCh = ResDmaAlloc(waveBurstOwnerStrg);
+    waveBurstEndCh = ResDmaAlloc(waveBurstOwnerStrg);
+    waveBurstTsPit = ResPitAlloc(waveBurstOwnerStrg);
+    if((ok == FALSE) || (waveBurstTrigCh == RES_NONE) || (waveBurstStartCh == RES_NONE) ||
+       (waveBurstEndCh == RES_NONE) || (waveBurstTsPit == RES_NONE) ||
+       (ResMuxClaim(DMA_SRC_PORTA, waveBurstOwnerStrg) == FALSE)){
+        ResFail(waveBurstOwnerStrg);
+    } else {}
+}
+
+#if !WAVE_DACBUF_EN
+/*****************************************************************************************
+* PITInit() - Initialize the output PIT to trigger the DMA at 48 kHz. ResAlloc has
+*             already turned on the PIT module.
 *
 * Trevor Schwarz, 2/22/2020
 *****************************************************************************************/
 static void PITInit(void){
-    SIM->SCGC6 |= SIM_SCGC6_PIT(1); // Enable PIT's gate clock
-    PIT->MCR = PIT_MCR_MDIS(0); // Enable PIT timer in module control register
-    PIT->CHANNEL[0].LDVAL = PIT_VAL; // Set to fire every 20.833us (48kHz)
-    PIT->CHANNEL[0].TCTRL=PIT_TCTRL_TEN(1); // Timer enabled
-    PIT->CHANNEL[0].TCTRL|=PIT_TCTRL_TIE(1); // Interrupt firing enabled
+    PIT->CHANNEL[waveOutPit.pit].LDVAL = PIT_VAL; // Set to fire every 20.833us (48kHz)
+    PIT->CHANNEL[waveOutPit.pit].TCTRL=PIT_TCTRL_TEN(1); // Timer enabled
+    PIT->CHANNEL[waveOutPit.pit].TCTRL|=PIT_TCTRL_TIE(1); // Interrupt firing enabled
+}
+#endif
+
+#if WAVE_DACBUF_EN
+/*****************************************************************************************
+* PDBInit() - Initialize PDB0 to trigger the DAC0 buffer at 48 kHz. The PDB is started
+*             once by software and then runs continuously, each DAC interval trigger
+*             steps the DAC buffer read pointer to the next sample.
+*****************************************************************************************/
+static void PDBInit(void){
+    SIM->SCGC6 |= SIM_SCGC6_PDB(1); // Enable PDB's gate clock
+    PDB0->MOD = PDB_MOD_MOD(PDB_DAC_VAL); // counter period, matches the DAC interval
+    PDB0->DAC[0].INT = PDB_INT_INT(PDB_DAC_VAL); // DAC interval trigger every 20.833us (48kHz)
+    PDB0->DAC[0].INTC = PDB_INTC_TOE(1); // DAC interval trigger enabled
+    PDB0->SC = PDB_SC_TRGSEL(PDB_TRG_SOFTWARE) | PDB_SC_CONT(1) | PDB_SC_PDBEN(1); // continuous mode
+    PDB0->SC |= PDB_SC_LDOK(1); // load MOD and DAC interval registers
+    PDB0->SC |= PDB_SC_SWTRIG(1); // start counting
 }
+#endif
 
 /*****************************************************************************************
 * DACInit() - Initialize DAC to output samples from DMA input
 *
+*   With WAVE_DACBUF_EN the DAC data buffer is used in normal (circular) mode. A DMA
+*   request is raised at the watermark (read pointer 4 words from the upper limit) to
+*   refill DAT[0]-DAT[7] and at the top (read pointer back to 0) to refill DAT[8]-DAT[15],
+*   so each half of the DAC buffer is written while the other half is being played.
+*   The buffer starts at the idle level, the first 16 samples out are 1.65V.
+*
 * Trevor Schwarz, 2/22/2020
 *****************************************************************************************/
 static void DACInit(void){
+#if WAVE_DACBUF_EN
+    INT8U k;
+#endif
     SIM->SCGC2 |= SIM_SCGC2_DAC0(1); // Enable DAC0's gate clocks
     SIM->SCGC6 |= SIM_SCGC6_DAC0(1);
+#if WAVE_DACBUF_EN
+    for(k = 0u; k < DACBUF_WORDS; k++){ // start buffer at the idle level
+        DAC0->DAT[k].DATL = (INT8U)DAC_IDLE_VAL;
+        DAC0->DAT[k].DATH = (INT8U)(DAC_IDLE_VAL>>8);
+    }
+    DAC0->C2 = DAC_C2_DACBFUP(DACBUF_WORDS-1u) | DAC_C2_DACBFRP(0); // use all 16 words, start at word 0
+    DAC0->C1 = DAC_C1_DACBFEN(1) | DAC_C1_DACBFMD(0) | DAC_C1_DACBFWM(DACBUF_WM_4WORDS);
+    DAC0->C0 = DAC_C0_DACTRGSEL(0) | DAC_C0_DACRFS(1) | DAC_C0_DACBWIEN(1) | DAC_C0_DACBTIEN(1); // PDB trigger, VDDA reference
+    DAC0->C0 |= DAC_C0_DACEN(1); // DAC0 enabled
+    DAC0->SR = 0u; // clear read pointer flags so the first request is the watermark
+    DAC0->C1 |= DAC_C1_DMAEN(1); // buffer flags become DMA requests
+#else
     DAC0->C0 |= DAC_C0_DACSWTRG(1); // Enable software trigger
     DAC0->C0 |= DAC_C0_DACRFS(1); // Set DACREF_2 as the reference voltage (VDDA)
     DAC0->C0 |= DAC_C0_DACEN(1); // DAC0 enabled
     DAC0->C1 |= DAC_C1_DMAEN(1); // enable input as DMA
+#endif
 }
 
 /*****************************************************************************************
-* DMAInit() - Configures DMA channel 0 to be triggered by PIT channel 0
+* DMAInit() - Configures waveOutCh to be triggered by its PIT, or by the DAC0
+*             buffer flags when WAVE_DACBUF_EN is set. In the DAC buffer case each request
+*             moves DACBUF_BURST samples and the destination wraps over the 16 DAC words.
 * 
 * Trevor Schwarz, 2/22/2020
 *****************************************************************************************/
 static void DMAInit(void){
-    SIM->SCGC6 |= SIM_SCGC6_DMAMUX(1); // Enable gate clocks
-    SIM->SCGC7 |= SIM_SCGC7_DMA(1);
-    DMAMUX->CHCFG[0] |= DMAMUX_CHCFG_ENBL(0); // disable to change settings
-    DMAMUX->CHCFG[0] |= DMAMUX_CHCFG_TRIG(0); // no trigger
+    DMAMUX->CHCFG[waveOutCh] = 0u; // disable to change settings, gate clocks are on from ResAlloc
 
     // SOURCE SETUP ----------------------------------------------------------------------
-    DMA0->TCD[0].SADDR = DMA_SADDR_SADDR(waveOutputBuffer); // start address of PING-PONG buffer
+    DMA0->TCD[waveOutCh].SADDR = DMA_SADDR_SADDR(waveOutputBuffer); // start address of PING-PONG buffer
 
     // 16 bit samples from source, 16 samples to destination (masked to 12 bits)
-    DMA0->TCD[0].ATTR = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0);
-    DMA0->TCD[0].SOFF = DMA_SOFF_SOFF(2); // source address offset of 2 bytes (16bits) per sent sample ( SAMPLE_SIZE )
+#if WAVE_DACBUF_EN
+    DMA0->TCD[waveOutCh].ATTR = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(DACBUF_DMOD);
+#else
+    DMA0->TCD[waveOutCh].ATTR = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0);
+#endif
+    DMA0->TCD[waveOutCh].SOFF = DMA_SOFF_SOFF(2); // source address offset of 2 bytes (16bits) per sent sample ( SAMPLE_SIZE )
 
-    DMA0->TCD[0].SLAST = DMA_SLAST_SLAST(-(BUF_SIZE*SAMPLE_SIZE)); // length of table start return (offset value) -------------------- SIZE (BYTES) OF PING PONG BUFFER
+    DMA0->TCD[waveOutCh].SLAST = DMA_SLAST_SLAST(-(BUF_SIZE*SAMPLE_SIZE)); // length of table start return (offset value) -------------------- SIZE (BYTES) OF PING PONG BUFFER
 
     // DESTINATION SETUP -----------------------------------------------------------------
-    DMA0->TCD[0].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL); // destination address is DAC data low register
-    DMA0->TCD[0].DOFF = DMA_DOFF_DOFF(0); // destination offset not applicable
+    DMA0->TCD[waveOutCh].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL); // destination address is DAC data low register
+#if WAVE_DACBUF_EN
+    DMA0->TCD[waveOutCh].DOFF = DMA_DOFF_DOFF(SAMPLE_SIZE); // step through DAT[n], wrapped by DMOD
+#else
+    DMA0->TCD[waveOutCh].DOFF = DMA_DOFF_DOFF(0); // destination offset not applicable
+#endif
 
-    DMA0->TCD[0].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(2); // minor loop same as sample size
-    DMA0->TCD[0].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0) | DMA_CITER_ELINKNO_CITER(BUF_SIZE); // minor loops per major loop = number of samples
-    DMA0->TCD[0].BITER_ELINKNO = DMA_BITER_ELINKNO_ELINK(0) | DMA_BITER_ELINKNO_BITER(BUF_SIZE); // value reloaded into CITER field
-    DMA0->TCD[0].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0); // destination offset not applicable (destination doesn't change)
+    DMA0->TCD[waveOutCh].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(WAVE_DMA_NBYTES); // minor loop is one sample, or one DAC buffer burst
+    DMA0->TCD[waveOutCh].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0) | DMA_CITER_ELINKNO_CITER(WAVE_DMA_ITER); // minor loops per major loop
+    DMA0->TCD[waveOutCh].BITER_ELINKNO = DMA_BITER_ELINKNO_ELINK(0) | DMA_BITER_ELINKNO_BITER(WAVE_DMA_ITER); // value reloaded into CITER field
+    DMA0->TCD[waveOutCh].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0); // destination returns to DAT[0] on its own (DMOD wrap or no offset)
 
     // ENABLE INTERRUPTS at halfway and end of major loop, set default values for other fields
-    DMA0->TCD[0].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) | DMA_CSR_BWC(3) |
+    DMA0->TCD[waveOutCh].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) | DMA_CSR_BWC(3) |
                        DMA_CSR_DREQ(0) |DMA_CSR_START(0) |
                        DMA_CSR_INTHALF(1) | DMA_CSR_INTMAJOR(1);
 
 }
 
+/*****************************************************************************************
+* WaveOutputStart() - Start continuous output of the ping-pong buffer from its first half.
+*****************************************************************************************/
+static void WaveOutputStart(void){
+    DACInit(); // prep for samples from DMA
+    DMAInit(); // configure DMA
+#if WAVE_DACBUF_EN
+    PDBInit(); // configure PDB to step the DAC buffer at the sample rate
+    DMAMUX->CHCFG[waveOutCh] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(0)|DMAMUX_CHCFG_SOURCE(DMA_SRC_DAC0); // ENABLE
+#else
+    PITInit(); // configure PIT to set sample rate
+    DMAMUX->CHCFG[waveOutCh] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(DMA_SRC_ALWAYS_ON); // ENABLE
+#endif
+    DMA0->SERQ=DMA_SERQ_SERQ(waveOutCh); // Enable DMA channel
+}
+
+/*****************************************************************************************
+* WaveOutputStop() - Stop the continuous output and leave DAC0 at 1.65V with the data
+*                    buffer off, so DAT[0] drives the output directly.
+*****************************************************************************************/
+static void WaveOutputStop(void){
+    DMA0->CERQ = DMA_CERQ_CERQ(waveOutCh);
+    DMAMUX->CHCFG[waveOutCh] = 0u;
+#if WAVE_DACBUF_EN
+    PDB0->SC = 0u; // PDB disabled, no more DAC triggers
+#else
+    PIT->CHANNEL[waveOutPit.pit].TCTRL = 0u;
+#endif
+    DAC0->C1 = 0u; // data buffer and DAC DMA requests off
+    DAC0->C0 = DAC_C0_DACEN(1) | DAC_C0_DACRFS(1) | DAC_C0_DACTRGSEL(1);
+    DAC0->DAT[0].DATL = (INT8U)DAC_IDLE_VAL;
+    DAC0->DAT[0].DATH = (INT8U)(DAC_IDLE_VAL>>8);
+}
+
+/*****************************************************************************************
+* BurstDMAInit() - Set up the burst PITs and DMA channels for one burst per SW2 edge.
+*
+*   SW2 edge -> waveBurstTrigCh copies the waveBurstTsPit count, links to waveBurstStartCh
+*   waveBurstStartCh -> writes TEN to the burst PIT TCTRL
+*   burst PIT -> waveBurstOut.dmach moves one table sample to DAT[0] per period, after
+*                the last sample it clears its own request enable and links to
+*                waveBurstEndCh
+*   waveBurstEndCh interrupt -> WaveBurstEndIsr() updates the latency counters and re-arms
+*****************************************************************************************/
+static void BurstDMAInit(void){
+    PIT->CHANNEL[waveBurstOut.pit].TCTRL = 0u; // sample clock stopped until the trigger
+    PIT->CHANNEL[waveBurstOut.pit].LDVAL = PIT_VAL;
+    PIT->CHANNEL[waveBurstTsPit].LDVAL = PIT_FREE_RUN;
+    PIT->CHANNEL[waveBurstTsPit].TCTRL = PIT_TCTRL_TEN(1);
+
+    // OUTPUT: burst table to DAC data register, one sample per burst PIT trigger
+    DMA0->TCD[waveBurstOut.dmach].SADDR = DMA_SADDR_SADDR(waveBurstBuffer);
+    DMA0->TCD[waveBurstOut.dmach].ATTR = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1) | DMA_ATTR_SMOD(0) | DMA_ATTR_DMOD(0);
+    DMA0->TCD[waveBurstOut.dmach].SOFF = DMA_SOFF_SOFF(SAMPLE_SIZE);
+    DMA0->TCD[waveBurstOut.dmach].SLAST = DMA_SLAST_SLAST(-((INT32S)waveBurstSamps*SAMPLE_SIZE)); // back to table start
+    DMA0->TCD[waveBurstOut.dmach].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL);
+    DMA0->TCD[waveBurstOut.dmach].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[waveBurstOut.dmach].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(SAMPLE_SIZE);
+    DMA0->TCD[waveBurstOut.dmach].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(waveBurstSamps);
+    DMA0->TCD[waveBurstOut.dmach].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(waveBurstSamps);
+    DMA0->TCD[waveBurstOut.dmach].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[waveBurstOut.dmach].CSR = DMA_CSR_DREQ(1) | DMA_CSR_MAJORELINK(1) | DMA_CSR_MAJORLINKCH(waveBurstEndCh);
+
+    // TRIGGER: stamp the edge on the PORTA request itself, then start the burst PIT
+    DMA0->TCD[waveBurstTrigCh].SADDR = DMA_SADDR_SADDR(&PIT->CHANNEL[waveBurstTsPit].CVAL);
+    DMA0->TCD[waveBurstTrigCh].ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+    DMA0->TCD[waveBurstTrigCh].SOFF = DMA_SOFF_SOFF(0);
+    DMA0->TCD[waveBurstTrigCh].SLAST = DMA_SLAST_SLAST(0);
+    DMA0->TCD[waveBurstTrigCh].DADDR = DMA_DADDR_DADDR(&waveBurstEdgeStamp);
+    DMA0->TCD[waveBurstTrigCh].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[waveBurstTrigCh].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(4u);
+    DMA0->TCD[waveBurstTrigCh].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+    DMA0->TCD[waveBurstTrigCh].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+    DMA0->TCD[waveBurstTrigCh].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[waveBurstTrigCh].CSR = DMA_CSR_DREQ(1) | DMA_CSR_MAJORELINK(1) | DMA_CSR_MAJORLINKCH(waveBurstStartCh);
+
+    // START: burst PIT on, started only by the link from the edge stamp
+    DMA0->TCD[waveBurstStartCh].SADDR = DMA_SADDR_SADDR(&waveBurstPitStart);
+    DMA0->TCD[waveBurstStartCh].ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+    DMA0->TCD[waveBurstStartCh].SOFF = DMA_SOFF_SOFF(0);
+    DMA0->TCD[waveBurstStartCh].SLAST = DMA_SLAST_SLAST(0);
+    DMA0->TCD[waveBurstStartCh].DADDR = DMA_DADDR_DADDR(&PIT->CHANNEL[waveBurstOut.pit].TCTRL);
+    DMA0->TCD[waveBurstStartCh].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[waveBurstStartCh].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(4u);
+    DMA0->TCD[waveBurstStartCh].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+    DMA0->TCD[waveBurstStartCh].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+    DMA0->TCD[waveBurstStartCh].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[waveBurstStartCh].CSR = 0u;
+
+    // END TIMESTAMP: copy the free running PIT count, started only by the link from waveBurstOut.dmach
+    DMA0->TCD[waveBurstEndCh].SADDR = DMA_SADDR_SADDR(&PIT->CHANNEL[waveBurstTsPit].CVAL);
+    DMA0->TCD[waveBurstEndCh].ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+    DMA0->TCD[waveBurstEndCh].SOFF = DMA_SOFF_SOFF(0);
+    DMA0->TCD[waveBurstEndCh].SLAST = DMA_SLAST_SLAST(0);
+    DMA0->TCD[waveBurstEndCh].DADDR = DMA_DADDR_DADDR(&waveBurstEndStamp);
+    DMA0->TCD[waveBurstEndCh].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[waveBurstEndCh].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(4u);
+    DMA0->TCD[waveBurstEndCh].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(1u);
+    DMA0->TCD[waveBurstEndCh].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(1u);
+    DMA0->TCD[waveBurstEndCh].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[waveBurstEndCh].CSR = DMA_CSR_INTMAJOR(1);
+
+    DMAMUX->CHCFG[waveBurstOut.dmach] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(DMA_SRC_ALWAYS_ON);
+    DMAMUX->CHCFG[waveBurstTrigCh] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(0)|DMAMUX_CHCFG_SOURCE(DMA_SRC_PORTA);
+    GpioSw2Init(BURST_TRIG_IRQC); // SW2 falling edge requests waveBurstTrigCh
+
+    ResDmaIsrSet(waveBurstEndCh, WaveBurstEndIsr);
+    DMA0->CDNE = DMA_CDNE_CDNE(waveBurstTrigCh); // no burst in progress
+    DMA0->SERQ = DMA_SERQ_SERQ(waveBurstOut.dmach);
+    DMA0->SERQ = DMA_SERQ_SERQ(waveBurstTrigCh);
+}
+
+/************************************************************************
+ *WaveBurstEndIsr() - Runs once at the end of each burst. Stops the
+ *                          sample clock, folds the DMA timestamps into the
+ *                          latency counters and re-arms the trigger.
+ ************************************************************************/
+static void WaveBurstEndIsr(void){
+    INT32U latency;
+    OSIntEnter();
+    DMA0->CINT = DMA_CINT_CINT(waveBurstEndCh); // clear interrupt flag
+    PIT->CHANNEL[waveBurstOut.pit].TCTRL = 0u; // next edge restarts the burst PIT from a full period
+    // down counter: elapsed edge to last sample, minus the paced part of the burst,
+    // leaves the edge to first sample latency with the burst PIT start inside it
+    latency = (waveBurstEdgeStamp - waveBurstEndStamp) - ((INT32U)(waveBurstSamps - 1u)*PIT_PERIOD);
+    if((waveBurstStats.count == 0u) || (latency < waveBurstStats.min)){
+        waveBurstStats.min = latency;
+    } else {}
+    if(latency > waveBurstStats.max){
+        waveBurstStats.max = latency;
+    } else {}
+    waveBurstStats.last = latency;
+    waveBurstStats.count++;
+    DMA0->CDNE = DMA_CDNE_CDNE(waveBurstTrigCh); // burst over, WaveBurstArm() may rewrite it
+    DMA0->SERQ = DMA_SERQ_SERQ(waveBurstOut.dmach); // re-arm for the next edge
+    DMA0->SERQ = DMA_SERQ_SERQ(waveBurstTrigCh);
+    OSIntExit();
+}
+
 /************************************************************************
- *DMA0_DMA16_IRQHandler() - Interrupt every time we run through 1/2 of the output
+ *WaveOutIsr() - Interrupt every time we run through 1/2 of the output
  *                          buffer.
  ************************************************************************/
-void DMA0_DMA16_IRQHandler(void){
+static void WaveOutIsr(void){
     OS_ERR os_err;
+    OS_MSG_SIZE half;
     OSIntEnter();
-    DMA0->CINT = DMA_CINT_CINT(0); // clear interrupt flag
-    // toggle index and post semaphore
-    waveBufUpdateFlag.bufindex^=1; // toggle index
-    (void)OSSemPost(&waveBufUpdateFlag.halfwayflag, OS_OPT_POST_1, &os_err); // set the toggle flag
+    DMA0->CINT = DMA_CINT_CINT(waveOutCh); // clear interrupt flag
+    // CITER is at WAVE_DMA_ITER/2 or below while the second half plays, back at WAVE_DMA_ITER after the major loop
+    half = ((DMA0->TCD[waveOutCh].CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK) <= (WAVE_DMA_ITER/2u)) ? 0u : 1u;
+    OSTaskQPost(&waveTaskTCB, (void *)0, half, OS_OPT_POST_FIFO, &os_err); // half index sent as the message size
+    if(os_err != OS_ERR_NONE){
+        waveWakeStats.overruns++; // WaveTask still owes a fill
+    } else {}
     OSIntExit();
 }
@@ -20,6 +20,16 @@
  *********************************************/
 #define SINWAVE 1U
 #define TRIWAVE 0U
+#define NOISEWAVE 2U // modulator only
+
+#define WAVE_MOD_NONE 0U
+#define WAVE_MOD_AM 1U
+#define WAVE_MOD_FM 2U
+#define WAVE_BURST_ARMED 0U // WaveBurstArm() results
+#define WAVE_BURST_TOO_LONG 1U
+#define WAVE_BURST_BUSY 2U
+#define MOD_MAX_FREQ 100U // modulator is evaluated once per 64 sample block
+#define MOD_MAX_DEPTH 100U // depth in percent
 
 #define MIN_FREQ 10U
 #define MAX_FREQ 10000
@@ -36,6 +46,33 @@ typedef struct {
     INT8U ampl;
 }WAVE_T;
 
+/**********************************************************
+* Burst Stats Struct:
+*
+*     Trigger to first sample latency of burst mode in bus
+*     cycles. max - min is the trigger jitter.
+***********************************************************/
+typedef struct {
+    INT32U count;
+    INT32U last;
+    INT32U min;
+    INT32U max;
+}WAVE_BURST_STATS_T;
+
+/**********************************************************
+* Wake Stats Struct:
+*
+*     WaveTask wake latency after the DMA half buffer ISR,
+*     in CPU_TS counts. overruns counts ISR posts that found
+*     WaveTask a whole half behind.
+***********************************************************/
+typedef struct {
+    INT32U count;
+    CPU_TS last;
+    CPU_TS max;
+    INT32U overruns;
+}WAVE_WAKE_STATS_T;
+
 /***************************************************************************
  *WaveInit() - Initialization function for the WaveModule. After calling this
  	       function, a waveform starting at a default value of 10 Hz. will
@@ -135,6 +172,80 @@ void WaveAmplGet(INT8U* localampl);
  ****************************************************************************/
 void WaveAmplSet(INT8U* localampl);
 
+/****************************************************************************
+ *WaveWakeStatsGet() - Copies the WaveTask wake latency counters.
+ *
+ *          Parameters:
+ *              localstats: pointer to a local WAVE_WAKE_STATS_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveWakeStatsGet(WAVE_WAKE_STATS_T *localstats);
+
+/****************************************************************************
+ *WaveBurstArm() - Stops the continuous output and arms a burst of ncycles
+ *            periods of the current waveform. Each falling edge on SW2 plays
+ *            the burst once, started by DMA with no task in the path. The
+ *            output rests at 1.65 V between bursts.
+ *
+ *          Parameters:
+ *              ncycles: number of periods in each burst
+ *
+ *          Returns:
+ *          	WAVE_BURST_ARMED, WAVE_BURST_TOO_LONG if the burst does not fit
+ *          	the burst table, or WAVE_BURST_BUSY if a burst is playing; the
+ *          	armed burst is then unchanged
+ ****************************************************************************/
+INT8U WaveBurstArm(INT16U ncycles);
+
+/****************************************************************************
+ *WaveBurstDisarm() - Leaves burst mode and restarts the continuous output.
+ *
+ *          Parameters: none
+ *          Returns: none
+ ****************************************************************************/
+void WaveBurstDisarm(void);
+
+/****************************************************************************
+ *WaveBurstStatsGet() - Copies the burst trigger latency counters.
+ *
+ *          Parameters:
+ *              localstats: pointer to a local WAVE_BURST_STATS_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveBurstStatsGet(WAVE_BURST_STATS_T *localstats);
+
+/****************************************************************************
+ *WaveModSet() - Selects AM, FM or no modulation of the output. The modulator
+ *            is a WAVE_T of its own: type SINWAVE, TRIWAVE or NOISEWAVE,
+ *            freq up to MOD_MAX_FREQ Hz and ampl as the depth in percent.
+ *            For FM the depth is the peak deviation as a percent of the
+ *            carrier frequency.
+ *
+ *          Parameters:
+ *              mode: WAVE_MOD_NONE, WAVE_MOD_AM or WAVE_MOD_FM
+ *              localmod: pointer to local modulator WAVE_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveModSet(INT8U mode, WAVE_T* localmod);
+
+/****************************************************************************
+ *WaveModGet() - Copies the modulation mode and modulator parameters.
+ *
+ *          Parameters:
+ *              mode: pointer to local mode
+ *              localmod: pointer to local modulator WAVE_T
+ *
+ *          Returns:
+ *          	none
+ ****************************************************************************/
+void WaveModGet(INT8U* mode, WAVE_T* localmod);
+
 ////////////////////////////////////////////////
 
 
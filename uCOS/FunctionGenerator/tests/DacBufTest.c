@@ -0,0 +1,679 @@
+/********************************************************************************
+* DacBufTest - Host register model of the WaveModule output path.  Proves the
+* 			   DAC buffer path (WAVE_DACBUF_EN 1: PDB0 steps the DAC0 data
+* 			   buffer, its watermark and top flags request 8 sample DMA bursts)
+* 			   plays the ping-pong buffer in the same order as the per-sample
+* 			   path (WAVE_DACBUF_EN 0: a PIT triggers one DMA transfer to DAT[0]
+* 			   per sample).
+*
+* 		dacbuftest0		built with WAVE_DACBUF_EN 0
+* 		dacbuftest1		built with WAVE_DACBUF_EN 1
+*
+* 	WaveModule.c is included so WaveInit() and the real DACInit(), DMAInit(),
+* 	PITInit()/PDBInit() and WaveOutIsr() run against plain storage registers,
+* 	on the channels ResAlloc hands out; ResAlloc.c is linked and its DMA
+* 	vectors are called for the channel that interrupts.  The model then plays
+* 	TEST_SECONDS of sample periods: the PIT triggers or the PDB0 DAC interval
+* 	trigger, the DAC buffer read pointer and
+* 	flags, and the eDMA minor and major loops with SOFF/DOFF, DMOD, SLAST and
+* 	the half and major interrupts, all from what the firmware wrote.
+*
+* 	WaveTask is replaced by a fill TEST_FILL_DELAY samples after each ISR post
+* 	that writes the next values of a 12 bit counter into the posted half, so
+* 	the DAC must output 0, 1, 2, ... after the path's startup samples at the
+* 	idle level.  Prints the startup length, the DMA requests and ISR posts per
+* 	second, and exits 1 if the output breaks the sequence anywhere.  Last,
+* 	TestBurst() checks burst mode has its own channels and that re-arming
+* 	while a burst plays is refused.
+*
+********************************************************************************/
+
+//INCLUDE DEPENDENCIES////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MCUType.h" // before WaveModule.c, its directory has the target one
+#include "WaveModule.c"
+//////////////////////////////
+
+//DEFINES AND MACROS////////////////////////////////////////////////////////////////////
+#define TEST_BUS_FREQ 60000000u // PIT and PDB clock
+#define TEST_SECONDS 4u
+#define TEST_FILL_DELAY 48u // samples from the ISR post to the fill, 3/4 of the half buffer time
+#define TEST_SEQ_MASK 0x0fffu // the counter written to the buffer, 12 bits as the DAC
+#define TEST_SRC_DAC0 45u // DMAMUX source of the DAC0 buffer flags, K65 reference manual
+#define TEST_SRC_ALWAYS_ON 60u
+#define TEST_PIT_TRIG_CHS 4u // DMA channels 0-3 can be triggered by PIT channels 0-3
+#define TEST_DMA_CHS 32u
+#define TEST_DMA_VECTORS 16u // DMAn and DMAn+16 share a vector
+#define TEST_BURST_FREQ 1000u // Hz, 48 samples a cycle so a burst of a few cycles fits
+#if WAVE_DACBUF_EN
+#define TEST_STARTUP_SAMPS (DACBUF_WORDS - 1u) // idle words played before DAT[0] comes round
+#else
+#define TEST_STARTUP_SAMPS 0u
+#endif
+////////////////////////////////////////////////////////////////////////////////////////
+
+//REGISTERS//////////////////////////////////////////////////////////////////////////////
+SIM_Type TestRegSim;
+DAC_Type TestRegDac0;
+PDB_Type TestRegPdb0;
+DMA_Type TestRegDma0;
+DMAMUX_Type TestRegDmamux;
+PIT_Type TestRegPit;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//DMA VECTORS, DEFINED IN RESALLOC.C////////////////////////////////////////////////////
+void DMA0_DMA16_IRQHandler(void);
+void DMA1_DMA17_IRQHandler(void);
+void DMA2_DMA18_IRQHandler(void);
+void DMA3_DMA19_IRQHandler(void);
+void DMA4_DMA20_IRQHandler(void);
+void DMA5_DMA21_IRQHandler(void);
+void DMA6_DMA22_IRQHandler(void);
+void DMA7_DMA23_IRQHandler(void);
+void DMA8_DMA24_IRQHandler(void);
+void DMA9_DMA25_IRQHandler(void);
+void DMA10_DMA26_IRQHandler(void);
+void DMA11_DMA27_IRQHandler(void);
+void DMA12_DMA28_IRQHandler(void);
+void DMA13_DMA29_IRQHandler(void);
+void DMA14_DMA30_IRQHandler(void);
+void DMA15_DMA31_IRQHandler(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE RESOURCES/////////////////////////////////////////////////////////////////////
+static INT32U testSeq; // next counter value to fill
+static INT32U testFillDue; // samples until the pending fill, 0 none pending
+static OS_MSG_SIZE testFillHalf;
+static INT32U testPdbRunning;
+static INT32U testIrqEnabled;
+static INT32U testDmaRequests;
+static INT32U testDmaBytes;
+static INT32U testIsrPosts;
+static INT32U testErrors;
+static CPU_TS testNow;
+static void (*const testDmaVectors[TEST_DMA_VECTORS])(void) = {
+	DMA0_DMA16_IRQHandler, DMA1_DMA17_IRQHandler, DMA2_DMA18_IRQHandler, DMA3_DMA19_IRQHandler,
+	DMA4_DMA20_IRQHandler, DMA5_DMA21_IRQHandler, DMA6_DMA22_IRQHandler, DMA7_DMA23_IRQHandler,
+	DMA8_DMA24_IRQHandler, DMA9_DMA25_IRQHandler, DMA10_DMA26_IRQHandler, DMA11_DMA27_IRQHandler,
+	DMA12_DMA28_IRQHandler, DMA13_DMA29_IRQHandler, DMA14_DMA30_IRQHandler, DMA15_DMA31_IRQHandler
+};
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PRIVATE PROTOTYPES////////////////////////////////////////////////////////////////////
+static void TestFill(OS_MSG_SIZE half);
+static void TestSync(void);
+static void TestTick(void);
+static void TestDacTrigger(void);
+static void TestDmaRequest(INT32U ch);
+static void TestDmaMinor(INT32U ch);
+static INT32U TestModAdd(INT32U addr, INT32S off, INT32U mod);
+static void TestCheckAddr(INT32U addr, INT32U size, const void *base, INT32U len, const char *what);
+static INT32U TestDacOut(void);
+static INT32U TestSampleRate(void);
+static void TestBurst(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void){
+	INT32U samp;
+	INT32U out;
+	INT32U lead = 0u;
+	INT32U started = 0u;
+	INT32U expect = 0u;
+	INT32U rate;
+	INT32U nsamps;
+	int status = 0;
+
+	memset((void *)&TestRegDma0, 0, sizeof(TestRegDma0));
+	TestRegDma0.SERQ = DMA_REG_IDLE;
+	TestRegDma0.CERQ = DMA_REG_IDLE;
+	TestRegDma0.CDNE = DMA_REG_IDLE;
+	TestRegDma0.CINT = DMA_REG_IDLE;
+
+	WaveInit(); // starts the output on the first half, sine filled
+	TestSync();
+	TestFill(0u); // replace the sine with the counter before the first trigger
+	TestFill(1u);
+
+	rate = TestSampleRate();
+	nsamps = rate*TEST_SECONDS;
+	for(samp = 0u; (samp < nsamps) && (testErrors == 0u); samp++){
+		TestTick();
+		out = TestDacOut();
+		if(started == 0u){
+			if(out == DAC_IDLE_VAL){
+				lead++;
+			}
+			else{
+				started = 1u;
+			}
+		}
+		else{}
+		if(started != 0u){
+			if(out != expect){
+				printf("dacbuf %u: sample %u is 0x%03x, expected 0x%03x\n", WAVE_DACBUF_EN, samp, out, expect);
+				testErrors++;
+			}
+			else{}
+			expect = (expect + 1u) & TEST_SEQ_MASK;
+		}
+		else{}
+		if(testFillDue != 0u){
+			testFillDue--;
+			if(testFillDue == 0u){
+				TestFill(testFillHalf);
+			}
+			else{}
+		}
+		else{}
+	}
+
+	printf("dacbuf %u: %u samples/s, %u startup samples at the idle level\n", WAVE_DACBUF_EN, rate, lead);
+	printf("dacbuf %u: %u DMA requests/s of %u bytes, %u half buffer ISR posts/s\n", WAVE_DACBUF_EN,
+		testDmaRequests/TEST_SECONDS, testDmaBytes/(testDmaRequests ? testDmaRequests : 1u),
+		testIsrPosts/TEST_SECONDS);
+	if(rate != SAMPLE_FREQ){
+		printf("dacbuf %u: sample clock is %u Hz, expected %u\n", WAVE_DACBUF_EN, rate, SAMPLE_FREQ);
+		testErrors++;
+	}
+	else{}
+	if(lead != TEST_STARTUP_SAMPS){
+		printf("dacbuf %u: expected %u startup samples\n", WAVE_DACBUF_EN, TEST_STARTUP_SAMPS);
+		testErrors++;
+	}
+	else{}
+	if(waveWakeStats.overruns != 0u){
+		printf("dacbuf %u: %u ISR posts overran the fill\n", WAVE_DACBUF_EN, waveWakeStats.overruns);
+		testErrors++;
+	}
+	else{}
+	TestBurst();
+	if(testErrors != 0u){
+		printf("dacbuf %u: FAILED\n", WAVE_DACBUF_EN);
+		status = 1;
+	}
+	else{
+		printf("dacbuf %u: ok\n", WAVE_DACBUF_EN);
+	}
+	return(status);
+}
+
+/*****************************************************************************
+ * TestFill() - The WaveTask stand-in, next counter values into one half.
+ ******************************************************************************/
+static void TestFill(OS_MSG_SIZE half){
+	INT32U k;
+
+	for(k = 0u; k < (BUF_SIZE/2u); k++){
+		waveOutputBuffer[((BUF_SIZE/2u)*half) + k] = (INT16U)testSeq;
+		testSeq = (testSeq + 1u) & TEST_SEQ_MASK;
+	}
+}
+
+/*****************************************************************************
+ * TestSync() - Apply the firmware's writes to the write-only DMA registers
+ * 				and the PDB software trigger.
+ ******************************************************************************/
+static void TestSync(void){
+	if(TestRegDma0.CERQ != DMA_REG_IDLE){ // the firmware clears a request before it sets one
+		TestRegDma0.ERQ &= ~(1u << TestRegDma0.CERQ);
+		TestRegDma0.CERQ = DMA_REG_IDLE;
+	}
+	else{}
+	if(TestRegDma0.SERQ != DMA_REG_IDLE){
+		TestRegDma0.ERQ |= (1u << TestRegDma0.SERQ);
+		TestRegDma0.SERQ = DMA_REG_IDLE;
+	}
+	else{}
+	if(TestRegDma0.CDNE != DMA_REG_IDLE){
+		TestRegDma0.TCD[TestRegDma0.CDNE].CSR &= (uint16_t)~DMA_CSR_DONE_MASK;
+		TestRegDma0.CDNE = DMA_REG_IDLE;
+	}
+	else{}
+	if(TestRegDma0.CINT != DMA_REG_IDLE){
+		TestRegDma0.INT &= ~(1u << TestRegDma0.CINT);
+		TestRegDma0.CINT = DMA_REG_IDLE;
+	}
+	else{}
+	if((TestRegPdb0.SC & PDB_SC_PDBEN_MASK) == 0u){
+		testPdbRunning = 0u;
+	}
+	else if((TestRegPdb0.SC & PDB_SC_SWTRIG_MASK) != 0u){
+		testPdbRunning = 1u;
+		TestRegPdb0.SC &= ~PDB_SC_SWTRIG_MASK; // self clearing
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TestTick() - One sample period: each running PIT triggers its DMA channel, the PDB0
+ * 				DAC interval trigger steps the DAC buffer.
+ ******************************************************************************/
+static void TestTick(void){
+	INT32U ch;
+
+	testNow += TEST_BUS_FREQ/SAMPLE_FREQ;
+	if((TestRegPit.MCR & PIT_MCR_MDIS(1)) == 0u){
+		for(ch = 0u; ch < TEST_PIT_TRIG_CHS; ch++){
+			if(((TestRegPit.CHANNEL[ch].TCTRL & PIT_TCTRL_TEN_MASK) != 0u) &&
+				((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_ENBL_MASK) != 0u) &&
+				((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_TRIG_MASK) != 0u) &&
+				((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_SOURCE_MASK) == TEST_SRC_ALWAYS_ON)){
+				TestDmaRequest(ch);
+			}
+			else{}
+		}
+	}
+	else{}
+	if((testPdbRunning != 0u) && ((TestRegPdb0.SC & PDB_SC_CONT_MASK) != 0u) &&
+		((TestRegPdb0.DAC[0].INTC & PDB_INTC_TOE_MASK) != 0u)){
+		TestDacTrigger();
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TestDacTrigger() - A hardware trigger of DAC0.  With the buffer on, steps
+ * 					  the read pointer in normal mode, sets the pointer flags
+ * 					  and raises a DMA request for the enabled ones.  The DMA
+ * 					  acknowledge clears the flags.
+ ******************************************************************************/
+static void TestDacTrigger(void){
+	INT32U rp;
+	INT32U up;
+	INT32U wm;
+	INT32U reqflags;
+	INT32U ch;
+
+	if(((TestRegDac0.C0 & DAC_C0_DACEN_MASK) != 0u) && ((TestRegDac0.C0 & DAC_C0_DACTRGSEL_MASK) == 0u) &&
+		((TestRegDac0.C1 & DAC_C1_DACBFEN_MASK) != 0u)){
+		if((TestRegDac0.C1 & DAC_C1_DACBFMD_MASK) != 0u){
+			printf("dacbuf %u: model only has the normal buffer mode\n", WAVE_DACBUF_EN);
+			testErrors++;
+		}
+		else{}
+		rp = (TestRegDac0.C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+		up = TestRegDac0.C2 & DAC_C2_DACBFUP_MASK;
+		wm = (TestRegDac0.C1 & DAC_C1_DACBFWM_MASK) >> DAC_C1_DACBFWM_SHIFT;
+		rp = (rp >= up) ? 0u : (rp + 1u);
+		TestRegDac0.C2 = (INT8U)((TestRegDac0.C2 & DAC_C2_DACBFUP_MASK) | (rp << DAC_C2_DACBFRP_SHIFT));
+		if(rp == 0u){
+			TestRegDac0.SR |= DAC_SR_DACBFRPTF_MASK;
+		}
+		else{}
+		if(rp == up){
+			TestRegDac0.SR |= DAC_SR_DACBFRPBF_MASK;
+		}
+		else{}
+		if(rp == (up - (wm + 1u))){ // 1 to 4 words from the upper limit
+			TestRegDac0.SR |= DAC_SR_DACBFWMF_MASK;
+		}
+		else{}
+		reqflags = 0u;
+		if((TestRegDac0.C0 & DAC_C0_DACBWIEN_MASK) != 0u){
+			reqflags |= DAC_SR_DACBFWMF_MASK;
+		}
+		else{}
+		if((TestRegDac0.C0 & DAC_C0_DACBTIEN_MASK) != 0u){
+			reqflags |= DAC_SR_DACBFRPTF_MASK;
+		}
+		else{}
+		if((TestRegDac0.C0 & DAC_C0_DACBBIEN_MASK) != 0u){
+			reqflags |= DAC_SR_DACBFRPBF_MASK;
+		}
+		else{}
+		if(((TestRegDac0.C1 & DAC_C1_DMAEN_MASK) != 0u) && ((TestRegDac0.SR & reqflags) != 0u)){
+			for(ch = 0u; ch < TEST_DMA_CHS; ch++){
+				if(((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_ENBL_MASK) != 0u) &&
+					((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_SOURCE_MASK) == TEST_SRC_DAC0)){
+					TestDmaRequest(ch);
+				}
+				else{}
+			}
+			TestRegDac0.SR = 0u;
+		}
+		else{}
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TestDmaRequest() - A peripheral request on a DMA channel, served when the
+ * 					  channel's request is enabled.
+ ******************************************************************************/
+static void TestDmaRequest(INT32U ch){
+	if((TestRegDma0.ERQ & (1u << ch)) != 0u){
+		testDmaRequests++;
+		TestDmaMinor(ch);
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TestDmaMinor() - One minor loop of a TCD, then the major loop bookkeeping
+ * 					and interrupts.  Sources must lie in the ping-pong buffer
+ * 					and destinations in the DAC data registers.
+ ******************************************************************************/
+static void TestDmaMinor(INT32U ch){
+	DMA_TCD_Type *tcd = &TestRegDma0.TCD[ch];
+	INT32U ssize = 1u << ((tcd->ATTR >> 8u) & 0x7u);
+	INT32U dsize = 1u << (tcd->ATTR & 0x7u);
+	INT32U smod = (tcd->ATTR >> 11u) & 0x1fu;
+	INT32U dmod = (tcd->ATTR & DMA_ATTR_DMOD_MASK) >> DMA_ATTR_DMOD_SHIFT;
+	INT32U nbytes = tcd->NBYTES_MLNO;
+	INT32U n;
+	INT32U citer;
+	INT32U biter;
+	INT32U irq = 0u;
+
+	if(ssize != dsize){
+		printf("dacbuf %u: model only moves equal source and destination sizes\n", WAVE_DACBUF_EN);
+		testErrors++;
+	}
+	else{
+		for(n = 0u; (n < nbytes) && (testErrors == 0u); n += ssize){
+			TestCheckAddr(tcd->SADDR, ssize, waveOutputBuffer, sizeof(waveOutputBuffer), "source");
+			TestCheckAddr(tcd->DADDR, dsize, (const void *)TestRegDac0.DAT, sizeof(TestRegDac0.DAT),
+				"destination");
+			if(testErrors == 0u){
+				memcpy((void *)(uintptr_t)tcd->DADDR, (const void *)(uintptr_t)tcd->SADDR, ssize);
+			}
+			else{}
+			tcd->SADDR = TestModAdd(tcd->SADDR, (INT16S)tcd->SOFF, smod);
+			tcd->DADDR = TestModAdd(tcd->DADDR, (INT16S)tcd->DOFF, dmod);
+		}
+		testDmaBytes += nbytes;
+		citer = (tcd->CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK) - 1u;
+		biter = tcd->BITER_ELINKNO & DMA_BITER_ELINKNO_BITER_MASK;
+		if(citer == 0u){
+			tcd->SADDR += tcd->SLAST;
+			tcd->DADDR += tcd->DLAST_SGA;
+			tcd->CITER_ELINKNO = (INT16U)((tcd->CITER_ELINKNO & ~DMA_CITER_ELINKNO_CITER_MASK) | biter);
+			irq = tcd->CSR & DMA_CSR_INTMAJOR_MASK;
+			if((tcd->CSR & DMA_CSR_DREQ_MASK) != 0u){
+				TestRegDma0.ERQ &= ~(1u << ch);
+			}
+			else{}
+		}
+		else{
+			tcd->CITER_ELINKNO = (INT16U)((tcd->CITER_ELINKNO & ~DMA_CITER_ELINKNO_CITER_MASK) | citer);
+			if(citer == (biter/2u)){
+				irq = tcd->CSR & DMA_CSR_INTHALF_MASK;
+			}
+			else{}
+		}
+		if(irq != 0u){
+			TestRegDma0.INT |= (1u << ch);
+			if((testIrqEnabled & (1u << (ch % TEST_DMA_VECTORS))) != 0u){
+				testDmaVectors[ch % TEST_DMA_VECTORS]();
+				TestSync();
+				if((TestRegDma0.INT & (1u << ch)) != 0u){
+					printf("dacbuf %u: DMA%u interrupt left its flag set\n", WAVE_DACBUF_EN, ch);
+					testErrors++;
+				}
+				else{}
+			}
+			else{}
+		}
+		else{}
+	}
+}
+
+/*****************************************************************************
+ * TestModAdd() - Address plus offset with the TCD modulo, the low mod bits
+ * 				  wrap and the rest of the address holds.
+ ******************************************************************************/
+static INT32U TestModAdd(INT32U addr, INT32S off, INT32U mod){
+	INT32U mask;
+	INT32U next = addr + (INT32U)off;
+
+	if(mod != 0u){
+		mask = (1u << mod) - 1u;
+		next = (addr & ~mask) | (next & mask);
+	}
+	else{}
+	return(next);
+}
+
+/*****************************************************************************
+ * TestCheckAddr() - Fail an access outside the memory it must stay in.
+ ******************************************************************************/
+static void TestCheckAddr(INT32U addr, INT32U size, const void *base, INT32U len, const char *what){
+	INT32U start = (INT32U)(uintptr_t)base;
+
+	if((addr < start) || ((addr + size) > (start + len))){
+		printf("dacbuf %u: DMA %s 0x%08x is outside its block\n", WAVE_DACBUF_EN, what, addr);
+		testErrors++;
+	}
+	else{}
+}
+
+/*****************************************************************************
+ * TestDacOut() - The code DAC0 is converting, the word at the read pointer
+ * 				  with the buffer on, else DAT[0].
+ ******************************************************************************/
+static INT32U TestDacOut(void){
+	INT32U word = 0u;
+
+	if((TestRegDac0.C1 & DAC_C1_DACBFEN_MASK) != 0u){
+		word = (TestRegDac0.C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+	}
+	else{}
+	return((((INT32U)TestRegDac0.DAT[word].DATH << 8u) | TestRegDac0.DAT[word].DATL) & DAC_MASK);
+}
+
+/*****************************************************************************
+ * TestSampleRate() - Sample clock programmed by the firmware, the running PIT
+ * 					  that triggers its DMA channel or the PDB0 DAC interval,
+ * 					  in Hz.
+ ******************************************************************************/
+static INT32U TestSampleRate(void){
+	INT32U rate = 0u;
+	INT32U ch;
+
+	if(testPdbRunning != 0u){
+		rate = TEST_BUS_FREQ/(TestRegPdb0.DAC[0].INT + 1u);
+	}
+	else{
+		for(ch = 0u; (ch < TEST_PIT_TRIG_CHS) && (rate == 0u); ch++){
+			if(((TestRegPit.CHANNEL[ch].TCTRL & PIT_TCTRL_TEN_MASK) != 0u) &&
+				((TestRegDmamux.CHCFG[ch] & DMAMUX_CHCFG_TRIG_MASK) != 0u)){
+				rate = TEST_BUS_FREQ/(TestRegPit.CHANNEL[ch].LDVAL + 1u);
+			}
+			else{}
+		}
+	}
+	return(rate);
+}
+
+/*****************************************************************************
+ * TestBurst() - Burst mode on its own channels.  Arms a burst, plays the DMA
+ * 				 side of an SW2 edge (trigger channel DONE, burst PIT on), and
+ * 				 checks a re-arm is refused and leaves the table and TCDs as
+ * 				 they were until the end interrupt, then is taken.
+ ******************************************************************************/
+static void TestBurst(void){
+	DMA_TCD_Type outtcd;
+	INT16U samps;
+	INT8U result;
+
+	waveParams.freq = TEST_BURST_FREQ;
+	result = WaveBurstArm(2u);
+	TestSync();
+	samps = waveBurstSamps;
+	if((result != WAVE_BURST_ARMED) || (waveBurstOut.dmach == waveOutCh)
+#if !WAVE_DACBUF_EN
+		|| (waveBurstOut.pit == waveOutPit.pit)
+#endif
+		){
+		printf("dacbuf %u: burst not armed on its own channel\n", WAVE_DACBUF_EN);
+		testErrors++;
+	}
+	else{}
+
+	TestRegDma0.TCD[waveBurstTrigCh].CSR |= DMA_CSR_DONE_MASK; // SW2 edge stamped
+	TestRegPit.CHANNEL[waveBurstOut.pit].TCTRL = waveBurstPitStart; // linked start
+	memcpy(&outtcd, (const void *)&TestRegDma0.TCD[waveBurstOut.dmach], sizeof(outtcd));
+	result = WaveBurstArm(3u);
+	TestSync();
+	if((result != WAVE_BURST_BUSY) || (waveBurstSamps != samps) ||
+		(memcmp(&outtcd, (const void *)&TestRegDma0.TCD[waveBurstOut.dmach], sizeof(outtcd)) != 0) ||
+		((TestRegDma0.ERQ & (1u << waveBurstTrigCh)) == 0u)){
+		printf("dacbuf %u: re-arm during a burst was not refused cleanly\n", WAVE_DACBUF_EN);
+		testErrors++;
+	}
+	else{}
+
+	TestRegDma0.INT |= (1u << waveBurstEndCh); // last sample stamped
+	if((testIrqEnabled & (1u << (waveBurstEndCh % TEST_DMA_VECTORS))) != 0u){
+		testDmaVectors[waveBurstEndCh % TEST_DMA_VECTORS]();
+	}
+	else{}
+	TestSync();
+	result = WaveBurstArm(3u);
+	TestSync();
+	if((result != WAVE_BURST_ARMED) || (waveBurstSamps == samps) || (waveBurstStats.count != 1u)){
+		printf("dacbuf %u: re-arm after the burst ended was not taken\n", WAVE_DACBUF_EN);
+		testErrors++;
+	}
+	else{}
+	WaveBurstDisarm();
+	TestSync();
+}
+
+//KERNEL AND LIBRARY STAND-INS///////////////////////////////////////////////////////////
+CPU_TS OS_TS_GET(void){
+	return(testNow);
+}
+
+void OSIntEnter(void){
+}
+
+void OSIntExit(void){
+}
+
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err){
+	(void)p_name;
+	p_mutex->owned = 0u;
+	*p_err = OS_ERR_NONE;
+}
+
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err){
+	(void)timeout;
+	(void)opt;
+	(void)p_ts;
+	p_mutex->owned = 1u;
+	*p_err = OS_ERR_NONE;
+}
+
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err){
+	(void)opt;
+	p_mutex->owned = 0u;
+	*p_err = OS_ERR_NONE;
+}
+
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg, OS_PRIO prio,
+	CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size, OS_MSG_QTY q_size,
+	OS_TICK time_quanta, void *p_ext, OS_OPT opt, OS_ERR *p_err){
+	(void)p_name;
+	(void)p_task; // TestFill() stands in for WaveTask
+	(void)p_arg;
+	(void)prio;
+	(void)p_stk_base;
+	(void)stk_limit;
+	(void)stk_size;
+	(void)q_size;
+	(void)time_quanta;
+	(void)p_ext;
+	(void)opt;
+	p_tcb->created = 1u;
+	*p_err = OS_ERR_NONE;
+}
+
+void *OSTaskQPend(OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err){
+	(void)timeout;
+	(void)opt;
+	*p_msg_size = 0u;
+	*p_ts = testNow;
+	*p_err = OS_ERR_NONE;
+	return((void *)0);
+}
+
+/*****************************************************************************
+ * OSTaskQPost() - Queue the posted half for TestFill() TEST_FILL_DELAY
+ * 				   samples later.  A post while one is pending overruns.
+ ******************************************************************************/
+void OSTaskQPost(OS_TCB *p_tcb, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err){
+	(void)p_void;
+	(void)opt;
+	testIsrPosts++;
+	if((p_tcb->created == 0u) || (testFillDue != 0u)){
+		*p_err = OS_ERR_Q_MAX;
+	}
+	else{
+		testFillHalf = msg_size;
+		testFillDue = TEST_FILL_DELAY;
+		*p_err = OS_ERR_NONE;
+	}
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq){
+	testIrqEnabled |= (1u << irq);
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq){
+	testIrqEnabled &= ~(1u << irq);
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq){
+	(void)irq;
+}
+
+void __disable_irq(void){
+}
+
+/*****************************************************************************
+ * __WFI() - Only reached from ResFail()'s halt, which must not happen here.
+ ******************************************************************************/
+void __WFI(void){
+	printf("\ndacbuf %u: FAILED, halted\n", WAVE_DACBUF_EN);
+	exit(1);
+}
+
+void BIOPutStrg(const INT8C *strg){
+	fputs(strg, stdout);
+}
+
+void BIOOutDecWord(INT32U binword, INT8U field){
+	(void)field;
+	printf("%u", binword);
+}
+
+void GpioSw2Init(INT8U irqc){
+	(void)irqc;
+}
+
+q31_t arm_sin_q31(q31_t x){
+	(void)x;
+	return(0);
+}
+
+arm_status arm_fir_interpolate_init_q15(arm_fir_interpolate_instance_q15 *S, uint8_t L, uint16_t numTaps,
+	const q15_t *pCoeffs, q15_t *pState, uint32_t blockSize){
+	S->L = L;
+	S->phaseLength = (uint16_t)(numTaps/L);
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	(void)blockSize;
+	return(ARM_MATH_SUCCESS);
+}
+
+void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15 *S, const q15_t *pSrc, q15_t *pDst,
+	uint32_t blockSize){
+	(void)S;
+	(void)pSrc;
+	(void)pDst;
+	(void)blockSize;
+}
+////////////////////////////////////////////////////////////////////////////////////////
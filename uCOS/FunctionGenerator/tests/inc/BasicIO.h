@@ -0,0 +1,15 @@
+/*******************************************************************************
+* BasicIO.h - Host stand-in for the BasicIO serial module, for ResAlloc's
+* 			  report and failure message.  DacBufTest.c prints them on stdout.
+*
+*******************************************************************************/
+
+#ifndef BASICIO_H_
+#define BASICIO_H_
+
+#define BIO_BIT_RATE_9600 9600u
+
+void BIOPutStrg(const INT8C *strg);
+void BIOOutDecWord(INT32U binword, INT8U field);
+
+#endif /* BASICIO_H_ */
@@ -0,0 +1,15 @@
+/*******************************************************************************
+* K65TWR_GPIO.h - Host stand-in for the K65TWR GPIO header.  The debug bits
+* 				  compile away.
+*
+*******************************************************************************/
+
+#ifndef K65TWR_GPIO_H_
+#define K65TWR_GPIO_H_
+
+#define DB0_TURN_ON() ((void)0)
+#define DB0_TURN_OFF() ((void)0)
+
+void GpioSw2Init(INT8U irqc);
+
+#endif /* K65TWR_GPIO_H_ */
@@ -0,0 +1,10 @@
+/*******************************************************************************
+* LcdLayered.h - Host stand-in for the layered LCD driver header, unused by
+* 				 the output path.
+*
+*******************************************************************************/
+
+#ifndef LCDLAYERED_H_
+#define LCDLAYERED_H_
+
+#endif /* LCDLAYERED_H_ */
@@ -0,0 +1,31 @@
+/*******************************************************************************
+* MCUType.h - Host stand-in for the K65 project types header.  Same guard as
+* 			  ../MCUType.h so, included first, it replaces that one: the
+* 			  same type names with the target widths on an LP64 host.
+*
+*******************************************************************************/
+
+#ifndef MCU_TYPE_PRESENT
+#define MCU_TYPE_PRESENT
+
+#include <stdint.h>
+#include "MK65F18.h"
+#include "cpu.h"
+#include "arm_math.h"
+
+typedef char INT8C;
+typedef unsigned char INT8U;
+typedef signed char INT8S;
+typedef unsigned short INT16U;
+typedef signed short INT16S;
+typedef unsigned int INT32U;
+typedef signed int INT32S;
+typedef unsigned long long INT64U;
+typedef signed long long INT64S;
+typedef float FP32;
+typedef double FP64;
+
+#define FALSE 0
+#define TRUE 1
+
+#endif /* MCU_TYPE_PRESENT */
@@ -0,0 +1,235 @@
+/*******************************************************************************
+* MK65F18.h - Host stand-in for the NXP K65 device header, for the output path
+* 			  register model in DacBufTest.c.  Register blocks keep the NXP
+* 			  names and field macros but are plain storage; the model reads
+* 			  what WaveModule wrote and plays the DMA, DAC, PDB and PIT
+* 			  behaviour between firmware calls.
+*
+* 			  The write-only DMA SERQ, CERQ, CDNE and CINT registers hold
+* 			  DMA_REG_IDLE until the firmware writes them, the model then
+* 			  applies the write and sets them back.
+*
+* 			  DMA addresses are 32 bit registers.  The test links without
+* 			  PIE so every static buffer and register block sits below 4 GB
+* 			  and the address fields hold host pointers.
+*
+*******************************************************************************/
+
+#ifndef MK65F18_H_
+#define MK65F18_H_
+
+#include <stdint.h>
+
+#define __IO volatile
+#define __I volatile const
+#define __O volatile
+
+//INTERRUPT NUMBERS//////////////////////////////////////////////////////////////////////
+typedef enum{
+	DMA0_DMA16_IRQn = 0, DMA1_DMA17_IRQn, DMA2_DMA18_IRQn, DMA3_DMA19_IRQn,
+	DMA4_DMA20_IRQn, DMA5_DMA21_IRQn, DMA6_DMA22_IRQn, DMA7_DMA23_IRQn,
+	DMA8_DMA24_IRQn, DMA9_DMA25_IRQn, DMA10_DMA26_IRQn, DMA11_DMA27_IRQn,
+	DMA12_DMA28_IRQn, DMA13_DMA29_IRQn, DMA14_DMA30_IRQn, DMA15_DMA31_IRQn
+}IRQn_Type;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//REGISTER BLOCKS///////////////////////////////////////////////////////////////////////
+typedef struct{
+	__IO uint32_t SOPT1, SOPT2, SOPT4, SOPT5, SOPT7, SDID;
+	__IO uint32_t SCGC1, SCGC2, SCGC3, SCGC4, SCGC5, SCGC6, SCGC7;
+}SIM_Type;
+
+typedef struct{
+	struct{
+		__IO uint8_t DATL;
+		__IO uint8_t DATH;
+	}DAT[16];
+	__IO uint8_t SR, C0, C1, C2;
+}DAC_Type;
+
+typedef struct{
+	__IO uint32_t SC, MOD, CNT, IDLY;
+	struct{
+		__IO uint32_t INTC, INT;
+	}DAC[2];
+}PDB_Type;
+
+typedef struct{ //one TCD, 32 bytes as in the engine
+	__IO uint32_t SADDR;
+	__IO uint16_t SOFF;
+	__IO uint16_t ATTR;
+	__IO uint32_t NBYTES_MLNO;
+	__IO uint32_t SLAST;
+	__IO uint32_t DADDR;
+	__IO uint16_t DOFF;
+	union{
+		__IO uint16_t CITER_ELINKNO;
+		__IO uint16_t CITER_ELINKYES;
+	};
+	__IO uint32_t DLAST_SGA;
+	__IO uint16_t CSR;
+	union{
+		__IO uint16_t BITER_ELINKNO;
+		__IO uint16_t BITER_ELINKYES;
+	};
+}DMA_TCD_Type;
+
+typedef struct{
+	__IO uint32_t CR, ES, ERQ, EEI;
+	__O uint8_t CEEI, SEEI, CERQ, SERQ, CDNE, SSRT, CERR, CINT;
+	__IO uint32_t INT, ERR, HRS;
+	DMA_TCD_Type TCD[32];
+}DMA_Type;
+
+typedef struct{
+	__IO uint8_t CHCFG[32];
+}DMAMUX_Type;
+
+typedef struct{
+	__IO uint32_t MCR, LTMR64H, LTMR64L;
+	struct{
+		__IO uint32_t LDVAL, CVAL, TCTRL, TFLG;
+	}CHANNEL[4];
+}PIT_Type;
+////////////////////////////////////////////////////////////////////////////////////////
+
+//PERIPHERALS////////////////////////////////////////////////////////////////////////////
+extern SIM_Type TestRegSim;
+extern DAC_Type TestRegDac0;
+extern PDB_Type TestRegPdb0;
+extern DMA_Type TestRegDma0;
+extern DMAMUX_Type TestRegDmamux;
+extern PIT_Type TestRegPit;
+
+#define SIM (&TestRegSim)
+#define DAC0 (&TestRegDac0)
+#define PDB0 (&TestRegPdb0)
+#define DMA0 (&TestRegDma0)
+#define DMAMUX (&TestRegDmamux)
+#define PIT (&TestRegPit)
+
+#define DMA_REG_IDLE 0xffu
+////////////////////////////////////////////////////////////////////////////////////////
+
+//CORE///////////////////////////////////////////////////////////////////////////////////
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+void __disable_irq(void);
+void __WFI(void);
+////////////////////////////////////////////////////////////////////////////////////////
+
+//FIELDS/////////////////////////////////////////////////////////////////////////////////
+#define SIM_SCGC2_DAC0(x) (((uint32_t)(x) << 12u) & 0x1000u)
+#define SIM_SCGC6_DMAMUX_MASK 0x2u
+#define SIM_SCGC6_DMAMUX(x) (((uint32_t)(x) << 1u) & 0x2u)
+#define SIM_SCGC6_PDB(x) (((uint32_t)(x) << 22u) & 0x400000u)
+#define SIM_SCGC6_PIT(x) (((uint32_t)(x) << 23u) & 0x800000u)
+#define SIM_SCGC6_DAC0(x) (((uint32_t)(x) << 31u) & 0x80000000u)
+#define SIM_SCGC7_DMA_MASK 0x2u
+#define SIM_SCGC7_DMA(x) (((uint32_t)(x) << 1u) & 0x2u)
+
+#define DAC_SR_DACBFRPBF_MASK 0x1u
+#define DAC_SR_DACBFRPTF_MASK 0x2u
+#define DAC_SR_DACBFWMF_MASK 0x4u
+#define DAC_C0_DACBBIEN_MASK 0x1u
+#define DAC_C0_DACBTIEN_MASK 0x2u
+#define DAC_C0_DACBWIEN_MASK 0x4u
+#define DAC_C0_DACSWTRG_MASK 0x10u
+#define DAC_C0_DACTRGSEL_MASK 0x20u
+#define DAC_C0_DACEN_MASK 0x80u
+#define DAC_C0_DACBBIEN(x) (((uint8_t)(x) << 0u) & 0x1u)
+#define DAC_C0_DACBTIEN(x) (((uint8_t)(x) << 1u) & 0x2u)
+#define DAC_C0_DACBWIEN(x) (((uint8_t)(x) << 2u) & 0x4u)
+#define DAC_C0_DACSWTRG(x) (((uint8_t)(x) << 4u) & 0x10u)
+#define DAC_C0_DACTRGSEL(x) (((uint8_t)(x) << 5u) & 0x20u)
+#define DAC_C0_DACRFS(x) (((uint8_t)(x) << 6u) & 0x40u)
+#define DAC_C0_DACEN(x) (((uint8_t)(x) << 7u) & 0x80u)
+#define DAC_C1_DACBFEN_MASK 0x1u
+#define DAC_C1_DACBFMD_MASK 0x6u
+#define DAC_C1_DACBFMD_SHIFT 1u
+#define DAC_C1_DACBFWM_MASK 0x18u
+#define DAC_C1_DACBFWM_SHIFT 3u
+#define DAC_C1_DMAEN_MASK 0x80u
+#define DAC_C1_DACBFEN(x) (((uint8_t)(x) << 0u) & 0x1u)
+#define DAC_C1_DACBFMD(x) (((uint8_t)(x) << 1u) & 0x6u)
+#define DAC_C1_DACBFWM(x) (((uint8_t)(x) << 3u) & 0x18u)
+#define DAC_C1_DMAEN(x) (((uint8_t)(x) << 7u) & 0x80u)
+#define DAC_C2_DACBFUP_MASK 0xfu
+#define DAC_C2_DACBFRP_MASK 0xf0u
+#define DAC_C2_DACBFRP_SHIFT 4u
+#define DAC_C2_DACBFUP(x) (((uint8_t)(x) << 0u) & 0xfu)
+#define DAC_C2_DACBFRP(x) (((uint8_t)(x) << 4u) & 0xf0u)
+
+#define PDB_SC_CONT_MASK 0x2u
+#define PDB_SC_PDBEN_MASK 0x80u
+#define PDB_SC_SWTRIG_MASK 0x10000u
+#define PDB_SC_LDOK(x) (((uint32_t)(x) << 0u) & 0x1u)
+#define PDB_SC_CONT(x) (((uint32_t)(x) << 1u) & 0x2u)
+#define PDB_SC_PDBEN(x) (((uint32_t)(x) << 7u) & 0x80u)
+#define PDB_SC_TRGSEL(x) (((uint32_t)(x) << 8u) & 0xf00u)
+#define PDB_SC_SWTRIG(x) (((uint32_t)(x) << 16u) & 0x10000u)
+#define PDB_MOD_MOD(x) (((uint32_t)(x) << 0u) & 0xffffu)
+#define PDB_INT_INT(x) (((uint32_t)(x) << 0u) & 0xffffu)
+#define PDB_INTC_TOE_MASK 0x1u
+#define PDB_INTC_TOE(x) (((uint32_t)(x) << 0u) & 0x1u)
+
+#define PIT_MCR_MDIS(x) (((uint32_t)(x) << 1u) & 0x2u)
+#define PIT_TCTRL_TEN_MASK 0x1u
+#define PIT_TCTRL_TEN(x) (((uint32_t)(x) << 0u) & 0x1u)
+#define PIT_TCTRL_TIE(x) (((uint32_t)(x) << 1u) & 0x2u)
+
+#define DMAMUX_CHCFG_SOURCE_MASK 0x3fu
+#define DMAMUX_CHCFG_TRIG_MASK 0x40u
+#define DMAMUX_CHCFG_ENBL_MASK 0x80u
+#define DMAMUX_CHCFG_SOURCE(x) (((uint8_t)(x) << 0u) & 0x3fu)
+#define DMAMUX_CHCFG_TRIG(x) (((uint8_t)(x) << 6u) & 0x40u)
+#define DMAMUX_CHCFG_ENBL(x) (((uint8_t)(x) << 7u) & 0x80u)
+
+#define DMA_SERQ_SERQ(x) (((uint8_t)(x) << 0u) & 0x1fu)
+#define DMA_CERQ_CERQ(x) (((uint8_t)(x) << 0u) & 0x1fu)
+#define DMA_CDNE_CDNE(x) (((uint8_t)(x) << 0u) & 0x1fu)
+#define DMA_CINT_CINT(x) (((uint8_t)(x) << 0u) & 0x1fu)
+#define DMA_SADDR_SADDR(x) ((uint32_t)(uintptr_t)(x))
+#define DMA_DADDR_DADDR(x) ((uint32_t)(uintptr_t)(x))
+#define DMA_SOFF_SOFF(x) ((uint16_t)(x))
+#define DMA_DOFF_DOFF(x) ((uint16_t)(x))
+#define DMA_SLAST_SLAST(x) ((uint32_t)(x))
+#define DMA_DLAST_SGA_DLASTSGA(x) ((uint32_t)(x))
+#define DMA_NBYTES_MLNO_NBYTES(x) ((uint32_t)(x))
+#define DMA_ATTR_DSIZE(x) (((uint16_t)(x) << 0u) & 0x7u)
+#define DMA_ATTR_DMOD_MASK 0xf8u
+#define DMA_ATTR_DMOD_SHIFT 3u
+#define DMA_ATTR_DMOD(x) (((uint16_t)(x) << 3u) & 0xf8u)
+#define DMA_ATTR_SSIZE(x) (((uint16_t)(x) << 8u) & 0x700u)
+#define DMA_ATTR_SMOD(x) (((uint16_t)(x) << 11u) & 0xf800u)
+#define DMA_CITER_ELINKNO_CITER_MASK 0x7fffu
+#define DMA_CITER_ELINKNO_CITER(x) (((uint16_t)(x) << 0u) & 0x7fffu)
+#define DMA_CITER_ELINKNO_ELINK(x) (((uint16_t)(x) << 15u) & 0x8000u)
+#define DMA_BITER_ELINKNO_BITER_MASK 0x7fffu
+#define DMA_BITER_ELINKNO_BITER(x) (((uint16_t)(x) << 0u) & 0x7fffu)
+#define DMA_BITER_ELINKNO_ELINK(x) (((uint16_t)(x) << 15u) & 0x8000u)
+#define DMA_CITER_ELINKYES_CITER(x) (((uint16_t)(x) << 0u) & 0x1ffu)
+#define DMA_CITER_ELINKYES_LINKCH(x) (((uint16_t)(x) << 9u) & 0x3e00u)
+#define DMA_CITER_ELINKYES_ELINK(x) (((uint16_t)(x) << 15u) & 0x8000u)
+#define DMA_BITER_ELINKYES_BITER_MASK 0x1ffu
+#define DMA_BITER_ELINKYES_BITER(x) (((uint16_t)(x) << 0u) & 0x1ffu)
+#define DMA_BITER_ELINKYES_LINKCH(x) (((uint16_t)(x) << 9u) & 0x3e00u)
+#define DMA_BITER_ELINKYES_ELINK(x) (((uint16_t)(x) << 15u) & 0x8000u)
+#define DMA_CSR_START(x) (((uint16_t)(x) << 0u) & 0x1u)
+#define DMA_CSR_INTMAJOR_MASK 0x2u
+#define DMA_CSR_INTMAJOR(x) (((uint16_t)(x) << 1u) & 0x2u)
+#define DMA_CSR_INTHALF_MASK 0x4u
+#define DMA_CSR_INTHALF(x) (((uint16_t)(x) << 2u) & 0x4u)
+#define DMA_CSR_DREQ_MASK 0x8u
+#define DMA_CSR_DREQ(x) (((uint16_t)(x) << 3u) & 0x8u)
+#define DMA_CSR_ACTIVE_MASK 0x40u
+#define DMA_CSR_DONE_MASK 0x80u
+#define DMA_CSR_ESG(x) (((uint16_t)(x) << 4u) & 0x10u)
+#define DMA_CSR_MAJORELINK(x) (((uint16_t)(x) << 5u) & 0x20u)
+#define DMA_CSR_MAJORLINKCH_MASK 0x1f00u
+#define DMA_CSR_MAJORLINKCH(x) (((uint16_t)(x) << 8u) & 0x1f00u)
+#define DMA_CSR_BWC(x) (((uint16_t)(x) << 14u) & 0xc000u)
+////////////////////////////////////////////////////////////////////////////////////////
+
+#endif /* MK65F18_H_ */
@@ -0,0 +1,12 @@
+/*******************************************************************************
+* app_cfg.h - Host stand-in for the FunctionGenerator application settings.
+*
+*******************************************************************************/
+
+#ifndef APP_CFG_H_
+#define APP_CFG_H_
+
+#define APP_CFG_WAVE_TASK_PRIO 4u
+#define APP_CFG_WAVE_TASK_STK_SIZE 128u
+
+#endif /* APP_CFG_H_ */
@@ -0,0 +1,34 @@
+/*******************************************************************************
+* arm_math.h - Host stand-in for the CMSIS DSP header.  Only the types and
+* 			   functions WaveModule uses; the test supplies the functions and
+* 			   fills the ping-pong buffer itself.
+*
+*******************************************************************************/
+
+#ifndef ARM_MATH_H_
+#define ARM_MATH_H_
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+typedef enum{
+	ARM_MATH_SUCCESS = 0, ARM_MATH_ARGUMENT_ERROR = -1, ARM_MATH_LENGTH_ERROR = -2
+}arm_status;
+
+typedef struct{
+	uint8_t L;
+	uint16_t phaseLength;
+	const q15_t *pCoeffs;
+	q15_t *pState;
+}arm_fir_interpolate_instance_q15;
+
+q31_t arm_sin_q31(q31_t x);
+arm_status arm_fir_interpolate_init_q15(arm_fir_interpolate_instance_q15 *S, uint8_t L, uint16_t numTaps,
+	const q15_t *pCoeffs, q15_t *pState, uint32_t blockSize);
+void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15 *S, const q15_t *pSrc, q15_t *pDst,
+	uint32_t blockSize);
+
+#endif /* ARM_MATH_H_ */
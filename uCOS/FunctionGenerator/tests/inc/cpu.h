@@ -0,0 +1,22 @@
+/*******************************************************************************
+* cpu.h - Host stand-in for the uC/CPU port header.  Types only, the critical
+* 		  section compiles away since the register model is single threaded.
+*
+*******************************************************************************/
+
+#ifndef CPU_H_
+#define CPU_H_
+
+#include <stdint.h>
+
+typedef char CPU_CHAR;
+typedef uint32_t CPU_STK;
+typedef uint32_t CPU_STK_SIZE;
+typedef uint32_t CPU_TS;
+typedef uint32_t CPU_SR;
+
+#define CPU_SR_ALLOC() CPU_SR cpu_sr = 0u
+#define CPU_CRITICAL_ENTER() ((void)cpu_sr)
+#define CPU_CRITICAL_EXIT() ((void)cpu_sr)
+
+#endif /* CPU_H_ */
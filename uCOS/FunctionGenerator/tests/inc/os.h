@@ -0,0 +1,51 @@
+/*******************************************************************************
+* os.h - Host stand-in for the uC/OS-III kernel header.  Just the services
+* 		 WaveModule calls; DacBufTest.c implements them, with OSTaskQPost()
+* 		 handing the posted half index to the test's fill task.
+*
+*******************************************************************************/
+
+#ifndef OS_H_
+#define OS_H_
+
+#include "cpu.h"
+
+typedef enum{
+	OS_ERR_NONE = 0u, OS_ERR_Q_MAX = 29000u
+}OS_ERR;
+
+typedef uint16_t OS_MSG_QTY;
+typedef uint32_t OS_MSG_SIZE;
+typedef uint16_t OS_OPT;
+typedef uint8_t OS_PRIO;
+typedef uint32_t OS_TICK;
+typedef void (*OS_TASK_PTR)(void *p_arg);
+
+typedef struct{
+	uint32_t created;
+}OS_TCB;
+
+typedef struct{
+	uint32_t owned;
+}OS_MUTEX;
+
+#define OS_OPT_NONE 0x0000u
+#define OS_OPT_PEND_BLOCKING 0x0000u
+#define OS_OPT_POST_FIFO 0x0000u
+#define OS_OPT_POST_NONE 0x0000u
+#define OS_OPT_TASK_STK_CHK 0x0001u
+#define OS_OPT_TASK_STK_CLR 0x0002u
+
+CPU_TS OS_TS_GET(void);
+void OSIntEnter(void);
+void OSIntExit(void);
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err);
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err);
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg, OS_PRIO prio,
+	CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size, OS_MSG_QTY q_size,
+	OS_TICK time_quanta, void *p_ext, OS_OPT opt, OS_ERR *p_err);
+void *OSTaskQPend(OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err);
+void OSTaskQPost(OS_TCB *p_tcb, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err);
+
+#endif /* OS_H_ */
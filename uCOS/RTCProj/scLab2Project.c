@@ -182,21 +182,24 @@ static void AppStartTask(void *p_arg) {
 /*******************************************************************
  * DispTimeTask()
  *
- * This task simply displays the updated time captured by time pend
+ * This task simply displays the updated time captured by time pend.  It subscribes to every
+ * second; a late run shows the latest time rather than catching up.
  *******************************************************************/
 static void DispTimeTask(void *p_arg){
 	OS_ERR os_err;
 
 	TIME_T disptime; //local instance of time struct holding all current time data
 	TIME_T *ltime;
+	TIME_SUB_T timesub; //DispTimeTask's subscription to second changes
 
 	ltime = &disptime;
 
 	(void)p_arg;
+	(void)TimeSubscribe(&timesub, TIME_CHG_SEC);
 
 	while(1){
 
-		TimePend(ltime, &os_err); //pend on change of time.  Pass a pointer to the local instance of TIME_T struct
+		(void)TimePend(&timesub, ltime, &os_err); //pend on change of time.  Pass a pointer to the local instance of TIME_T struct
 
 		DB2_TURN_ON();
 		LcdDispTime(LCD_ROW_1, LCD_COL_9, SEND_B_LAYER, disptime.hr, disptime.min, disptime.sec);
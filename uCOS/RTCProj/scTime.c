@@ -2,9 +2,18 @@
 
 /****************************************************************
  * The time module contains all public resources used to set, get,
- * and pend the current time.  It also contains all initialization
- * for the RTC that is used to post the timeSecFlag, which tells the
- * timeTask to increment the current timeOfDay and post the timeChgFlag
+ * and pend the current time.  The time of day is never counted in
+ * software: it is RTC->TSR, which the RTC increments every second,
+ * plus timeOffset, which TimeSet() writes.  TimeGet() reads the two
+ * under the timeSeq sequence count and converts seconds to hr/min/sec
+ * with reciprocal multiplies, so it takes no lock and never blocks.
+ * Time changes are published on the timeChgFlags event flag group,
+ * one bit per subscriber.  The RTC seconds interrupt counts the
+ * second, minute and hour changes and sets the bits of the
+ * subscribers to each change that happened, so every subscriber is
+ * woken once per change it asked for and never for the others.  A
+ * bit stays set until its subscriber's TimePend() consumes it, and
+ * the counts tell a late subscriber how many changes it missed.
  ****************************************************************/
 
 #include "MCUType.h"
@@ -14,36 +23,52 @@
 #include "MK65F18.h"
 #include "K65TWR_GPIO.h"
 
-static OS_TCB TimeTaskTCB;
-static CPU_STK TimeTaskStk[APP_CFG_TIME_TASK_STK_SIZE];
-
-//MODULE GLOBALS/////////////////////
-TIME_T timeOfDay;
-
-//MUTEX KEY FOR timeOfDay RESOURCE//
-static OS_MUTEX timeMutexKey;
-
-//SEMAPHORS////////
-OS_SEM timeSecFlag;
-OS_SEM timeChgFlag;
+/****************************************************************
+ * Seconds conversion constants.  Each quotient is (x*MULT)>>SHIFT,
+ * checked exact for every x in range:
+ * 		-DAY: any 32 bit count of seconds, 64 bit product
+ * 		-HR: seconds of the day, below 86400
+ * 		-MIN: seconds of the hour, below 3600
+ ****************************************************************/
+#define TIME_SEC_PER_DAY 86400u
+#define TIME_SEC_PER_HR 3600u
+#define TIME_SEC_PER_MIN 60u
+#define TIME_DAY_MULT 0xC22E4507ull
+#define TIME_DAY_SHIFT 48u
+#define TIME_HR_MULT 37283u
+#define TIME_HR_SHIFT 27u
+#define TIME_MIN_MULT 2185u
+#define TIME_MIN_SHIFT 17u
+#define TIME_INIT_SEC (12u*TIME_SEC_PER_HR) //12:00:00 at reset
+
+//TIME OF DAY, RTC->TSR + timeOffset/////
+static volatile INT32U timeOffset; //below TIME_SEC_PER_DAY
+static volatile INT32U timeSeq; //odd while timeOffset is being written
+
+//TIME CHANGE PUBLICATION////////
+static OS_FLAG_GRP timeChgFlags; //one bit per subscriber
+static OS_FLAGS timeSubUsed; //subscriber bits handed out
+static volatile OS_FLAGS timeSubFlags[TIME_NUM_CHG]; //subscriber bits of each granularity
+static volatile INT32U timeChgCount[TIME_NUM_CHG]; //changes of each granularity
 
 //PRIVATE PROTOTYPES////////////////
-static void timeTask(void);
+static INT32U timeSecOfDay(INT32U secs);
+static void timePublish(TIME_CHG_T chg);
 void RTC_Seconds_IRQHandler(void); //irq handler for the rtc interrupt occuring every second
 
 /***********************************************
- * TimeInit() - Initialize mutex, semaphors, and RTC
+ * TimeInit() - Initialize the semaphore and RTC
  *
  ************************************************/
 void TimeInit(void){
 	OS_ERR os_err;
 
-	//CREATE MUTEX//
-	OSMutexCreate(&timeMutexKey, "timeOfDay mutex", &os_err);
+	//CREATE CHANGE FLAG GROUP//
+	OSFlagCreate(&timeChgFlags, "Time Change Flags", (OS_FLAGS)0, &os_err);
 
-	//CREATE SEMAPHORS//
-	OSSemCreate(&timeSecFlag, "Time Second Alert Flag", 0, &os_err);
-	OSSemCreate(&timeChgFlag, "Time Change Flag", 0, &os_err);
+	//INITIALIZE TIME OF DAY, TSR IS CLEARED BELOW//
+	timeSeq = 0u;
+	timeOffset = TIME_INIT_SEC;
 
 	//ENABLE RTC AND TIME SECONDS INTERRUPT////////////////////////////
 	SIM->SCGC6 |= SIM_SCGC6_RTC_MASK; //enable RTC clock and interrupts
@@ -59,130 +84,152 @@ void TimeInit(void){
 	NVIC_EnableIRQ(RTC_Seconds_IRQn);
 	__enable_irq();
 	///////////////////////////////////////////////////////////////////
-
-	//INITIALIZE TIME OF DAY VALUES//
-	timeOfDay.hr = 12u;
-	timeOfDay.min = 0u;
-	timeOfDay.sec = 0u;
-
-	//Create Time Task
-	OSTaskCreate(&TimeTaskTCB,
-			     "Time Task",
-				 timeTask,
-				 (void *) 0,
-				 APP_CFG_TIME_TASK_PRIO,
-				 &TimeTaskStk[0],
-				 (APP_CFG_TIME_TASK_STK_SIZE/10u),
-				 APP_CFG_TIME_TASK_STK_SIZE,
-				 0u,
-				 0u,
-				 (void *) 0,
-				 (OS_OPT_TASK_NONE),
-				 &os_err
-				 );
 }
 
-/***********************************************************************************
- * TimeTask() - Pend on timeSecFlag and increment timeOfDay structure every second
- *
- ************************************************************************************/
-static void timeTask(void){
-
-	OS_ERR os_err;
-
-	while(1){
-
-		DB3_TURN_OFF();
-		//Pend on semaphore that will be posted by the RTC Seconds IRQ Handler
-		(void)OSSemPend(&timeSecFlag, 0u, OS_OPT_PEND_BLOCKING, (void *)0, &os_err);
-		DB3_TURN_ON();
-
-		OSMutexPend(&timeMutexKey, 0, OS_OPT_PEND_BLOCKING, (void *)0, &os_err);
-		INT8U scarry = 0u;
-		INT8U mincarry = 0u;
-
-		if(timeOfDay.sec >= 59u){
-			scarry = 1u;
-			timeOfDay.sec = 0u;
-		}
-		else{
-			scarry = 0u;
-			timeOfDay.sec += 1;
-		}
-
-		if(scarry == 1u){
-			if(timeOfDay.min >= 59u){
-				mincarry = 1u;
-				timeOfDay.min = 0u;
-			}
-			else{
-				mincarry = 0u;
-				timeOfDay.min += 1u;
+/* TimeSubscribe - Hands *sub the lowest free bit of timeChgFlags for changes of granularity chg.
+ * 				   Changes before the call are not reported to it. */
+INT8U TimeSubscribe(TIME_SUB_T *sub, TIME_CHG_T chg){
+
+	INT8U ok = FALSE;
+	INT32U bit;
+	CPU_SR_ALLOC();
+
+	if(chg < TIME_NUM_CHG){
+		CPU_CRITICAL_ENTER();
+		for(bit = 0u; (bit < TIME_SUB_MAX) && (ok == FALSE); bit++){
+			if((timeSubUsed & ((OS_FLAGS)1u << bit)) == 0u){
+				sub->flag = (OS_FLAGS)1u << bit;
+				sub->chg = chg;
+				sub->seen = timeChgCount[chg];
+				timeSubUsed |= sub->flag;
+				timeSubFlags[chg] |= sub->flag;
+				ok = TRUE;
 			}
+			else{}
 		}
-		else{}
+		CPU_CRITICAL_EXIT();
+	}
+	else{}
+	return ok;
+}
 
-		if(mincarry == 1u){
-			if(timeOfDay.hr >= 23u){
-				timeOfDay.hr = 0u;
-			}
-			else{
-				timeOfDay.hr += 1u;
-			}
+/* TimePend - Pends on the subscriber's bit, consuming it, and copies the current time to *ltime.
+ * 			  Returns the changes of its granularity since it last returned, 0 on an OS error.
+ * 			  A publish between the pend and the count read is counted here but leaves its bit
+ * 			  set, so a wake that finds no new changes pends again instead of returning 0. */
+INT32U TimePend(TIME_SUB_T *sub, TIME_T *ltime, OS_ERR *p_err){
+
+	INT32U count;
+	INT32U changes = 0u;
+
+	do{
+		(void)OSFlagPend(&timeChgFlags, sub->flag, 0u,
+				(OS_OPT)(OS_OPT_PEND_FLAG_SET_ALL | OS_OPT_PEND_FLAG_CONSUME | OS_OPT_PEND_BLOCKING),
+				(CPU_TS *)0, p_err);
+		if(*p_err == OS_ERR_NONE){
+			count = timeChgCount[sub->chg];
+			changes = count - sub->seen;
+			sub->seen = count;
 		}
 		else{}
-		OSMutexPost(&timeMutexKey, OS_OPT_POST_NONE, &os_err);
-
-		(void)OSSemPost(&timeChgFlag, OS_OPT_POST_NONE, &os_err); //post semaphore alerting DispTimeTask that the time has been updated
+	}while((*p_err == OS_ERR_NONE) && (changes == 0u));
+	if(*p_err == OS_ERR_NONE){
+		TimeGet(ltime);
 	}
+	else{}
+	return changes;
 
 }
 
+/* TimeSet - Sets timeOffset so RTC->TSR + timeOffset is *ltime, a change of every granularity. The sequence count is odd while
+ * 			 it is written so a TimeGet() preempted between its TSR and timeOffset reads retries.
+ * 			 The critical section keeps writers from interleaving and is only a few instructions. */
+void TimeSet(TIME_T *ltime){
 
-/* TimePend - Copies curent timeOfDay to *ltime when change is signaled*/
-void TimePend(TIME_T *ltime, OS_ERR *p_err){
-
-	(void)OSSemPend(&timeChgFlag, 0u, OS_OPT_PEND_BLOCKING, (void *)0, p_err);
-	OSMutexPend(&timeMutexKey, 0, OS_OPT_PEND_BLOCKING, (void *)0, p_err);
-	ltime->hr = timeOfDay.hr;
-	ltime->min = timeOfDay.min;
-	ltime->sec = timeOfDay.sec;
-	OSMutexPost(&timeMutexKey, OS_OPT_POST_NONE, p_err);
+	INT32U sod = ((INT32U)ltime->hr*TIME_SEC_PER_HR) + ((INT32U)ltime->min*TIME_SEC_PER_MIN) + ltime->sec;
+	CPU_SR_ALLOC();
 
+	CPU_CRITICAL_ENTER();
+	timeSeq++;
+	timeOffset = timeSecOfDay(sod + TIME_SEC_PER_DAY - timeSecOfDay(RTC->TSR));
+	timeSeq++;
+	CPU_CRITICAL_EXIT();
+	timePublish(TIME_CHG_HR);
 }
 
-/* TimeSet - Copies *ltime to timeOfDay*/
-void TimeSet(TIME_T *ltime){
+/* TimeGet - Copies current time of day to *ltime. Lock free: TSR and timeOffset are read
+ * 			 again only if a TimeSet() ran in between, so a read never waits on a task. */
+void TimeGet(TIME_T *ltime){
 
-	OS_ERR os_err;
+	INT32U seq;
+	INT32U tsr;
+	INT32U offset;
+	INT32U sod;
+	INT32U hr;
+	INT32U min;
+
+	do{
+		seq = timeSeq;
+		tsr = RTC->TSR;
+		offset = timeOffset;
+	}while(((seq & 1u) != 0u) || (seq != timeSeq));
+
+	sod = timeSecOfDay(tsr + offset);
+	hr = (sod*TIME_HR_MULT) >> TIME_HR_SHIFT;
+	sod -= hr*TIME_SEC_PER_HR;
+	min = (sod*TIME_MIN_MULT) >> TIME_MIN_SHIFT;
+	ltime->hr = (INT8U)hr;
+	ltime->min = (INT8U)min;
+	ltime->sec = (INT8U)(sod - (min*TIME_SEC_PER_MIN));
 
-	OSMutexPend(&timeMutexKey, 0, OS_OPT_PEND_BLOCKING, (void *)0, &os_err);
-	timeOfDay.hr = ltime->hr;
-	timeOfDay.min = ltime->min;
-	timeOfDay.sec = ltime->sec;
-	OSMutexPost(&timeMutexKey, OS_OPT_POST_NONE, &os_err);
 }
 
-/* TimeGet - Copies current timeOfDay to *ltime */
-void TimeGet(TIME_T *ltime){
+/* timeSecOfDay - secs modulo one day. timeOffset is kept below a day so TSR + timeOffset
+ * 				  can't wrap for the 136 years TSR takes to overflow. */
+static INT32U timeSecOfDay(INT32U secs){
 
-	OS_ERR os_err;
+	INT32U days = (INT32U)(((INT64U)secs*TIME_DAY_MULT) >> TIME_DAY_SHIFT);
 
-	OSMutexPend(&timeMutexKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
-	ltime->hr = timeOfDay.hr;
-	ltime->min = timeOfDay.min;
-	ltime->sec = timeOfDay.sec;
-	OSMutexPost(&timeMutexKey, OS_OPT_POST_NONE, &os_err);
+	return secs - (days*TIME_SEC_PER_DAY);
 
 }
 
 
-/* RTC_Seconds_IRQHandler simply posts the timeSecFlag so that DispTimeTask will increment*/
-void RTC_Seconds_IRQHandler(void){
+/* timePublish - Counts a change of granularity chg and every finer one and sets the bits of
+ * 				 their subscribers.  From the RTC interrupt or a task. */
+static void timePublish(TIME_CHG_T chg){
 
 	OS_ERR os_err;
-	(void)OSSemPost(&timeSecFlag, OS_OPT_POST_NONE, &os_err); //post semaphore letting timeTask know that a second has elapsed
+	OS_FLAGS flags = 0u;
+	INT32U ind;
+	CPU_SR_ALLOC();
+
+	CPU_CRITICAL_ENTER();
+	for(ind = 0u; ind <= (INT32U)chg; ind++){
+		timeChgCount[ind]++;
+		flags |= timeSubFlags[ind];
+	}
+	CPU_CRITICAL_EXIT();
+	if(flags != 0u){
+		(void)OSFlagPost(&timeChgFlags, flags, OS_OPT_POST_FLAG_SET, &os_err);
+	}
+	else{}
 
 }
 
+/* RTC_Seconds_IRQHandler publishes the new second, and the new minute or hour when it starts one*/
+void RTC_Seconds_IRQHandler(void){
 
+	TIME_T now;
+	TIME_CHG_T chg = TIME_CHG_SEC;
+
+	OSIntEnter();
+	TimeGet(&now);
+	if(now.sec == 0u){
+		chg = (now.min == 0u) ? TIME_CHG_HR : TIME_CHG_MIN;
+	}
+	else{}
+	timePublish(chg);
+	OSIntExit();
+
+}
@@ -14,17 +14,32 @@ typedef struct {
 	INT8U sec;
 }TIME_T;
 
+/*Change granularity a subscriber is woken for.  A minute change is also a second change, etc.*/
+typedef enum{TIME_CHG_SEC, TIME_CHG_MIN, TIME_CHG_HR, TIME_NUM_CHG} TIME_CHG_T;
 
-/*TimePend - Copies current timeOfDay to   *ltime when change is signaled*/
-void TimePend(TIME_T *ltime, OS_ERR *p_err);
+/*Subscriber to time changes, one per pending task.  Filled in by TimeSubscribe()*/
+typedef struct {
+	OS_FLAGS flag; //subscriber's bit of the change flag group
+	TIME_CHG_T chg;
+	INT32U seen; //changes of chg counted when it last returned from TimePend
+}TIME_SUB_T;
+
+/*TimeSubscribe - Makes *sub a subscriber to changes of granularity chg. Returns FALSE if all
+ * 				  TIME_SUB_MAX subscribers are taken or chg is invalid */
+#define TIME_SUB_MAX 32u
+INT8U TimeSubscribe(TIME_SUB_T *sub, TIME_CHG_T chg);
+
+/*TimePend - Waits for a change the subscriber asked for, copies the current time to *ltime and
+ * 			 returns the changes since its last return, more than 1 if the task ran late */
+INT32U TimePend(TIME_SUB_T *sub, TIME_T *ltime, OS_ERR *p_err);
 
-/*TimeGet - Copies current timeOfDay to *ltime */
+/*TimeGet - Copies the current time, RTC->TSR + offset, to *ltime.  Lock free, safe from any task */
 void TimeGet(TIME_T  *ltime);
 
-/*TimeSet - Copies *ltime to timeOfDay */
+/*TimeSet - Sets the offset so the current time is *ltime */
 void TimeSet(TIME_T *ltime);
 
-/*TimeInit - Initializes the RTC, semaphore, task and mutex key, etc. */
+/*TimeInit - Initializes the RTC and change flag group, time 12:00:00 */
 void TimeInit(void);
 
 #endif /* SCTIME_H_ */